@@ -0,0 +1,193 @@
+import os, re, gzip, json, shutil, struct, hashlib
+from SCons.Script import DefaultEnvironment, COMMAND_LINE_TARGETS
+
+# Static assets served from LittleFS (data/WEB). The filesystem image is built
+# from a staging copy of the data directory in which:
+#   - every css/js asset is replaced by its gzip variant, plus a manifest with
+#     the content hash of each file (used by the web server as a strong ETag);
+#   - every html page is compiled into a .tpl file of literal segments and
+#     placeholder IDs, streamed by WebTemplate (include/MicroBox/software/WebTemplate).
+#
+# With WEB_STORE_FLASH=1 the staged WEB tree is also packed into one image for
+# the "webui" partition, which the firmware maps and serves in place
+# (include/MicroBox/software/WebStore):
+#   pio run -t buildweb    -> $BUILD_DIR/webui.bin
+#   pio run -t uploadweb   -> write it at the partition offset
+source_dir    = "data"
+staging_dir   = ".pio/data"
+asset_dirs    = {"WEB/css": "/css/", "WEB/js": "/js/"}
+manifest_file = "WEB/assets.json"
+template_dir  = "WEB/html"
+template_vars = "include/MicroBox/software/WebTemplate"
+
+TPL_LITERAL     = 0x00
+TPL_PLACEHOLDER = 0x01
+
+# Packed image, see WebStore
+web_partition   = "webui"
+web_image       = "webui.bin"
+WEB_STORE_MAGIC = 0x5057424D  # "MBWP"
+WEB_STORE_VERSION  = 1
+WEB_STORE_PATH_MAX = 48
+
+def template_ids(header: str) -> dict:
+    # Placeholder IDs are the order of X(NAME) in WEB_TEMPLATE_VARS
+    with open(header, "r") as f:
+        text = f.read()
+    block = re.search(r"#define WEB_TEMPLATE_VARS((?:.*\\\n)*.*)", text).group(1)
+    return {name: i for i, name in enumerate(re.findall(r"X\((\w+)\)", block))}
+
+def compile_template(src: str, dest: str, ids: dict) -> int:
+    with open(src, "rb") as f:
+        page = f.read()
+
+    out = bytearray()
+    def literal(data: bytes):
+        for at in range(0, len(data), 0xFFFF):
+            part = data[at:at + 0xFFFF]
+            out.extend(struct.pack("<BH", TPL_LITERAL, len(part)) + part)
+
+    at = 0
+    for match in re.finditer(rb"%([A-Z0-9_]+)%", page):
+        name = match.group(1).decode()
+        if name not in ids:
+            raise Exception(f"{src}: unknown placeholder %{name}% (add it to WEB_TEMPLATE_VARS)")
+        literal(page[at:match.start()])
+        out.extend(struct.pack("<BB", TPL_PLACEHOLDER, ids[name]))
+        at = match.end()
+    literal(page[at:])
+
+    with open(dest, "wb") as f:
+        f.write(out)
+    return len(out)
+
+class Assets:
+    def __init__(self, project_dir: str) -> None:
+        self.project_dir = project_dir
+        self.source = os.path.join(project_dir, source_dir)
+        self.staging = os.path.join(project_dir, staging_dir)
+        self.manifest = []
+        self.raw_bytes = 0
+        self.gz_bytes = 0
+
+    def __compress__(self, src: str, dest: str) -> tuple:
+        with open(src, "rb") as f:
+            raw = f.read()
+        # mtime=0: same input -> same bytes -> same ETag between builds
+        data = gzip.compress(raw, compresslevel=9, mtime=0)
+        with open(dest, "wb") as f:
+            f.write(data)
+        self.raw_bytes += len(raw)
+        self.gz_bytes += len(data)
+        return raw, data
+
+    def build(self):
+        if os.path.exists(self.staging):
+            shutil.rmtree(self.staging)
+        shutil.copytree(self.source, self.staging)
+
+        for folder, url in asset_dirs.items():
+            path = os.path.join(self.staging, folder)
+            if not os.path.isdir(path):
+                continue
+            for name in sorted(os.listdir(path)):
+                if name.endswith(".gz"):
+                    continue
+                src = os.path.join(path, name)
+                raw, data = self.__compress__(src, src + ".gz")
+                os.remove(src)
+                self.manifest.append({
+                    "url": url + name,
+                    "path": f"/{folder}/{name}",
+                    "etag": hashlib.sha256(data).hexdigest()[:16],
+                    "size": len(raw),
+                    "gz": len(data)
+                })
+
+        with open(os.path.join(self.staging, manifest_file), "w") as f:
+            json.dump(self.manifest, f, separators=(",", ":"))
+
+        ids = template_ids(os.path.join(self.project_dir, template_vars))
+        path = os.path.join(self.staging, template_dir)
+        pages = [name for name in sorted(os.listdir(path)) if name.endswith(".html")]
+        for name in pages:
+            src = os.path.join(path, name)
+            compile_template(src, src[:-len(".html")] + ".tpl", ids)
+            os.remove(src)
+        print(f"Compiled {len(pages)} templates")
+
+        print(f"Compressed {len(self.manifest)} assets: "
+              f"{self.raw_bytes} -> {self.gz_bytes} bytes")
+
+    def pack(self, dest: str) -> int:
+        # Header, entries sorted by path (binary search on the device), 4-byte aligned data
+        files = []
+        for root, _, names in os.walk(os.path.join(self.staging, "WEB")):
+            for name in names:
+                src = os.path.join(root, name)
+                path = "/" + os.path.relpath(src, self.staging).replace(os.sep, "/")
+                if len(path) >= WEB_STORE_PATH_MAX:
+                    raise Exception(f"{path}: path longer than {WEB_STORE_PATH_MAX - 1} characters")
+                with open(src, "rb") as f:
+                    files.append((path, f.read()))
+        files.sort(key=lambda item: item[0].encode())
+
+        offset = 12 + len(files) * (8 + WEB_STORE_PATH_MAX)
+        entries, data = bytearray(), bytearray()
+        for path, content in files:
+            offset += (-offset) % 4
+            data.extend(bytes((-len(data)) % 4))
+            entries.extend(struct.pack(f"<II{WEB_STORE_PATH_MAX}s", offset, len(content), path.encode()))
+            data.extend(content)
+            offset += len(content)
+        data.extend(bytes((-len(data)) % 4))
+
+        image = struct.pack("<IHHI", WEB_STORE_MAGIC, WEB_STORE_VERSION, len(files),
+            12 + len(entries) + len(data)) + entries + data
+        with open(dest, "wb") as f:
+            f.write(image)
+        print(f"Packed {len(files)} files into {dest}: {len(image)} bytes")
+        return len(image)
+
+def partition(csv: str, name: str) -> tuple:
+    # (offset, size) of a partition of the partition table
+    with open(csv, "r") as f:
+        for line in f:
+            cols = [col.strip() for col in line.split("#")[0].split(",")]
+            if len(cols) >= 5 and cols[0] == name:
+                return int(cols[3], 0), int(cols[4], 0)
+    raise Exception(f"{csv}: no '{name}' partition")
+
+def build_web(target, source, env):
+    assets = Assets(env.subst("$PROJECT_DIR"))
+    assets.build()
+    image = os.path.join(env.subst("$BUILD_DIR"), web_image)
+    size = assets.pack(image)
+
+    table = env.subst("$PARTITIONS_TABLE_CSV")
+    _, capacity = partition(table, web_partition)
+    if size > capacity:
+        raise Exception(f"{web_image}: {size} bytes, the '{web_partition}' partition holds {capacity}")
+
+def upload_web(target, source, env):
+    build_web(target, source, env)
+    offset, _ = partition(env.subst("$PARTITIONS_TABLE_CSV"), web_partition)
+    port = env.subst("$UPLOAD_PORT")
+    command = f'"$PYTHONEXE" "$UPLOADER" --chip esp32 --baud $UPLOAD_SPEED '
+    if port:
+        command += f'--port "{port}" '
+    command += f'write_flash {hex(offset)} "{os.path.join(env.subst("$BUILD_DIR"), web_image)}"'
+    env.Execute(command)
+
+env = DefaultEnvironment()
+
+# Only needed when the filesystem image is built (buildfs / uploadfs)
+if any(target in COMMAND_LINE_TARGETS for target in ("buildfs", "uploadfs", "uploadfsota")):
+    assets = Assets(env.subst("$PROJECT_DIR"))
+    assets.build()
+    env.Replace(PROJECT_DATA_DIR=assets.staging)
+
+env.AddCustomTarget("buildweb", None, build_web,
+    title="Build Web UI Image", description="Pack data/WEB for the webui partition")
+env.AddCustomTarget("uploadweb", None, upload_web,
+    title="Upload Web UI Image", description="Write the web UI image to the webui partition")
@@ -4,14 +4,101 @@ class DataServer {
             this.XHR = new XMLHttpRequest();
             this.ws = null;
             this.updateTimeout = null; // Prevent multiple timers
+            this.pollInterval = 5000;
+            this.state = { data_server: {}, data_relay: {} }; // Last known state, deltas are merged in
+            // Binary telemetry (MessagePack) on request: index?format=msgpack
+            this.msgpack = typeof MsgPack !== "undefined"
+                && new URLSearchParams(window.location.search).get("format") === "msgpack";
             DataServer.instance = this;
         }
         return DataServer.instance;
     }
 
+    // Show the fault instead of the value when the sensor is quarantined
+    static sensorText(data_server, key, unit) {
+        const fault = data_server?.sensor_health?.[key]?.fault;
+        if (fault && fault !== "ok") return `Fault (${fault})`;
+        const value = key in (data_server?.dht ?? {}) ? data_server.dht[key] : data_server?.[key];
+        return `${value}${unit}`;
+    }
+
+    // Merge the members of `src` into `dest` (a delta only carries what changed)
+    static merge(dest, src) {
+        for (let key in src) {
+            if (src[key] !== null && typeof src[key] === "object" && !Array.isArray(src[key])) {
+                if (typeof dest[key] !== "object" || dest[key] === null) dest[key] = {};
+                DataServer.merge(dest[key], src[key]);
+            } else {
+                dest[key] = src[key];
+            }
+        }
+    }
+
+    static render() {
+        const instance = new DataServer();
+        let data_server = instance.state.data_server;
+        let data_relay = instance.state.data_relay;
+
+        const updateElement = (id, value) => {
+            const elem = document.getElementById(id);
+            if (elem && elem.innerHTML !== value) elem.innerHTML = value || "N/A";
+        };
+
+        updateElement("server-temp", DataServer.sensorText(data_server, "temp", "°C"));
+        updateElement("server-hum", DataServer.sensorText(data_server, "hum", "%"));
+        updateElement("server-soillvl", DataServer.sensorText(data_server, "soil_moisture", "%"));
+        updateElement(
+            "server-WateringState",
+            data_server?.watering_state ? "Watering" : "Standby"
+        );
+
+        for (let key in data_relay) {
+            let element = document.getElementById(data_relay[key].id);
+            if (element) {
+                element.checked = data_relay[key].status;
+            }
+        }
+    }
+
+    // Snapshot replaces the state, delta is merged into it
+    static apply(response, full) {
+        const instance = new DataServer();
+        if (full) {
+            instance.state = {
+                data_server: response.data_server ?? {},
+                data_relay: response.data_relay ?? {}
+            };
+        } else {
+            DataServer.merge(instance.state, {
+                data_server: response.data_server ?? {},
+                data_relay: response.data_relay ?? {}
+            });
+        }
+        DataServer.render();
+    }
+
+    // MessagePack (binary) or JSON (text), whichever the server answered with
+    static decode(payload, contentType = "") {
+        if (payload instanceof ArrayBuffer) {
+            if ((contentType ?? "").includes("json")) return JSON.parse(new TextDecoder().decode(payload));
+            return MsgPack.decode(payload);
+        }
+        return JSON.parse(payload);
+    }
+
+    static connected() {
+        const instance = new DataServer();
+        return instance.ws !== null && instance.ws.readyState === WebSocket.OPEN;
+    }
+
+    // Polling fallback, only while the WebSocket is down
     static update(timeout = 5000) {
         const instance = new DataServer();
         let xhr = instance.XHR;
+        instance.pollInterval = timeout;
+
+        clearTimeout(instance.updateTimeout);
+        if (DataServer.connected()) return;
 
         if (xhr.readyState !== 0 && xhr.readyState !== 4) {
             xhr.abort();
@@ -19,32 +106,16 @@ class DataServer {
 
         try {
             xhr.open("GET", "/data-server", true);
+            if (instance.msgpack) {
+                xhr.setRequestHeader("Accept", "application/msgpack");
+                xhr.responseType = "arraybuffer";
+            } else {
+                xhr.responseType = "text";
+            }
 
             xhr.onload = () => {
                 if (xhr.status === 200) {
-                    let response = JSON.parse(xhr.responseText);
-                    let data_server = response.data_server;
-                    let data_relay = response.data_relay;
-
-                    const updateElement = (id, value) => {
-                        const elem = document.getElementById(id);
-                        if (elem && elem.innerHTML !== value) elem.innerHTML = value || "N/A";
-                    };
-
-                    updateElement("server-temp", `${data_server?.dht?.temp}°C`);
-                    updateElement("server-hum", `${data_server?.dht?.hum}%`);
-                    updateElement("server-soillvl", `${data_server?.soil_moisture}%`);
-                    updateElement(
-                        "server-WateringState",
-                        data_server?.watering_state ? "Watering" : "Standby"
-                    );
-
-                    for (let key in data_relay) {
-                        let element = document.getElementById(data_relay[key].id);
-                        if (element) {
-                            element.checked = data_relay[key].status;
-                        }
-                    }
+                    DataServer.apply(DataServer.decode(xhr.response, xhr.getResponseHeader("Content-Type")), true);
                 } else {
                     console.error("Error fetching data:", xhr.statusText);
                 }
@@ -57,11 +128,17 @@ class DataServer {
             console.error("XHR error:", error);
         }
 
-        // Cegah multiple timeout dengan clearTimeout
-        clearTimeout(instance.updateTimeout);
         instance.updateTimeout = setTimeout(() => DataServer.update(timeout), timeout);
     }
 
+    // Send a command over the WebSocket; false when it is down (use HTTP instead)
+    static command(message) {
+        const instance = new DataServer();
+        if (!DataServer.connected()) return false;
+        instance.ws.send(JSON.stringify(message));
+        return true;
+    }
+
     static listen() {
         const instance = new DataServer();
 
@@ -71,38 +148,35 @@ class DataServer {
             return;
         }
 
-        instance.ws = new WebSocket(`ws://${window.location.host}/ws`);
+        if (instance.msgpack) {
+            instance.ws = new WebSocket(`ws://${window.location.host}/ws`, "msgpack");
+            instance.ws.binaryType = "arraybuffer";
+        } else {
+            instance.ws = new WebSocket(`ws://${window.location.host}/ws`);
+        }
 
         instance.ws.onopen = () => {
             console.log("WebSocket Connected!");
-            instance.ws.send(JSON.stringify({ event: "data_server" }));
+            // Pushed state replaces polling
+            clearTimeout(instance.updateTimeout);
+            instance.ws.send(JSON.stringify({ event: "subscribe" }));
         };
 
         instance.ws.onmessage = (event) => {
             try {
-                const data = JSON.parse(event.data);
+                const data = DataServer.decode(event.data);
                 if (data.event === "data_server") {
-                    let data_server = data.data_server;
-
-                    const updateElement = (id, value) => {
-                        const elem = document.getElementById(id);
-                        if (elem && elem.innerHTML !== value) elem.innerHTML = value || "N/A";
-                    };
-
-                    updateElement("server-temp", `${data_server?.dht?.temp}°C`);
-                    updateElement("server-hum", `${data_server?.dht?.hum}%`);
-                    updateElement("server-soillvl", `${data_server?.soil_moisture}%`);
-                    updateElement(
-                        "server-WateringState",
-                        data_server?.watering_state ? "Watering" : "Standby"
-                    );
-
-                    let data_relay = data.data_relay;
-                    for (let key in data_relay) {
-                        let element = document.getElementById(data_relay[key].id);
-                        if (element) {
-                            element.checked = data_relay[key].status;
-                        }
+                    DataServer.apply(data, true);
+                } else if (data.event === "delta") {
+                    DataServer.apply(data, false);
+                } else if (data.event === "ack") {
+                    if (data.cmd === "subscribe") {
+                        // Server is full: keep polling over HTTP
+                        instance.ws.onclose = null;
+                        instance.ws.close();
+                        DataServer.update(instance.pollInterval);
+                    } else if (typeof toggleCheck !== "undefined") {
+                        toggleCheck.onAck(data);
                     }
                 }
             } catch (error) {
@@ -112,6 +186,7 @@ class DataServer {
 
         instance.ws.onclose = () => {
             console.warn("WebSocket closed, reconnecting...");
+            DataServer.update(instance.pollInterval);
             setTimeout(() => DataServer.listen(), 5000);
         };
 
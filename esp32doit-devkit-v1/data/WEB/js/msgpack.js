@@ -0,0 +1,71 @@
+// MessagePack decoder for the telemetry sent with `Accept: application/msgpack`
+// or the "msgpack" WebSocket subprotocol (the types ArduinoJson writes).
+class MsgPack {
+    static text = new TextDecoder();
+
+    static decode(buffer) {
+        // A typed array may be a window into a larger buffer: keep its offset and length
+        const buf = buffer instanceof ArrayBuffer ? new Uint8Array(buffer) : buffer;
+        const view = new DataView(buf.buffer, buf.byteOffset, buf.byteLength);
+        const bytes = new Uint8Array(buf.buffer, buf.byteOffset, buf.byteLength);
+        let at = 0;
+
+        const str = (len) => {
+            const s = MsgPack.text.decode(bytes.subarray(at, at + len));
+            at += len;
+            return s;
+        };
+        const array = (len) => {
+            const a = new Array(len);
+            for (let i = 0; i < len; i++) a[i] = value();
+            return a;
+        };
+        const map = (len) => {
+            const m = {};
+            for (let i = 0; i < len; i++) {
+                const key = value();
+                m[key] = value();
+            }
+            return m;
+        };
+        const next = (size, read) => {
+            const v = read(at);
+            at += size;
+            return v;
+        };
+
+        const value = () => {
+            const b = bytes[at++];
+            if (b <= 0x7f) return b;                       // positive fixint
+            if (b >= 0xe0) return b - 0x100;               // negative fixint
+            if ((b & 0xf0) === 0x80) return map(b & 0x0f); // fixmap
+            if ((b & 0xf0) === 0x90) return array(b & 0x0f);
+            if ((b & 0xe0) === 0xa0) return str(b & 0x1f);
+            switch (b) {
+                case 0xc0: return null;
+                case 0xc2: return false;
+                case 0xc3: return true;
+                case 0xca: return next(4, (i) => view.getFloat32(i));
+                case 0xcb: return next(8, (i) => view.getFloat64(i));
+                case 0xcc: return next(1, (i) => view.getUint8(i));
+                case 0xcd: return next(2, (i) => view.getUint16(i));
+                case 0xce: return next(4, (i) => view.getUint32(i));
+                case 0xcf: return next(8, (i) => Number(view.getBigUint64(i)));
+                case 0xd0: return next(1, (i) => view.getInt8(i));
+                case 0xd1: return next(2, (i) => view.getInt16(i));
+                case 0xd2: return next(4, (i) => view.getInt32(i));
+                case 0xd3: return next(8, (i) => Number(view.getBigInt64(i)));
+                case 0xd9: return str(next(1, (i) => view.getUint8(i)));
+                case 0xda: return str(next(2, (i) => view.getUint16(i)));
+                case 0xdb: return str(next(4, (i) => view.getUint32(i)));
+                case 0xdc: return array(next(2, (i) => view.getUint16(i)));
+                case 0xdd: return array(next(4, (i) => view.getUint32(i)));
+                case 0xde: return map(next(2, (i) => view.getUint16(i)));
+                case 0xdf: return map(next(4, (i) => view.getUint32(i)));
+                default: throw new Error(`MessagePack: unsupported type 0x${b.toString(16)}`);
+            }
+        };
+
+        return value();
+    }
+}
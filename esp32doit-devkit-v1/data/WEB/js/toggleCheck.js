@@ -10,13 +10,7 @@ class toggleCheck {
     static handleError(xhr) {
         xhr.onload = () => {
             if (xhr.status === 400) {
-                Swal.fire({
-                    title: "Information",
-                    text: "Auto Watering is Enabled",
-                    icon: "info",
-                    confirmButtonColor: "#00b30c",
-                    confirmButtonText: "OK"
-                });
+                toggleCheck.refused();
             } else if (xhr.status !== 200) {
                 console.error("Request Error:", xhr.statusText);
             }
@@ -25,7 +19,26 @@ class toggleCheck {
         xhr.onerror = () => console.error("XHR request failed.");
     }
 
-    static autoWateringCheckbox(element) {
+    static refused() {
+        Swal.fire({
+            title: "Information",
+            text: "Auto Watering is Enabled",
+            icon: "info",
+            confirmButtonColor: "#00b30c",
+            confirmButtonText: "OK"
+        });
+    }
+
+    // Reply to a command sent over the WebSocket (see DataServer.command)
+    static onAck(ack) {
+        if (ack.status === 400) {
+            toggleCheck.refused();
+        } else if (ack.status !== 200) {
+            console.error("Command Error:", ack.cmd, ack.msg);
+        }
+    }
+
+    static send(uri) {
         let instance = new toggleCheck();
         let xhr = instance._xhr;
 
@@ -33,12 +46,16 @@ class toggleCheck {
             xhr.abort();
         }
 
-        let state = element.checked ? 1 : 0;
-        let uri = `/auto-watering?state=${state}`;
-
         xhr.open("GET", uri, true);
         toggleCheck.handleError(xhr);
         xhr.send();
+    }
+
+    static autoWateringCheckbox(element) {
+        let state = element.checked ? 1 : 0;
+        if (!DataServer.command({ event: "auto_watering", state: state })) {
+            toggleCheck.send(`/auto-watering?state=${state}`);
+        }
 
         Swal.fire({
             title: `Auto Watering: ${state ? "Enabled" : "Disabled"}`,
@@ -51,18 +68,9 @@ class toggleCheck {
     }
 
     static toggleCheckbox(element) {
-        let instance = new toggleCheck();
-        let xhr = instance._xhr;
-
-        if (xhr.readyState !== 0 && xhr.readyState !== 4) {
-            xhr.abort();
-        }
-
         let state = element.checked ? 1 : 0;
-        let uri = `/check?pinout=${element.id}&state=${state}`;
-
-        xhr.open("GET", uri, true);
-        toggleCheck.handleError(xhr);
-        xhr.send();
+        if (!DataServer.command({ event: "toggle_check", pinout: Number(element.id), state: state })) {
+            toggleCheck.send(`/check?pinout=${element.id}&state=${state}`);
+        }
     }
 }
@@ -33,4 +33,5 @@ class ThisRTOS {
         void vTask1(void *pvParameter);
         void vTask2(void *pvParameter);
         void vTask3(void *pvParameter);
+        void vTask4(void *pvParameter);
 };
\ No newline at end of file
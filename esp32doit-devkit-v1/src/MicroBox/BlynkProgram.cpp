@@ -93,25 +93,30 @@ BLYNK_WRITE(V3) {
  * @param V2 Virtual pin for auto-watering configuration.
  */
 BLYNK_WRITE(V2) {
-    lfsprog.changeConfigState(
-        AUTOWATERING,
-        param.asInt() == 1 ? true : false
-    );
+    bool state = param.asInt() == 1 ? true : false;
+    lfsprog.changeConfigState(AUTOWATERING, state);
+    wateringSys.events.notify(WATERING_EV_AUTO, state);
 }
 
 /**
- * @brief Sends data sensor Soil Moisture and DHT to Blynk.
- * @details Periodically transmits the soil moisture level
- *          and DHT temperature to a virtual pin.
- *          - V0 : Virtual pin for Soil Moisture sensor.
- *          - V1 : Virtual pin for DHT Sensor.
+ * @brief Sends every registered sensor to Blynk.
+ * @details Periodically transmits each sensor channel that declares a
+ *          virtual pin (see `MicroBox/hardware/sensor/Sensors`), and with
+ *          flow meters fitted the flow rate (V6), the water used (V7) and
+ *          the flow fault (V8: 0 = OK, 1 = dry run, 2 = leak).
  */
 unsigned long _LastMillisSendData = 0;
 void sendDataSensor(void) {
     if ((unsigned long) (millis() - _LastMillisSendData) >= 100) {
         _LastMillisSendData = millis();
-        Blynk.virtualWrite(V1, dhtprog.temperature);
-        Blynk.virtualWrite(V0, soilmoisture.value);
+        sensors.publish([](int vpin, auto value) {
+            Blynk.virtualWrite(vpin, value);
+        });
+#if FLOW_METER_ENABLE
+        Blynk.virtualWrite(V6, flowmeter.totalLpm());
+        Blynk.virtualWrite(V7, flowmeter.totalLitres());
+        Blynk.virtualWrite(V8, (int) (flowmeter.leak() ? FLOW_LEAK : flowmeter.dryRun() ? FLOW_DRY_RUN : FLOW_OK));
+#endif
     }
 }
 
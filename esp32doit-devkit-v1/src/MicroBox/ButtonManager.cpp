@@ -55,6 +55,7 @@ void ButtonManagerClass::toggleAutoWatering() {
         if (!currentState) {
             this->autoWateringState = !this->autoWateringState;
             lfsprog.changeConfigState(AUTOWATERING, this->autoWateringState);
+            wateringSys.events.notify(WATERING_EV_AUTO, this->autoWateringState);
         }
     }
     this->lastAutoWatering = currentState;
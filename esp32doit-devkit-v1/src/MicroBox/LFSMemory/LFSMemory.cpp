@@ -148,6 +148,147 @@ void LFSMemory::initializeOrUpdateState(const String &cfile, std::function<void
     this->writeconfig(cfile, __newConfig__);
 }
 
+/**
+ * @brief Initializes or updates probe calibration profiles in the specified file.
+ * @details An empty object is written if the file is missing or corrupted;
+ *          probes without a profile use the default dry/wet pair.
+ * 
+ * @param cfile Configuration file name containing calibration profiles.
+ * @param updateFunc Lambda function to update configuration data in the file.
+ */
+void LFSMemory::initializeOrUpdateCalibration(const String &cfile, std::function<void (DynamicJsonDocument&)> updateFunc)
+{
+    DynamicJsonDocument doc(4096);
+    String __readConfig__ = this->readconfig(cfile), __newConfig__ = "";
+
+    if (__readConfig__ == "null" || !lfsIsExists(cfile)) {
+        Serial.println(F("Calibration config file missing, creating new one."));
+        doc.to<JsonObject>();
+    }
+    else {
+        DeserializationError error = deserializeJson(doc, __readConfig__);
+        if (error) {
+            this->handleError_deserializeJson(
+                "initializeOrUpdateCalibration", // Function name for error tracking
+                error.c_str() // Error message
+            );
+            return;
+        }
+    }
+
+    // Apply the changes using the provided lambda function
+    updateFunc(doc);
+
+    // Serialize updated data and write it back to the file
+    serializeJson(doc, __newConfig__);
+    this->writeconfig(cfile, __newConfig__);
+}
+
+/**
+ * @brief Initializes or updates the watering controller configuration in the specified file.
+ * @details The default mode and zone settings are written if the file is missing or corrupted.
+ * 
+ * @param cfile Configuration file name containing the watering configuration.
+ * @param updateFunc Lambda function to update configuration data in the file.
+ */
+void LFSMemory::initializeOrUpdateWatering(const String &cfile, std::function<void (DynamicJsonDocument&)> updateFunc)
+{
+    DynamicJsonDocument doc(1536);
+    String __readConfig__ = this->readconfig(cfile), __newConfig__ = "";
+
+    if (__readConfig__ == "null" || !lfsIsExists(cfile)) {
+        Serial.println(F("Watering config file missing, creating new one."));
+        this->wateringToJson(WateringConfig(), doc.to<JsonObject>());
+    }
+    else {
+        DeserializationError error = deserializeJson(doc, __readConfig__);
+        if (error) {
+            this->handleError_deserializeJson(
+                "initializeOrUpdateWatering", // Function name for error tracking
+                error.c_str() // Error message
+            );
+            return;
+        }
+    }
+
+    // Apply the changes using the provided lambda function
+    updateFunc(doc);
+
+    // Serialize updated data and write it back to the file
+    serializeJson(doc, __newConfig__);
+    this->writeconfig(cfile, __newConfig__);
+}
+
+/**
+ * @brief Initializes or updates the watering schedules in the specified file.
+ * @details An empty schedule list is written if the file is missing or corrupted.
+ * 
+ * @param cfile Configuration file name containing the schedules.
+ * @param updateFunc Lambda function to update configuration data in the file.
+ */
+void LFSMemory::initializeOrUpdateSchedules(const String &cfile, std::function<void (DynamicJsonDocument&)> updateFunc)
+{
+    DynamicJsonDocument doc(1536);
+    String __readConfig__ = this->readconfig(cfile), __newConfig__ = "";
+
+    if (__readConfig__ == "null" || !lfsIsExists(cfile)) {
+        Serial.println(F("Schedule config file missing, creating new one."));
+        doc.createNestedArray("schedules");
+    }
+    else {
+        DeserializationError error = deserializeJson(doc, __readConfig__);
+        if (error) {
+            this->handleError_deserializeJson(
+                "initializeOrUpdateSchedules", // Function name for error tracking
+                error.c_str() // Error message
+            );
+            return;
+        }
+    }
+
+    // Apply the changes using the provided lambda function
+    updateFunc(doc);
+
+    // Serialize updated data and write it back to the file
+    serializeJson(doc, __newConfig__);
+    this->writeconfig(cfile, __newConfig__);
+}
+
+/**
+ * @brief Initializes or updates the watering rules in the specified file.
+ * @details An empty rule list is written if the file is missing or corrupted.
+ * 
+ * @param cfile Configuration file name containing the rules.
+ * @param updateFunc Lambda function to update configuration data in the file.
+ */
+void LFSMemory::initializeOrUpdateRules(const String &cfile, std::function<void (DynamicJsonDocument&)> updateFunc)
+{
+    DynamicJsonDocument doc(2048);
+    String __readConfig__ = this->readconfig(cfile), __newConfig__ = "";
+
+    if (__readConfig__ == "null" || !lfsIsExists(cfile)) {
+        Serial.println(F("Rule config file missing, creating new one."));
+        doc.createNestedArray("rules");
+    }
+    else {
+        DeserializationError error = deserializeJson(doc, __readConfig__);
+        if (error) {
+            this->handleError_deserializeJson(
+                "initializeOrUpdateRules", // Function name for error tracking
+                error.c_str() // Error message
+            );
+            return;
+        }
+    }
+
+    // Apply the changes using the provided lambda function
+    updateFunc(doc);
+
+    // Serialize updated data and write it back to the file
+    serializeJson(doc, __newConfig__);
+    this->writeconfig(cfile, __newConfig__);
+}
+
 /**
  * @brief Initailizes WiFi configuration with values from the configuration file.
  */
@@ -189,6 +330,54 @@ void LFSMemory::initializeState(void) {
     );
 }
 
+/**
+ * @brief Initializes the probe calibration file.
+ */
+void LFSMemory::initializeCalibration(void) {
+    this->initializeOrUpdateCalibration(
+        this->file_config_calibration,
+        [&](DynamicJsonDocument &data) {
+            // Placeholder for calibration updates
+        }
+    );
+}
+
+/**
+ * @brief Initializes the watering controller configuration file.
+ */
+void LFSMemory::initializeWatering(void) {
+    this->initializeOrUpdateWatering(
+        this->file_config_watering,
+        [&](DynamicJsonDocument &data) {
+            // Placeholder for watering configuration updates
+        }
+    );
+}
+
+/**
+ * @brief Initializes the watering schedule file.
+ */
+void LFSMemory::initializeSchedules(void) {
+    this->initializeOrUpdateSchedules(
+        this->file_config_schedules,
+        [&](DynamicJsonDocument &data) {
+            // Placeholder for schedule updates
+        }
+    );
+}
+
+/**
+ * @brief Initializes the watering rule file.
+ */
+void LFSMemory::initializeRules(void) {
+    this->initializeOrUpdateRules(
+        this->file_config_rules,
+        [&](DynamicJsonDocument &data) {
+            // Placeholder for rule updates
+        }
+    );
+}
+
 /**
  * @brief Reinitializes WiFi configuration with default values.
  */
@@ -258,6 +447,10 @@ void LFSMemory::setupLFS(void) {
     this->initializeWiFiConfig();
     this->initializeVarRelay();
     this->initializeState();
+    this->initializeCalibration();
+    this->initializeWatering();
+    this->initializeSchedules();
+    this->initializeRules();
     this->listFiles();
 
     Serial.println(F("\nConfigurate WiFi client :"));
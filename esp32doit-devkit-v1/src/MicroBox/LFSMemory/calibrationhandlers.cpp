@@ -0,0 +1,117 @@
+/**
+ *  @file calibrationhandlers.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "MicroBox/software/LFSMemory"
+
+/**
+ * readCalibration
+ * @param probe
+ * @param lut SoilCalibrationLUT& -> compiled lookup table
+ */
+void LFSMemory::readCalibration(uint8_t probe, SoilCalibrationLUT &lut) {
+    SoilCalPoint points[SOIL_CAL_MAX_POINTS];
+    uint8_t count = 0;
+
+    // Read-only: the file is created by initializeCalibration() during setupLFS()
+    DynamicJsonDocument data(4096);
+    String __readConfig__ = this->readconfig(this->file_config_calibration);
+    if (__readConfig__ != "null") {
+        DeserializationError error = deserializeJson(data, __readConfig__);
+        if (error) {
+            this->handleError_deserializeJson("readCalibration", error.c_str());
+        }
+        else {
+            JsonArray profile = data["probe" + String(probe)];
+            for (JsonObject item : profile) {
+                if (count >= SOIL_CAL_MAX_POINTS) break;
+                points[count].raw     = item["raw"];
+                points[count].percent = item["pct"];
+                count++;
+            }
+        }
+    }
+
+    if (!lut.compile(points, count)) {
+        if (count > 0)
+            Serial.printf("Calibration probe%u invalid, using defaults\n", probe);
+        lut.compileDefault();
+    }
+}
+
+/**
+ * changeCalibrationPoint
+ * @param probe
+ * @param point
+ * @param stats
+ * @return bool
+ */
+bool LFSMemory::changeCalibrationPoint(uint8_t probe, const SoilCalPoint &point, const SoilCalStats &stats)
+{
+    bool result = true;
+
+    this->initializeOrUpdateCalibration(
+        this->file_config_calibration,
+        [&](DynamicJsonDocument &data) {
+            String key = "probe" + String(probe);
+            JsonArray profile = data[key];
+            if (profile.isNull())
+                profile = data.createNestedArray(key);
+
+            // Replace the point captured for the same moisture level
+            JsonObject item;
+            for (JsonObject it : profile) {
+                if (fabs(it["pct"].as<float>() - point.percent) < 0.01) {
+                    item = it;
+                    break;
+                }
+            }
+
+            if (item.isNull()) {
+                if (profile.size() >= SOIL_CAL_MAX_POINTS) {
+                    result = false;
+                    return;
+                }
+                item = profile.createNestedObject();
+            }
+
+            item["raw"] = point.raw;
+            item["pct"] = point.percent;
+            item["min"] = stats.min;
+            item["max"] = stats.max;
+            item["sd"]  = stats.stddev;
+            item["n"]   = stats.samples;
+        }
+    );
+
+    return result;
+}
+
+/**
+ * resetCalibration
+ * @param probe
+ */
+void LFSMemory::resetCalibration(uint8_t probe) {
+    this->initializeOrUpdateCalibration(
+        this->file_config_calibration,
+        [&](DynamicJsonDocument &data) {
+            data.remove("probe" + String(probe));
+        }
+    );
+}
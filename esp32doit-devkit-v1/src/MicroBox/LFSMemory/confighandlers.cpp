@@ -65,6 +65,21 @@ void LFSMemory::changeConfigState(String stateConfig, bool value) {
     );
 }
 
+/**
+ *  changeConfigStates
+ *  @param values (stateConfig, value) pairs
+ */
+void LFSMemory::changeConfigStates(const std::vector<std::pair<String, bool>> &values) {
+    if (values.empty()) return;
+    this->initializeOrUpdateState(
+        this->file_config_state,
+        [&](StaticJsonDocument<200> &data) {
+            for (const auto &item : values)
+                data[item.first] = item.second;
+        }
+    );
+}
+
 /**
  *  readConfigState
  *  @param stateConfig
@@ -68,6 +68,21 @@ void LFSMemory::changeStateRelay(String varName, bool status) {
     );
 }
 
+/**
+ * changeStateRelays
+ * @param states (pin, status) pairs
+ */
+void LFSMemory::changeStateRelays(const std::vector<std::pair<uint8_t, bool>> &states) {
+    if (states.empty()) return;
+    this->initializeOrUpdateVarRelay(
+        this->file_config_relay,
+        [&](DynamicJsonDocument &data) {
+            for (const auto &item : states)
+                data[String(VAR_SWITCH) + String(item.first)]["status"] = item.second;
+        }
+    );
+}
+
 /**
  * parseVarRelay
  * @param varName
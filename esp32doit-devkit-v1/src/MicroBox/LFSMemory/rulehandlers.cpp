@@ -0,0 +1,114 @@
+/**
+ *  @file rulehandlers.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "MicroBox/software/LFSMemory"
+
+/**
+ * readRules
+ * @param engine RuleEngine& -> compiled rules
+ */
+void LFSMemory::readRules(RuleEngine &engine) {
+    // Read-only: the file is created by initializeRules() during setupLFS()
+    DynamicJsonDocument data(2048);
+    engine.clear();
+
+    String __readConfig__ = this->readconfig(this->file_config_rules);
+    if (__readConfig__ == "null") return;
+
+    DeserializationError error = deserializeJson(data, __readConfig__);
+    if (error) {
+        this->handleError_deserializeJson("readRules", error.c_str());
+        return;
+    }
+
+    for (JsonObject entry : data["rules"].as<JsonArray>()) {
+        const char *text = entry["rule"] | "";
+        // The web server refuses longer rules; a longer one was edited into the file
+        if (strnlen(text, RULE_TEXT_LEN) >= RULE_TEXT_LEN) {
+            Serial.printf("Rule longer than %u characters skipped\n", RULE_TEXT_LEN - 1);
+            continue;
+        }
+        if (engine.add(text, WATERING_ZONES, entry["enabled"] | true) < 0) {
+            Serial.print(F("Invalid rule skipped: "));
+            Serial.println(text);
+        }
+    }
+}
+
+/**
+ * addRule
+ * @param text
+ */
+void LFSMemory::addRule(const String &text) {
+    this->initializeOrUpdateRules(
+        this->file_config_rules,
+        [&](DynamicJsonDocument &data) {
+            JsonObject entry = data["rules"].as<JsonArray>().createNestedObject();
+            entry["rule"]    = text;
+            entry["enabled"] = true;
+        }
+    );
+}
+
+/**
+ * removeRule
+ * @param index
+ */
+void LFSMemory::removeRule(uint8_t index) {
+    this->initializeOrUpdateRules(
+        this->file_config_rules,
+        [&](DynamicJsonDocument &data) {
+            data["rules"].as<JsonArray>().remove(index);
+        }
+    );
+}
+
+/**
+ * enableRule
+ * @param index
+ * @param enabled
+ */
+void LFSMemory::enableRule(uint8_t index, bool enabled) {
+    this->initializeOrUpdateRules(
+        this->file_config_rules,
+        [&](DynamicJsonDocument &data) {
+            JsonObject entry = data["rules"][index];
+            if (!entry.isNull()) entry["enabled"] = enabled;
+        }
+    );
+}
+
+/**
+ * rulesToJson
+ * @param obj JsonObject -> {"rules": [{"rule": ..., "enabled": ...}]}
+ */
+void LFSMemory::rulesToJson(JsonObject obj) {
+    DynamicJsonDocument data(2048);
+    JsonArray list = obj.createNestedArray("rules");
+
+    String __readConfig__ = this->readconfig(this->file_config_rules);
+    if (__readConfig__ == "null" || deserializeJson(data, __readConfig__)) return;
+
+    for (JsonObject entry : data["rules"].as<JsonArray>()) {
+        JsonObject item = list.createNestedObject();
+        item["rule"]    = entry["rule"] | "";
+        item["enabled"] = entry["enabled"] | true;
+    }
+}
@@ -0,0 +1,87 @@
+/**
+ *  @file schedulehandlers.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "MicroBox/software/LFSMemory"
+
+/**
+ * schedulesToJson
+ * @param engine
+ * @param obj JsonObject -> {"schedules": [{"expr": ..., "duration": ..., ...}]}
+ */
+void LFSMemory::schedulesToJson(const ScheduleEngine &engine, JsonObject obj) {
+    JsonArray list = obj.createNestedArray("schedules");
+    for (uint8_t i = 0; i < engine.count; i++) {
+        const WateringSchedule &item = engine.items[i];
+        JsonObject entry = list.createNestedObject();
+        entry["expr"]     = (const char*) item.expr;
+        entry["duration"] = item.duration;
+        entry["zones"]    = item.zones;
+        entry["catchup"]  = ScheduleEngine::catchupText(item.catchup);
+        entry["enabled"]  = item.enabled;
+        entry["last"]     = item.last;
+    }
+}
+
+/**
+ * readSchedules
+ * @param engine ScheduleEngine& -> stored schedules
+ */
+void LFSMemory::readSchedules(ScheduleEngine &engine) {
+    // Read-only: the file is created by initializeSchedules() during setupLFS()
+    DynamicJsonDocument data(1536);
+    engine.clear();
+
+    String __readConfig__ = this->readconfig(this->file_config_schedules);
+    if (__readConfig__ == "null") return;
+
+    DeserializationError error = deserializeJson(data, __readConfig__);
+    if (error) {
+        this->handleError_deserializeJson("readSchedules", error.c_str());
+        return;
+    }
+
+    for (JsonObject entry : data["schedules"].as<JsonArray>()) {
+        WateringSchedule item;
+        strlcpy(item.expr, entry["expr"] | "", sizeof(item.expr));
+        item.duration = entry["duration"] | item.duration;
+        item.zones    = (entry["zones"] | item.zones) & WATERING_ZONES_MASK;
+        item.catchup  = ScheduleEngine::catchupFromText(entry["catchup"] | "skip");
+        item.enabled  = entry["enabled"]  | item.enabled;
+        item.last     = entry["last"]     | item.last;
+
+        if (engine.add(item) < 0) {
+            Serial.print(F("Invalid schedule skipped: "));
+            Serial.println(item.expr);
+        }
+    }
+}
+
+/**
+ * changeSchedules
+ * @param engine
+ */
+void LFSMemory::changeSchedules(const ScheduleEngine &engine) {
+    this->initializeOrUpdateSchedules(
+        this->file_config_schedules,
+        [&](DynamicJsonDocument &data) {
+            this->schedulesToJson(engine, data.to<JsonObject>());
+        }
+    );
+}
@@ -0,0 +1,131 @@
+/**
+ *  @file wateringhandlers.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "MicroBox/software/LFSMemory"
+
+/**
+ * wateringToJson
+ * @param cfg
+ * @param obj JsonObject -> {"mode": ..., "zones": [...]}
+ */
+void LFSMemory::wateringToJson(const WateringConfig &cfg, JsonObject obj) {
+    obj["mode"]   = wateringModeText(cfg.mode);
+    obj["low"]    = cfg.low;
+    obj["high"]   = cfg.high;
+    obj["pumps"]  = cfg.pumps;
+    obj["policy"] = cfg.policy == SCHED_PRIORITY ? "priority" : "fair";
+    obj["forecast_hours"] = cfg.forecastHours;
+
+    JsonObject rain = obj.createNestedObject("rain");
+    rain["on"]             = cfg.rain.onLevel;
+    rain["off"]            = cfg.rain.offLevel;
+    rain["confirm_ms"]     = cfg.rain.confirmMs;
+    rain["dryout_min"]     = cfg.rain.dryOutMin;
+    rain["dryout_factor"]  = cfg.rain.dryOutFactor;
+    rain["dryout_max_min"] = cfg.rain.dryOutMaxMin;
+    rain["skip_min"]       = cfg.rain.skipMin;
+
+    JsonArray zones = obj.createNestedArray("zones");
+    for (const auto &zone : cfg.zones) {
+        JsonObject item = zones.createNestedObject();
+        item["enabled"]      = zone.enabled;
+        item["probe"]        = zone.probe;
+        item["start"]        = zone.start;
+        item["target"]       = zone.target;
+        item["limit"]        = zone.limit;
+        item["pulse_ms"]     = zone.pulseMs;
+        item["pulse_min_ms"] = zone.pulseMinMs;
+        item["pulse_max_ms"] = zone.pulseMaxMs;
+        item["soak_ms"]      = zone.soakMs;
+        item["max_pulses"]   = zone.maxPulses;
+        item["priority"]     = zone.priority;
+    }
+}
+
+/**
+ * readWateringConfig
+ * @param cfg WateringConfig& -> mode and zone settings
+ */
+void LFSMemory::readWateringConfig(WateringConfig &cfg) {
+    // Read-only: the file is created by initializeWatering() during setupLFS()
+    DynamicJsonDocument data(1536);
+    String __readConfig__ = this->readconfig(this->file_config_watering);
+    if (__readConfig__ == "null") return;
+
+    DeserializationError error = deserializeJson(data, __readConfig__);
+    if (error) {
+        this->handleError_deserializeJson("readWateringConfig", error.c_str());
+        return;
+    }
+
+    int mode = wateringModeFromText(data["mode"] | "threshold");
+    cfg.mode = mode < 0 ? WATERING_MODE_THRESHOLD : mode;
+    cfg.low  = data["low"]  | cfg.low;
+    cfg.high = data["high"] | cfg.high;
+    if (!(cfg.low < cfg.high && cfg.high <= 100)) {
+        cfg.low  = WATERING_LVL_MIN;
+        cfg.high = WATERING_LVL_MAX;
+    }
+    cfg.pumps = constrain(data["pumps"] | cfg.pumps, 1, (int) WATERING_ZONES);
+    cfg.policy = strcmp(data["policy"] | "fair", "priority") == 0
+        ? SCHED_PRIORITY : SCHED_FAIR;
+    cfg.forecastHours = (data["forecast_hours"] | cfg.forecastHours) & FORECAST_HOURS_ALL;
+
+    JsonObject rain = data["rain"];
+    cfg.rain.onLevel      = rain["on"]             | cfg.rain.onLevel;
+    cfg.rain.offLevel     = rain["off"]            | cfg.rain.offLevel;
+    cfg.rain.confirmMs    = rain["confirm_ms"]     | cfg.rain.confirmMs;
+    cfg.rain.dryOutMin    = rain["dryout_min"]     | cfg.rain.dryOutMin;
+    cfg.rain.dryOutFactor = rain["dryout_factor"]  | cfg.rain.dryOutFactor;
+    cfg.rain.dryOutMaxMin = rain["dryout_max_min"] | cfg.rain.dryOutMaxMin;
+    cfg.rain.skipMin      = rain["skip_min"]       | cfg.rain.skipMin;
+    if (cfg.rain.offLevel >= cfg.rain.onLevel) cfg.rain = RainConfig();
+
+    uint8_t i = 0;
+    for (JsonObject item : data["zones"].as<JsonArray>()) {
+        if (i >= WATERING_ZONES) break;
+        WateringZoneConfig &zone = cfg.zones[i++];
+        zone.enabled    = item["enabled"]      | zone.enabled;
+        zone.probe      = item["probe"]        | zone.probe;
+        zone.start      = item["start"]        | zone.start;
+        zone.target     = item["target"]       | zone.target;
+        zone.limit      = item["limit"]        | zone.limit;
+        zone.pulseMs    = item["pulse_ms"]     | zone.pulseMs;
+        zone.pulseMinMs = item["pulse_min_ms"] | zone.pulseMinMs;
+        zone.pulseMaxMs = item["pulse_max_ms"] | zone.pulseMaxMs;
+        zone.soakMs     = item["soak_ms"]      | zone.soakMs;
+        zone.maxPulses  = item["max_pulses"]   | zone.maxPulses;
+        zone.priority   = item["priority"]     | zone.priority;
+        if (zone.probe >= SOIL_PROBES) zone.probe = 0;
+    }
+}
+
+/**
+ * changeWateringConfig
+ * @param cfg
+ */
+void LFSMemory::changeWateringConfig(const WateringConfig &cfg) {
+    this->initializeOrUpdateWatering(
+        this->file_config_watering,
+        [&](DynamicJsonDocument &data) {
+            this->wateringToJson(cfg, data.to<JsonObject>());
+        }
+    );
+}
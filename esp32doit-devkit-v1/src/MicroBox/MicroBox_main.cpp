@@ -34,6 +34,12 @@
 #include "MicroBox/hardware/LEDBoard.h"
 #include "MicroBox/hardware/sensor/DHTProgram"
 #include "MicroBox/hardware/sensor/SoilMoisture"
+#include "MicroBox/hardware/sensor/RainCheck"
+#include "MicroBox/hardware/sensor/Sensors"
+#include "MicroBox/hardware/sensor/SoilMux"
+#include "MicroBox/hardware/sensor/SoilCalibration"
+#include "MicroBox/hardware/sensor/AdaptiveSampler"
+#include "MicroBox/hardware/sensor/FlowMeter"
 #include "MicroBox/hardware/RelayController"
 #include "MicroBox/hardware/LCDdisplay"
 
@@ -46,6 +52,8 @@
 #include "MicroBox/software/ProgramWiFi"
 #include "MicroBox/software/WebServer"
 #include "MicroBox/software/WateringSys"
+#include "MicroBox/software/SensorSys"
+#include "MicroBox/software/StateEpoch"
 #include "MicroBox/externobj"
 #include "variable"
 
@@ -58,12 +66,33 @@ LEDBoard led_running, led_warning; //!< Led indikator program
 LCDdisplay lcd = LCDdisplay(); //!< LCD utility module
 DHTProgram dhtprog = DHTProgram(PIN_DHT, DHT22); //!< DHT sensor program
 SoilMoisture soilmoisture; //!< Soil Moisture sensor management module
+RainCheck raincheck; //!< Rain sensor management module
+SensorList sensors = SensorList( //!< Compile-time registry of every sensor channel
+    SoilMoistureChannel(soilmoisture),
+    TemperatureChannel(dhtprog),
+    HumidityChannel(dhtprog),
+    RainChannel(raincheck)
+);
+#if SOIL_MUX_ENABLE
+SoilMux<SOIL_MUX_CHANNELS> soilmux; //!< Multiplexed soil probes scanner
+#endif
+SoilCalibrationLUT soilcal[SOIL_PROBES]; //!< Compiled calibration per soil probe
+SoilCalCapture soilcalcapture; //!< Pending calibration capture from the web server
+AdaptiveSampler sampler = AdaptiveSampler( //!< Sensor sampling period driven by the watering state
+    SAMPLE_PERIOD_MIN_MS, SAMPLE_PERIOD_MAX_MS,
+    SAMPLE_CHANGE_THRESHOLD, SAMPLE_BOOST_MS
+);
+#if FLOW_METER_ENABLE
+PcntPulseSource<WATERING_ZONES> flowpulses(FLOW_PINS); //!< Flow meter pulses counted by the PCNT units
+ZoneFlowMeter flowmeter(flowpulses); //!< Flow rate, totals and dry-run / leak detection per zone
+#endif
 // RelayController relayController; //!< Relay management module
 
 // Initializes System Program
 MyEEPROM myeeprom_prog;  //!< EEPROM utility module
 LFSMemory lfsprog;       //!< LittleFS management module
 WateringSys wateringSys; //!< Watering System program
+SensorSys sensorSys;     //!< Sensor sampling, health and flow metering
 
 // Milliseconds trackers for task execution
 unsigned long __lastMillis__ = 0, __lastTimeReboot__ = 0;
@@ -79,22 +108,21 @@ bool RebootState = false; //!< Tracks ESP reboot state
 void ThisRTOS::vTask1(void *pvParameter) {
     (void) pvParameter; // Unused parameter
 
-    // Initialize sensor
-    soilmoisture.begin(PIN_SMS);
-    dhtprog.begin();
+    sensorSys.begin();
+
+    unsigned long LastTimeRefreshLCD = 0;
+    constexpr unsigned long LCD_REFRESH_MS = 1500;
 
     while (true) {
-        // Run soil moisture sensor and update readings
-        soilmoisture.getData(true, 4095, 2500);
+        unsigned long wakeMicros = micros();
+        bool watering_process = wateringSys.WateringProcess;
 
-        // Run dht sensor and update readings
-        dhtprog.running();
+        // Sample, scan, calibrate, meter and check the sensors that are due
+        uint32_t wait = sensorSys.run();
 
-        bool watering_process = wateringSys.WateringProcess;
         watering_process ? led_running.on() : led_running.off();
 
         // static unsigned long LastTimeRefreshMonitor = 0;
-        static unsigned long LastTimeRefreshLCD = 0;
         // if ((unsigned long) (millis() - LastTimeRefreshMonitor) >= 1000L)
         // {
         //     LastTimeRefreshMonitor = millis();
@@ -123,58 +151,77 @@ void ThisRTOS::vTask1(void *pvParameter) {
         //     }
         // }
 
-        if ((unsigned long) (millis() - LastTimeRefreshLCD) >= 1500L) {
+        if ((unsigned long) (millis() - LastTimeRefreshLCD) >= LCD_REFRESH_MS) {
             LastTimeRefreshLCD = millis();
 
-            auto updateLCD = [](int state, bool watering_process) {
-                if (state <= 5) {
-                    lcd.clear();
-                    lcd.print("Temp: ", 0, 0);
-                    lcd.print(String(dhtprog.temperature) + "*C");
-                    lcd.print("Hum: ", 0, 1);
-                    lcd.print(String(dhtprog.humidity) + "%");
-                }
-
-                if (state >= 5 && state <= 10) {
-                    lcd.clear();
-                    lcd.print("Soil Moisture", 0, 0);
-                    lcd.print("Value: ", 0, 1);
-                    lcd.print(String(soilmoisture.value) + "%");
-                }
-                
-                if (state >= 10 && state <= 15) {
-                    lcd.clear();
-                    lcd.print("Auto Watering: ", 0, 0);
-                    lcd.print(wateringSys.AutoWateringState ? "Enable" : "Disable", 0, 1);
-                }
-
-                if (state >= 15 && state <= 20) {
-                    lcd.clear();
-                    lcd.print("Watering State: ", 0, 0);
-                    lcd.print(watering_process ? "Watering" : "Standby", 0, 1);
+            // One page per registered sensor, followed by the system status pages
+            constexpr int STATUS_PAGES = 5;
+            constexpr int TICKS_PER_PAGE = 5;
+            constexpr int TOTAL_PAGES = SensorList::COUNT + STATUS_PAGES;
+
+            auto updateLCD = [](int page, bool watering_process) {
+                lcd.clear();
+                if (page < (int) SensorList::COUNT) {
+                    sensors.visit(page, [](auto &ch) {
+                        using T = std::decay_t<decltype(ch)>;
+                        lcd.print(T::LABEL, 0, 0);
+                        if (ch.quarantined()) {
+                            lcd.print("Fault: ", 0, 1);
+                            lcd.print(SensorHealth::faultText(ch.health.fault()));
+                        }
+                        else {
+                            lcd.print("Value: ", 0, 1);
+                            lcd.print(ch.text());
+                        }
+                    });
+                    return;
                 }
 
-                if (state >= 20 && state <= 25) {
-                    lcd.clear();
-                    lcd.print("WiFi mode: ", 0, 0);
-                    lcd.print(WiFi.getMode() == WIFI_STA ? "STA" : "AP", 0, 1);
-                }
-
-                if (state >= 25 && state <= 30) {
-                    lcd.clear();
-                    String statusWiFiSta = WiFi.status() == WL_CONNECTED ? "Connected" : "Disconnected";
-                    lcd.print("Status: ", 0, 0);
-                    lcd.print(WiFi.getMode() == WIFI_STA ? statusWiFiSta : "Unknown", 0, 1);
+                switch (page - SensorList::COUNT) {
+                    case 0:
+                        lcd.print("Auto Watering: ", 0, 0);
+                        lcd.print(wateringSys.AutoWateringState ? "Enable" : "Disable", 0, 1);
+                        break;
+
+                    case 1:
+                        lcd.print("Watering State: ", 0, 0);
+                        lcd.print(watering_process ? "Watering" : "Standby", 0, 1);
+                        break;
+
+                    case 2: {
+                        uint8_t quarantined = sensors.quarantined();
+                        lcd.print("Sensor Health: ", 0, 0);
+                        if (quarantined == 0)
+                            lcd.print("All OK", 0, 1);
+                        else
+                            lcd.print(String(quarantined) + " fault(s)", 0, 1);
+                        break;
+                    }
+
+                    case 3:
+                        lcd.print("WiFi mode: ", 0, 0);
+                        lcd.print(WiFi.getMode() == WIFI_STA ? "STA" : "AP", 0, 1);
+                        break;
+
+                    default: {
+                        String statusWiFiSta = WiFi.status() == WL_CONNECTED ? "Connected" : "Disconnected";
+                        lcd.print("Status: ", 0, 0);
+                        lcd.print(WiFi.getMode() == WIFI_STA ? statusWiFiSta : "Unknown", 0, 1);
+                        break;
+                    }
                 }
             };
 
             static int lcdState = 0;
-            updateLCD(lcdState, watering_process);
-            lcdState = (lcdState + 1) % 30;
+            updateLCD(lcdState / TICKS_PER_PAGE, watering_process);
+            lcdState = (lcdState + 1) % (TOTAL_PAGES * TICKS_PER_PAGE);
         }
 
-        // Delay the task for 100 miliseconds to control the task execution frequency
-        vTaskDelay(pdMS_TO_TICKS(100));
+        // Sleep until the next sample or LCD refresh is due, or a relay switches (sensorSys.wake())
+        unsigned long now = millis();
+        sampler.awake(micros() - wakeMicros, now);
+        wait = min(wait, (uint32_t) (LCD_REFRESH_MS - min(now - LastTimeRefreshLCD, LCD_REFRESH_MS)));
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(max(wait, (uint32_t) 10)));
     }
 }
 
@@ -206,6 +253,10 @@ void ThisRTOS::vTask2(void *pvParameter) {
     );
     ProgramWiFi.initWiFi(wifi_state);
 
+    // Clock for the watering schedules (SNTP keeps it synchronized in the background)
+    if (WiFi.getMode() == WIFI_STA)
+        configTime(0, 0, SCHEDULE_NTP_SERVER_1, SCHEDULE_NTP_SERVER_2);
+
     // Initialize Blynk Program
     BlynkSetup();
 
@@ -220,6 +271,8 @@ void ThisRTOS::vTask2(void *pvParameter) {
         // If the WiFi mode is set to Access Point (AP), update the web for OTA updates.
         if (WiFi.getMode() == WIFI_AP) {
             WebServer.UpdateOTAloop();
+            // Publish the state that changed for the dashboards on /ws and /events
+            WebServer.pushState();
         }
 
         // Delay the task for 100 miliseconds to control the task execution frequency
@@ -234,7 +287,6 @@ void ThisRTOS::vTask2(void *pvParameter) {
 void ThisRTOS::vTask3(void *pvParameter) {
     (void) pvParameter;
     
-    wateringSys.begin();
     ButtonManager.init();
     lcd.backlight(ButtonManager.backlightState);
 
@@ -251,13 +303,28 @@ void ThisRTOS::vTask3(void *pvParameter) {
         // Execute process queue for RelayController
         RelayController::PROCESSQUEUE();
 
-        wateringSys.run();
-
         // Delay the task for 100 miliseconds to control the task execution frequency
         vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
 
+/**
+ * @brief Task for the watering logic.
+ * @param pvParameter Parameters for the task (not used).
+ * @details Sleeps on the watering event queue: it wakes once per sensor
+ *          sample, configuration change or relay switch, and on the timers
+ *          of the running schedules, rules and pulse-and-soak zones.
+ */
+void ThisRTOS::vTask4(void *pvParameter) {
+    (void) pvParameter;
+
+    wateringSys.begin();
+
+    while (true) {
+        wateringSys.run();
+    }
+}
+
 /**
  * @brief Setup function for initializing harware and modules.
  * @param baud Baud Rate for serial communication.
@@ -281,6 +348,9 @@ void MicroBox_Main::setup(unsigned long baud) {
     led_running.begin(LED_RUNNING);
     led_warning.begin(LED_WARNING);
     bootbtn.begin();
+
+    // Event queue of the watering task (must exist before the producers start)
+    wateringSys.events.begin();
     
     // Create FreeRTOS task
     // ThisRTOS *rtos = new ThisRTOS;
@@ -299,6 +369,11 @@ void MicroBox_Main::setup(unsigned long baud) {
         static_cast<ThisRTOS*>(param)->vTask3(param);
     }, "Task 3", 4096, NULL, 1, NULL, APP_CPU_NUM);
 
+    // Create Task and Running vTask 4
+    xTaskCreateUniversal([](void *param) {
+        static_cast<ThisRTOS*>(param)->vTask4(param);
+    }, "Task 4", 4096, NULL, 1, NULL, APP_CPU_NUM);
+
     // delete rtos;
 }
 
@@ -23,6 +23,7 @@
 
 #include "MicroBox/hardware/RelayController"
 #include "MicroBox/externobj"
+#include "MicroBox/software/StateEpoch"
 
 // initialization static variable
 int RelayController::ID_RELAY;
@@ -73,11 +74,13 @@ void RelayController::begin(bool _optocouple, uint32_t _delay) {
 
         pinMode(this->pins_io_relay, OUTPUT);
         digitalWrite(this->pins_io_relay, this->relay_state ? this->ON : this-> OFF);
+        StateEpoch::bump();
         delay(_delay);
     }
 }
 
 void RelayController::read(String relay_varName) {
+    std::lock_guard<std::mutex> lock(this->queueLock);
     // parse data relay
     lfsprog.parseVarRelay(
         relay_varName,
@@ -100,6 +103,7 @@ void RelayController::read(uint8_t pin_relay) {
 
 void RelayController::write(const String &relay_varName, const bool &state, uint32_t _delay)
 {
+    std::lock_guard<std::mutex> lock(this->queueLock);
     lfsprog.parseVarRelay(
         relay_varName,
         &this->pins_io_relay,
@@ -126,6 +130,7 @@ void RelayController::write(const uint8_t &pin_relay, const bool &state, uint32_
 
 void RelayController::write_without_save(const String &relay_varName, const bool &state, uint32_t _delay)
 {
+    std::lock_guard<std::mutex> lock(this->queueLock);
     lfsprog.parseVarRelay(
         relay_varName,
         &this->pins_io_relay,
@@ -150,8 +155,29 @@ void RelayController::write_without_save(const uint8_t &pin_relay, const bool &s
     this->write_without_save(String(VAR_SWITCH) + String(pin_relay), state, _delay);
 }
 
+void RelayController::write_batch(const std::vector<std::pair<uint8_t, bool>> &states, uint32_t _delay)
+{
+    std::lock_guard<std::mutex> lock(this->queueLock);
+    for (const auto &item : states) {
+        // ID is the position in RELAY_PINS, as in the default relay.json
+        int id = 0;
+        while (id < (int) WATERING_ZONES && RELAY_PINS[id] != item.first) id++;
+
+        this->actionQueue.push({
+            item.first,
+            item.second,
+            id,
+            String(VAR_SWITCH) + String(item.first),
+            _delay,
+            millis() + _delay,
+            false
+        });
+    }
+}
+
 void RelayController::executeAction(const RelayAction &action) {
     digitalWrite(action.pin_relay, action.state ? this->ON : this->OFF);
+    StateEpoch::bump();
     if (action.saveState) {
         lfsprog.changeStateRelay(String(VAR_SWITCH) + String(action.pin_relay), action.state);
     }
@@ -163,16 +189,31 @@ void RelayController::executeAction(const RelayAction &action) {
         action.state, 
         action.saveState ? "Yes" : "No"
     );
+
+    // Let the watering task see manual switching without polling the pins
+    wateringSys.events.notify(WATERING_EV_RELAY);
+    // and sample the soil right away at the fast period
+    sensorSys.wake();
 }
 
 void RelayController::processQueue() {
-    while (!this->actionQueue.empty()) {
-        RelayAction action = this->actionQueue.front();
-        if (millis() >= action.nextActionTime) {
+    while (true) {
+        RelayAction action;
+        {
+            std::lock_guard<std::mutex> lock(this->queueLock);
+            if (this->actionQueue.empty() || millis() < this->actionQueue.front().nextActionTime)
+                break;
+            action = this->actionQueue.front();
             this->actionQueue.pop();
-            this->executeAction(action);
-        } else {
-            break;
         }
+        // Outside the lock: the file write and the notifications do not hold up the writers
+        this->executeAction(action);
     }
 }
+
+uint32_t RelayController::remaining(unsigned long now) const {
+    std::lock_guard<std::mutex> lock(this->queueLock);
+    if (this->actionQueue.empty()) return UINT32_MAX;
+    int32_t left = (int32_t) (this->actionQueue.front().nextActionTime - (uint32_t) now);
+    return left > 0 ? (uint32_t) left : 0;
+}
@@ -0,0 +1,277 @@
+/**
+ *  @file SensorSys.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "MicroBox/software/SensorSys"
+#include "MicroBox/software/StateEpoch"
+#include "MicroBox/externobj"
+
+/**
+ * @brief Load the probe calibrations and initialize every registered sensor.
+ */
+void SensorSys::begin() {
+    for (uint8_t probe = 0; probe < SOIL_PROBES; probe++)
+        lfsprog.readCalibration(probe, soilcal[probe]);
+    soilmoisture.calibration = &soilcal[0];
+    soilmoisture.oversampling = SOIL_OVERSAMPLING;
+#if SOIL_MUX_ENABLE
+    soilmux.calibration = &soilcal[1];
+    soilmux.oversampling = SOIL_OVERSAMPLING;
+#endif
+
+    sensors.begin();
+#if SOIL_MUX_ENABLE
+    soilmux.begin(
+        PIN_MUX_S0, PIN_MUX_S1, PIN_MUX_S2, PIN_MUX_S3,
+        PIN_MUX_SIG, SOIL_MUX_SETTLE_US, SOIL_MUX_PERIOD_MS
+    );
+#endif
+#if FLOW_METER_ENABLE
+    flowmeter.begin();
+#endif
+    this->_task = xTaskGetCurrentTaskHandle();
+}
+
+void SensorSys::wake() {
+    this->_relayChanged.store(true, std::memory_order_release);
+    if (this->_task) xTaskNotifyGive(this->_task);
+}
+
+/**
+ * @brief Sample, scan, capture, meter and check health when each is due.
+ * @return Milliseconds until the next of them is due.
+ */
+uint32_t SensorSys::run() {
+    this->sampleRain();
+
+    // Sample every registered sensor when the adaptive period has elapsed or a relay switched
+    if (this->_relayChanged.exchange(false, std::memory_order_acquire)) sampler.wake();
+    if (sampler.due(millis())) {
+        sensors.sample();
+        this->runHealth();
+        sampler.update(soilmoisture.value, this->relays() != 0, millis());
+        StateEpoch::bump();
+        this->postSample();
+#if SOIL_MUX_ENABLE
+        soilmux.setPeriod(max((uint32_t) SOIL_MUX_PERIOD_MS, sampler.period()));
+#endif
+    }
+#if SOIL_MUX_ENABLE
+    // Scan the multiplexed probes once per SOIL_MUX_PERIOD_MS (or slower while stable)
+    if (soilmux.run(true, 4095, 2500)) {
+        this->runMuxHealth();
+        StateEpoch::bump();
+        this->postSample();
+    }
+#endif
+
+    // Serve a pending calibration capture
+    this->processCalibrationCapture();
+
+#if FLOW_METER_ENABLE
+    // Read the flow meter counters once per FLOW_PERIOD_MS
+    this->runFlowMeters();
+#endif
+
+    unsigned long now = millis();
+    uint32_t wait = sampler.remaining(now);
+    wait = min(wait, (uint32_t) (RAIN_SAMPLE_MS - min(now - this->_lastRain, (unsigned long) RAIN_SAMPLE_MS)));
+#if FLOW_METER_ENABLE
+    wait = min(wait, flowmeter.remaining(now));
+#endif
+    return wait;
+}
+
+/**
+ * @brief Relays that are on, one bit per zone, read from the pins.
+ * @details Manual switching counts too.
+ */
+uint8_t SensorSys::relays() const {
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+        if (RelayController::RELAY_STATE_STR_INT(digitalRead(RELAY_PINS[i])))
+            mask |= 1 << i;
+    }
+    return mask;
+}
+
+/**
+ * @brief Read the rain sensor once per RAIN_SAMPLE_MS.
+ * @details The rain filter measures its confirm and dry-out windows in
+ *          samples over time, so it keeps a fixed period while the soil
+ *          sampling slows down. A sample is posted when the deferral changes.
+ */
+void SensorSys::sampleRain() {
+    if (this->_rainStarted && (unsigned long) (millis() - this->_lastRain) < RAIN_SAMPLE_MS) return;
+    this->_rainStarted = true;
+    this->_lastRain = millis();
+
+    sensors.get<RainChannel>().read();
+    this->runHealth();
+
+    bool defer = raincheck.filter.deferred(millis());
+    bool soaked = raincheck.filter.soaked();
+    if (defer != this->_lastRainDefer || soaked != this->_lastRainSoaked) {
+        StateEpoch::bump();
+        this->postSample();
+    }
+}
+
+/**
+ * @brief Read one raw ADC value from a soil probe.
+ * @param probe Probe index (0 = PIN_SMS, 1.. = mux channels).
+ */
+int SensorSys::readProbeRaw(uint8_t probe) {
+#if SOIL_MUX_ENABLE
+    if (probe > 0) return soilmux.readRaw(probe - 1);
+#endif
+    (void) probe;
+    return soilmoisture.readRaw();
+}
+
+/**
+ * @brief Perform a calibration capture queued by the web server.
+ * @details Runs on the sensor task so the ADC and mux are never shared.
+ */
+void SensorSys::processCalibrationCapture() {
+    if (!soilcalcapture.pending.load(std::memory_order_acquire)) return;
+
+    uint8_t probe = soilcalcapture.probe;
+    if (soilcalcapture.reset) {
+        lfsprog.resetCalibration(probe);
+        lfsprog.readCalibration(probe, soilcal[probe]);
+        soilcalcapture.reset = false;
+        soilcalcapture.pending.store(false, std::memory_order_release);
+        return;
+    }
+
+    soilcalcapture.result = SoilCalibrationLUT::capture(
+        [this, probe]() { return this->readProbeRaw(probe); },
+        soilcalcapture.samples
+    );
+
+    if (soilcalcapture.save) {
+        SoilCalPoint point = {
+            (uint16_t) lroundf(soilcalcapture.result.mean),
+            soilcalcapture.percent
+        };
+        if (lfsprog.changeCalibrationPoint(probe, point, soilcalcapture.result))
+            lfsprog.readCalibration(probe, soilcal[probe]);
+        else
+            Serial.printf("Calibration probe%u is full\n", probe);
+    }
+
+    soilcalcapture.ready.store(true, std::memory_order_release);
+    soilcalcapture.pending.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief Post the readings of every sensor to the watering task.
+ * @details Quarantined or failed channels are posted as NaN.
+ */
+void SensorSys::postSample() {
+    WateringEvent sample;
+    if (!sensors.get<SoilMoistureChannel>().quarantined())
+        sample.soil = soilmoisture.value;
+#if SOIL_MUX_ENABLE
+    for (uint8_t ch = 0; ch < SOIL_MUX_CHANNELS; ch++) {
+        bool usable = soilmux.value[ch] >= 0 && !this->_muxHealth[ch].quarantined();
+        sample.probes[ch] = usable ? soilmux.value[ch] : NAN;
+    }
+#endif
+    if (!sensors.get<TemperatureChannel>().quarantined() && dhtprog.temperatureValid)
+        sample.temperature = dhtprog.temperature;
+    if (!sensors.get<HumidityChannel>().quarantined() && dhtprog.humidityValid)
+        sample.humidity = dhtprog.humidity;
+    if (!sensors.get<RainChannel>().quarantined() && raincheck.value >= 0) {
+        sample.rain       = raincheck.filter.level();
+        sample.rainDefer  = raincheck.filter.deferred(millis());
+        sample.rainSoaked = raincheck.filter.soaked();
+    }
+    this->_lastRainDefer  = sample.rainDefer;
+    this->_lastRainSoaked = sample.rainSoaked;
+    wateringSys.events.post(sample);
+}
+
+/**
+ * @brief Read the flow meters and post a changed flow fault to the watering task.
+ * @details The relay mask is read from the pins, so manual switching is checked too.
+ */
+void SensorSys::runFlowMeters() {
+#if FLOW_METER_ENABLE
+    if (!flowmeter.due(millis())) return;
+
+    bool changed = flowmeter.update(this->relays(), millis());
+
+    // New rate and volume while water flows (and once when it stops)
+    float lpm = flowmeter.totalLpm();
+    if (changed || lpm != 0 || this->_lastLpm != 0) StateEpoch::bump();
+    this->_lastLpm = lpm;
+    if (!changed) return;
+
+    WateringEvent event;
+    event.type  = WATERING_EV_FLOW;
+    event.zones = flowmeter.dryRun();
+    event.state = flowmeter.leak();
+    wateringSys.events.post(event);
+#endif
+}
+
+/**
+ * @brief Run the sensor health detectors on the sample just taken.
+ * @details Once per sample, so a reading is never counted twice.
+ */
+void SensorSys::runHealth() {
+    uint8_t quarantined = sensors.checkHealth(millis());
+
+    // Only a fault change is news for the web snapshot; the statistics follow the next sample
+    uint32_t faults = 0;
+    sensors.forEach([&](auto &ch) { faults = (faults << 2) | ch.health.fault(); });
+    if (faults != this->_lastFaults) {
+        StateEpoch::bump();
+        this->_lastFaults = faults;
+    }
+    if (quarantined != this->_lastQuarantined) {
+        Serial.printf("Sensor health: %u channel(s) quarantined\n", quarantined);
+        this->_lastQuarantined = quarantined;
+    }
+}
+
+/**
+ * @brief Run the soil detectors on every multiplexed probe after a scan.
+ * @details The probes have no channel in the registry; they use the limits of
+ *          the soil channel and the raw reading of the scan.
+ */
+void SensorSys::runMuxHealth() {
+#if SOIL_MUX_ENABLE
+    uint8_t quarantined = 0;
+    for (uint8_t ch = 0; ch < SOIL_MUX_CHANNELS; ch++) {
+        if (this->_muxHealth[ch].update(soilmux.value[ch], soilmux.value[ch] >= 0,
+                SoilMoistureChannel::HEALTH, millis(), soilmux.raw[ch]) != SENSOR_OK)
+            quarantined++;
+    }
+    if (quarantined != this->_lastMuxQuarantined) {
+        Serial.printf("Soil mux health: %u probe(s) quarantined\n", quarantined);
+        this->_lastMuxQuarantined = quarantined;
+    }
+#endif
+}
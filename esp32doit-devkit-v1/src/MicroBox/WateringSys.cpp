@@ -23,6 +23,7 @@
 
 #include "MicroBox/software/WateringSys"
 #include "MicroBox/externobj"
+#include "MicroBox/software/StateEpoch"
 #include "variable"
 
 /**
@@ -33,8 +34,11 @@
  */
 inline void WateringSys::startWatering() {
     this->_isWatering = true;
-    for (const auto &item : RELAY_PINS)
-        RelayController::WRITE(item, true, 1000);
+    for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+        // A zone locked out after a dry run stays closed
+        if (!(this->_flowLockout & (1 << i)))
+            RelayController::WRITE(RELAY_PINS[i], true, 1000);
+    }
 
     if (!this->hasStarted && this->hasCompleted) {
         Serial.println(F("Automatic watering is started."));
@@ -51,6 +55,10 @@ inline void WateringSys::startWatering() {
  */
 inline void WateringSys::stopWatering() {
     this->_isWatering = false;
+    this->_predictiveStart = false;
+    // A plan made before (or during) the cycle is stale once the cycle ends
+    this->forecast.clearPlan();
+    this->_stoppedAt = millis();
     for (const auto &item : RELAY_PINS)
         RelayController::WRITE(item, false, 1000); // Turn off relays
 
@@ -62,40 +70,623 @@ inline void WateringSys::stopWatering() {
 }
 
 void WateringSys::begin() {
+    this->sessions.flowLpm = WATERING_FLOW_LPM;
+    // Later changes arrive as WATERING_EV_AUTO events
     lfsprog.readConfigState(AUTOWATERING, &this->AutoWateringState);
+    this->applyConfig();
+    lfsprog.readSchedules(this->schedules);
+    Serial.printf("Watering schedules: %u\n", this->schedules.count);
+    lfsprog.readRules(this->rules);
+    Serial.printf("Watering rules: %u\n", this->rules.count);
+}
+
+/**
+ * @brief Load the controller configuration and hand the pump settings to the scheduler.
+ */
+void WateringSys::applyConfig() {
+    lfsprog.readWateringConfig(this->config);
+    this->scheduler.pumps  = this->config.pumps;
+    this->scheduler.policy = this->config.policy;
+    raincheck.filter.config = this->config.rain;
+    Serial.printf("Watering mode: %s, %u pump(s), %s order\n",
+        wateringModeText(this->config.mode),
+        this->config.pumps,
+        this->config.policy == SCHED_PRIORITY ? "priority" : "fair");
 }
 
 /**
  * @brief Main execution loop for the watering system
  * @details
- * This method evaluates the conditions for starting or stopping watering:
- * - Checks if automatic watering is enabled.
- * - Monitors Soil Moisture levels
+ * Blocks on the event queue until a sample or a change arrives, or until the
+ * next timer (schedule, rule window, session settle, pulse-and-soak tick) is
+ * due, then evaluates the controllers once:
+ * - Starts and stops the scheduled watering windows.
+ * - Defers automatic watering while it rains or the soil dries out after the rain.
+ * - Feeds the rule inputs and runs the rules whose inputs changed.
+ * - Feeds the demand forecast every FORECAST_SAMPLE_MS.
+ * - Runs the threshold (or predictive) check once per new sample, or the pulse-and-soak zones on every wakeup.
+ * - Records the watering sessions from the relay state.
  */
-
 void WateringSys::run() {
-    // Ensure the function is executed only once every second
-    if (millis() - _LastMillis1 >= 5000) {
-        _LastMillis1 = millis();
+    WateringEvent event;
+    bool received = this->events.wait(event, this->nextTimeout());
+    this->wakeup(received ? &event : nullptr);
+}
+
+/**
+ * @brief Handle one event (or a timer when `event` is nullptr) and evaluate once.
+ */
+void WateringSys::wakeup(const WateringEvent *event) {
+    this->wakeups++;
+    this->_wakeupCount++;
+    if (millis() - this->_wakeupWindow >= 60000) {
+        this->_wakeupWindow = millis();
+        this->wakeupsLastMinute = this->_wakeupCount;
+        this->_wakeupCount = 0;
+    }
+
+    bool sample = event != nullptr && event->type == WATERING_EV_SAMPLE;
+    if (event != nullptr) this->handleEvent(*event);
+    this->evaluate(sample);
+
+    if (sample) {
+        this->lastLatencyUs = micros() - event->us;
+        if (this->lastLatencyUs > this->maxLatencyUs) this->maxLatencyUs = this->lastLatencyUs;
+    }
+}
+
+/**
+ * @brief Apply one event posted by another task.
+ */
+void WateringSys::handleEvent(const WateringEvent &event) {
+    switch (event.type) {
+        case WATERING_EV_SAMPLE:
+            this->_sample = event;
+            this->smoothSoil();
+            break;
+
+        case WATERING_EV_CONFIG:
+            if (this->_isWatering) this->stopWatering();
+            this->stopZones();
+            this->applyConfig();
+            this->_scheduleOn = 0; // reopened by applyScheduleZones() if a window is running
+            break;
+
+        case WATERING_EV_SCHEDULES:
+            lfsprog.readSchedules(this->schedules);
+            this->_scheduleZones = 0;
+            this->_scheduleSynced = false;
+            this->_scheduleDue = millis();
+            break;
+
+        case WATERING_EV_RULES:
+            lfsprog.readRules(this->rules);
+            for (auto &until : this->_ruleUntil) until = millis();
+            this->_holdUntil = millis();
+            break;
+
+        case WATERING_EV_AUTO:
+            this->AutoWateringState = event.state;
+            StateEpoch::bump();
+            Serial.printf("Automatic watering %s.\n", event.state ? "enabled" : "disabled");
+            break;
+
+        case WATERING_EV_FLOW:
+            this->handleFlowFault(event);
+            break;
+
+        default: // WATERING_EV_RELAY: the relay state is read in evaluate()
+            break;
+    }
+}
+
+/**
+ * @brief Lock out the zones that ran dry and report a leak.
+ * @details A zone with a dry run (relay on, no flow) is closed and left out of
+ *          every automatic controller until the fault is cleared from the web
+ *          server; manual switching stays possible. A leak is only reported,
+ *          there is no relay left to close.
+ */
+void WateringSys::handleFlowFault(const WateringEvent &event) {
+    uint8_t dry = event.zones & ~this->_flowLockout;
+    for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+        if (!(dry & (1 << i))) continue;
+        Serial.printf("Zone %u dry run (no flow with the relay on), zone locked out.\n", i);
+        RelayController::WRITE(RELAY_PINS[i], false, 0);
+    }
+    if (this->_flowLockout & ~event.zones)
+        Serial.println(F("Flow fault cleared, zones released."));
+    this->_flowLockout = event.zones;
+
+    if (event.state != this->_flowLeak) {
+        Serial.println(event.state
+            ? F("Water flowing with every relay off, check for a leak.")
+            : F("Leak flow stopped."));
+        this->_flowLeak = event.state;
+    }
+}
+
+/**
+ * @brief Run the controllers once.
+ * @param sample `true` when this wakeup brought new sensor readings.
+ */
+void WateringSys::evaluate(bool sample) {
+    bool process = this->wateringProcess();
+    if (process != WateringProcess) {
+        WateringProcess = process;
+        StateEpoch::bump();
+    }
+
+    this->runSchedules();
+    this->runRules();
+    this->runRainDeferral();
+    this->applyScheduleZones();
+
+    if (sample) {
+        if (millis() - this->_LastForecast >= FORECAST_SAMPLE_MS) {
+            this->_LastForecast = millis();
+            this->updateForecast();
+        }
+
+        if (this->config.mode == WATERING_MODE_THRESHOLD)
+            this->runThreshold();
+        else if (this->config.mode == WATERING_MODE_PREDICTIVE)
+            this->runPredictive();
+    }
+
+    if (this->config.mode == WATERING_MODE_PULSE)
+        this->runPulseSoak();
+
+    this->recordSession();
+}
+
+/**
+ * @brief Milliseconds until the next timer of the controllers is due.
+ */
+uint32_t WateringSys::nextTimeout() const {
+    unsigned long now = millis();
+    uint32_t wait = WATERING_IDLE_MS;
+    auto until = [&](unsigned long deadline) {
+        long left = (long) (deadline - now);
+        if (left < 0) left = 0;
+        if ((uint32_t) left < wait) wait = left;
+    };
+
+    until(this->_scheduleDue);
+    for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+        if (this->_ruleZones & (1 << i)) until(this->_ruleUntil[i]);
+        if (this->_makeupZones & (1 << i)) until(this->_makeupUntil[i]);
+    }
+    if (this->_held) until(this->_holdUntil);
+    wait = min(wait, this->sessions.remaining(now));
+
+    // Pulse and soak phases are timed: tick while a zone is not idle
+    if (this->config.mode == WATERING_MODE_PULSE) {
+        for (const auto &zone : this->zones) {
+            if (zone.state() != PulseSoakController::IDLE) return min(wait, (uint32_t) WATERING_TICK_MS);
+        }
+    }
+    return wait;
+}
+
+/**
+ * @brief Legacy bang-bang control on the `low` / `high` levels for every relay.
+ */
+void WateringSys::runThreshold() {
+    if (!this->AutoWateringState) return;
+    if (this->_scheduleOn) return; // A scheduled window owns the relays
+    // Every zone locked out after a dry run: nothing left to water
+    bool dry = this->_flowLockout == WATERING_ZONES_MASK;
+    if (this->_held || this->_rainDeferred || dry) {
+        if (this->_isWatering) this->stopWatering();
+        return;
+    }
+
+    // Never act on a quarantined probe: stop and wait until it recovers
+    if (isnan(this->_sample.soil)) {
+        if (!this->_sensorFault) {
+            Serial.println(F("Soil moisture sensor fault, automatic watering suspended."));
+            this->_sensorFault = true;
+        }
+        if (this->_isWatering) this->stopWatering();
+        return;
+    }
+    else if (this->_sensorFault) {
+        Serial.println(F("Soil moisture sensor recovered, automatic watering resumed."));
+        this->_sensorFault = false;
+    }
+
+    // Retrieve current SoilMoisture
+    if (this->_sample.soil > this->config.high) {
+        if (this->_isWatering || this->WateringProcess) this->stopWatering();
+        return; // Exit after stopping watering
+    }
+    else if (this->_sample.soil < this->config.low) {
+        if (this->_isWatering) return; // Watering already active
+        this->startWatering();
+    }
+}
+
+/**
+ * @brief Threshold control, plus an early start at the hour planned by the forecast.
+ * @details The threshold logic stays the safety net (and the stop rule); the
+ *          forecast only starts a cycle before the soil reaches the `low` level:
+ *          - the planned hour is reached and the forecast crossing of `low` is
+ *            inside the planning window (FORECAST_WINDOW_S);
+ *          - the smoothed soil level is within FORECAST_NEAR of `low`;
+ *          - at least PREDICTIVE_MIN_OFF_MS have passed since the last stop.
+ */
+void WateringSys::runPredictive() {
+    this->runThreshold();
+    if (!this->AutoWateringState || this->_held || this->_rainDeferred || this->_scheduleOn || this->_sensorFault || this->_isWatering) return;
+    if (this->_stoppedAt && millis() - this->_stoppedAt < PREDICTIVE_MIN_OFF_MS) return;
+
+    uint32_t now = WateringSys::localTime();
+    if (!now || !this->forecast.due(now) || !this->forecast.near(now)) return;
+    if (isnan(this->_soilLevel) || this->_soilLevel > this->config.low + FORECAST_NEAR) return;
+
+    Serial.printf("Predictive watering: threshold crossing forecast in %lu s.\n",
+        (unsigned long) (this->forecast.crossing > now ? this->forecast.crossing - now : 0));
+    this->startWatering();
+    this->_predictiveStart = true;
+}
+
+/**
+ * @brief Low-pass the soil samples (time constant FORECAST_SMOOTH_S).
+ * @details The sample period changes with the AdaptiveSampler, so the weight
+ *          of a sample follows the time since the previous one. A jump back up
+ *          (watering, rain) restarts from the new level once the next sample
+ *          confirms it: with one ADC read per sample (SOIL_OVERSAMPLING 1) a
+ *          single spike would restart it, and its decay would read as drying.
+ */
+void WateringSys::smoothSoil() {
+    float soil = this->_sample.soil;
+    unsigned long now = millis();
+    if (isnan(soil)) return;
+
+    if (isnan(this->_soilLevel)) {
+        this->_soilLevel = soil;
+    }
+    else if (soil > this->_soilLevel + FORECAST_MIN_DROP) {
+        // Restart on a rise seen twice in a row: a single high read is probe noise
+        if (this->_soilRising) this->_soilLevel = soil;
+        this->_soilRising = true;
+    }
+    else {
+        this->_soilRising = false;
+        float alpha = 1 - exp(-(float) (now - this->_soilAt) / (FORECAST_SMOOTH_S * 1000.0f));
+        this->_soilLevel += alpha * (soil - this->_soilLevel);
+    }
+    this->_soilAt = now;
+}
+
+/**
+ * @brief Feed the demand forecast with the current soil and air readings.
+ * @details Needs the clock (hour-of-day profile); readings of quarantined
+ *          channels arrive as NaN in the sample. The soil level is the smoothed
+ *          one: single noisy samples must not move the crossing.
+ */
+void WateringSys::updateForecast() {
+    uint32_t now = WateringSys::localTime();
+    if (!now) return;
+
+    bool air = !isnan(this->_sample.temperature) && !isnan(this->_sample.humidity);
 
-        WateringProcess = this->wateringProcess();
+    this->forecast.update(
+        isnan(this->_sample.soil) ? NAN : this->_soilLevel,
+        air ? this->_sample.temperature : NAN,
+        air ? this->_sample.humidity : NAN,
+        this->WateringProcess,
+        this->config.low,
+        this->config.forecastHours,
+        now
+    );
+}
+
+/**
+ * @brief Pulse-and-soak control, one controller per relay zone.
+ * @details A zone whose pulse is due queues for a pump; the scheduler grants
+ *          the queued zones up to the pump capacity and the granted zones
+ *          start their pulse on the next call.
+ */
+void WateringSys::runPulseSoak() {
+    if (!this->AutoWateringState || this->_held || this->_rainDeferred) {
+        this->stopZones();
+        return;
+    }
+
+    unsigned long now = millis();
+    uint8_t priority[WATERING_ZONES];
 
-        // check if automatic watering is enable
-        lfsprog.readConfigState(AUTOWATERING, &this->AutoWateringState);
-        if (!this->AutoWateringState) return;
+    for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+        priority[i] = this->config.zones[i].priority;
 
-        // Retrieve current SoilMoisture
-        if (soilmoisture.value > WATERING_LVL_MAX) {
-            this->stopWatering();
-            return; // Exit after stopping watering
+        // A scheduled window owns the relay of the zone; a locked-out zone was closed on the dry run
+        if ((this->_scheduleOn | this->_flowLockout) & (1 << i)) {
+            this->zones[i].stop(now);
+            this->scheduler.release(i);
+            this->_zoneOn[i] = false;
+            continue;
         }
-        else if (soilmoisture.value < WATERING_LVL_MIN) {
-            if (this->_isWatering) return; // Watering already active
-            this->startWatering();
+
+        bool on = this->zones[i].step(
+            this->zoneMoisture(i), this->config.zones[i], now, this->scheduler.granted(i)
+        );
+        if (this->zones[i].waiting())
+            this->scheduler.request(i, now);
+        else if (!on)
+            this->scheduler.release(i);
+
+        // Controller pulses are not stored: relay.json keeps the state the user chose
+        if (on != this->_zoneOn[i]) {
+            this->_zoneOn[i] = on;
+            RelayController::WRITE_WITHOUT_SAVE(RELAY_PINS[i], on, 0);
+        }
+    }
+
+    this->scheduler.dispatch(priority, now);
+}
+
+/**
+ * @brief Abort every pulse-and-soak cycle and switch their relays off.
+ */
+void WateringSys::stopZones() {
+    for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+        this->zones[i].stop(millis());
+        this->scheduler.release(i);
+        if (this->_zoneOn[i]) {
+            this->_zoneOn[i] = false;
+            RelayController::WRITE_WITHOUT_SAVE(RELAY_PINS[i], false, 0);
         }
     }
 }
 
+/**
+ * @brief Start and stop the scheduled watering windows.
+ * @details The clock is only read when the next start or stop is due (or at
+ *          least every SCHEDULE_RESYNC_MS to follow clock adjustments); between
+ *          two events this is a single millis() comparison.
+ */
+void WateringSys::runSchedules() {
+    if ((long) (millis() - this->_scheduleDue) < 0) return;
+
+    uint32_t now = WateringSys::localTime();
+    if (now == 0) {
+        // No clock yet (AP mode or SNTP not synchronized)
+        this->_scheduleDue = millis() + SCHEDULE_CLOCK_RETRY_MS;
+        return;
+    }
+
+    if (!this->_scheduleSynced) {
+        this->schedules.begin(now);
+        this->_scheduleSynced = true;
+    }
+
+    this->schedules.poll(now,
+        [](uint8_t index, const WateringSchedule &item, uint32_t seconds) {
+            Serial.printf("Schedule %u (%s) started for %lu s.\n", index, item.expr, (unsigned long) seconds);
+        },
+        [](uint8_t index, const WateringSchedule &item) {
+            Serial.printf("Schedule %u (%s) completed.\n", index, item.expr);
+        }
+    );
+
+    if (this->schedules.dirty) {
+        this->schedules.dirty = false;
+        lfsprog.changeSchedules(this->schedules);
+    }
+
+    uint8_t zones = 0;
+    for (uint8_t i = 0; i < this->schedules.count; i++) {
+        if (this->schedules.running(i))
+            zones |= this->schedules.items[i].zones;
+    }
+    this->_scheduleZones = zones;
+
+    // Sleep until the next event
+    uint32_t wait = SCHEDULE_RESYNC_MS, next = this->schedules.nextEvent();
+    if (next && next - now < SCHEDULE_RESYNC_MS / 1000)
+        wait = (next > now) ? (next - now) * 1000UL : 0;
+    this->_scheduleDue = millis() + wait;
+}
+
+/**
+ * @brief Feed the rule inputs and run the rules that depend on a changed one.
+ * @details Inputs are only marked when their value differs, so with steady
+ *          readings this costs the input copies and one mask test. The inputs
+ *          come from the last sample; the clock inputs are read on every wakeup.
+ */
+void WateringSys::runRules() {
+    unsigned long now = millis();
+
+    // Expire the rule windows and the hold
+    uint8_t zones = 0;
+    for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+        if ((long) (this->_ruleUntil[i] - now) > 0) zones |= 1 << i;
+    }
+    this->_ruleZones = zones;
+    if (this->_held && (long) (this->_holdUntil - now) <= 0) {
+        this->_held = false;
+        Serial.println(F("Rule hold ended, automatic watering resumed."));
+    }
+
+    if (!this->rules.count) return;
+
+    this->rules.set(RULE_IN_SOIL, this->_sample.soil);
+    this->rules.set(RULE_IN_TEMP, this->_sample.temperature);
+    this->rules.set(RULE_IN_HUM, this->_sample.humidity);
+    this->rules.set(RULE_IN_RAIN, this->_sample.rain);
+
+    uint32_t local = WateringSys::localTime();
+    this->rules.set(RULE_IN_HOUR, local ? (local / 3600) % 24 : NAN);
+    // 1970-01-01 was a Thursday (0 = Sunday)
+    this->rules.set(RULE_IN_DOW, local ? (local / 86400 + 4) % 7 : NAN);
+
+    this->rules.evaluate([this](uint8_t index, const Rule &rule) {
+        Serial.printf("Rule %u fired.\n", index);
+        this->fireRule(rule);
+    });
+}
+
+/**
+ * @brief Apply the action of a rule that became true.
+ */
+void WateringSys::fireRule(const Rule &rule) {
+    unsigned long until = millis() + rule.seconds * 1000UL;
+
+    switch (rule.action) {
+        case RULE_ZONE_ON:
+            for (uint8_t i = 0; i < WATERING_ZONES; i++)
+                if (rule.zones & (1 << i)) this->_ruleUntil[i] = until;
+            this->_ruleZones |= rule.zones;
+            break;
+
+        case RULE_ZONE_OFF:
+            for (uint8_t i = 0; i < WATERING_ZONES; i++)
+                if (rule.zones & (1 << i)) this->_ruleUntil[i] = millis();
+            this->_ruleZones &= ~rule.zones;
+            break;
+
+        case RULE_HOLD:
+            this->_holdUntil = until;
+            if (!this->_held) Serial.println(F("Rule hold, automatic watering suspended."));
+            this->_held = true;
+            break;
+    }
+}
+
+/**
+ * @brief Defer the automatic watering while it rains or the soil dries out.
+ * @details Scheduled time that falls inside the deferral is owed per zone. When
+ *          the dry-out window ends the owed time is run as a make-up window,
+ *          unless it rained at least `skip_min` minutes in the last 24 hours.
+ */
+void WateringSys::runRainDeferral() {
+    unsigned long now = millis();
+    uint32_t elapsed = now - this->_lastApply;
+    this->_lastApply = now;
+
+    bool deferred = this->_sample.rainDefer;
+    if (deferred != this->_rainDeferred) {
+        this->_rainDeferred = deferred;
+        Serial.println(deferred
+            ? F("Rain detected, automatic watering deferred.")
+            : F("Rain dry-out window over, automatic watering resumed."));
+    }
+
+    uint8_t zones = 0;
+    for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+        uint8_t bit = 1 << i;
+        if (deferred) {
+            if (this->AutoWateringState && (this->_scheduleZones & bit)) this->_owedMs[i] += elapsed;
+            this->_makeupUntil[i] = now;
+            continue;
+        }
+        if (this->_owedMs[i]) {
+            if (this->_sample.rainSoaked) {
+                Serial.printf("Deferred watering of zone %u skipped, enough rain.\n", i);
+            }
+            else {
+                Serial.printf("Zone %u make-up watering for %lu s.\n", i, (unsigned long) (this->_owedMs[i] / 1000));
+                this->_makeupUntil[i] = now + this->_owedMs[i];
+            }
+            this->_owedMs[i] = 0;
+        }
+        if ((long) (this->_makeupUntil[i] - now) > 0) zones |= bit;
+    }
+    this->_makeupZones = zones;
+}
+
+/**
+ * @brief Drive the relays of the zones inside a running schedule or rule window.
+ * @details A zone whose soil already reached its limit is closed until the window ends;
+ *          an unusable probe does not stop the window (schedules are time based).
+ *          A rule hold closes every window; a rain deferral closes the scheduled ones.
+ *          Zones locked out after a dry run are never opened.
+ */
+void WateringSys::applyScheduleZones() {
+    // Rules are explicit and may water in the rain; the schedules are deferred
+    uint8_t scheduled = this->_rainDeferred ? 0 : (this->_scheduleZones | this->_makeupZones);
+    uint8_t want = (this->AutoWateringState && !this->_held)
+        ? (scheduled | this->_ruleZones) & ~this->_flowLockout : 0;
+    this->_scheduleCut &= want;
+
+    for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+        uint8_t bit = 1 << i;
+        if ((want & bit) && !(this->_scheduleCut & bit)) {
+            float moisture = this->zoneMoisture(i);
+            if (!isnan(moisture) && moisture >= this->config.zones[i].limit) {
+                this->_scheduleCut |= bit;
+                Serial.printf("Scheduled zone %u closed, soil moisture at the limit.\n", i);
+            }
+        }
+
+        bool on = want & ~this->_scheduleCut & bit;
+        if (on == (bool) (this->_scheduleOn & bit)) continue;
+
+        // Take the relays over from the threshold controller
+        if (on && this->_isWatering) this->stopWatering();
+
+        this->_scheduleOn ^= bit;
+        RelayController::WRITE_WITHOUT_SAVE(RELAY_PINS[i], on, 0);
+    }
+}
+
+/**
+ * @brief Feed the session log with the relay pins (manual switching included).
+ * @details With flow meters fitted the session litres are the metered total.
+ */
+void WateringSys::recordSession() {
+    uint8_t relays = 0;
+    for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+        if (RelayController::RELAY_STATE_STR_INT(digitalRead(RELAY_PINS[i])))
+            relays |= 1 << i;
+    }
+    if (!relays && !this->sessions.active()) return;
+
+#if FLOW_METER_ENABLE
+    float metered = flowmeter.totalLitres();
+#else
+    float metered = NAN;
+#endif
+    if (this->sessions.update(relays, this->sessionTrigger(), this->_sample.soil, millis(), WateringSys::localTime(), metered)) {
+        const WateringSession &item = this->sessions.last();
+        Serial.printf("Watering session (%s): %lu s, %.1f -> %.1f %%, %.1f L\n",
+            SessionLog::triggerText(item.trigger), (unsigned long) item.onSeconds,
+            item.before, item.after, item.litres);
+    }
+}
+
+/**
+ * @brief Which controller owns the relays that are on.
+ */
+uint8_t WateringSys::sessionTrigger() const {
+    if (this->_scheduleOn & this->_ruleZones) return SESSION_RULE;
+    if (this->_scheduleOn) return SESSION_SCHEDULE;
+    if (this->_isWatering) return this->_predictiveStart ? SESSION_PREDICTIVE : SESSION_THRESHOLD;
+    for (const auto &on : this->_zoneOn) {
+        if (on) return SESSION_PULSE;
+    }
+    return SESSION_MANUAL;
+}
+
+uint32_t WateringSys::localTime() {
+    time_t now = time(nullptr);
+    // Before the first SNTP synchronization the clock counts from 1970
+    if (now < SCHEDULE_CLOCK_MIN) return 0;
+    return (uint32_t) (now + SCHEDULE_TZ_OFFSET_SEC);
+}
+
+float WateringSys::zoneMoisture(uint8_t zone) const {
+    uint8_t probe = this->config.zones[zone].probe;
+    // NaN while the probe is quarantined
+#if SOIL_MUX_ENABLE
+    if (probe > 0) return this->_sample.probes[probe - 1];
+#endif
+    (void) probe;
+    return this->_sample.soil;
+}
+
 bool WateringSys::wateringProcess() const {
     int _countRelayOn = 0;
     // read relay state on or off
@@ -23,104 +23,170 @@
 void WebServerClass::RoutesSystem() {
     // If page not found
     this->serverAsync.onNotFound(
-        std::bind(
-            &WebServerClass::handleNotFound, this,
-            std::placeholders::_1
+        this->metered("(not found)",
+            std::bind(
+                &WebServerClass::handleNotFound, this,
+                std::placeholders::_1
+            )
         )
     );
 
     // Setup HTTP GET endpoint for index page
     this->serverAsync.on("/", HTTP_GET,
-        std::bind(
-            &WebServerClass::index, this,
-            std::placeholders::_1
+        this->metered("/",
+            std::bind(
+                &WebServerClass::index, this,
+                std::placeholders::_1
+            )
         )
     );
 
     this->serverAsync.on("/index", HTTP_GET,
-        std::bind(
-            &WebServerClass::index, this,
-            std::placeholders::_1
+        this->metered("/index",
+            std::bind(
+                &WebServerClass::index, this,
+                std::placeholders::_1
+            )
         )
     );
 
     // Setup HTTP Get endpoint for rest-api data-server
+    // Snapshot cache counters of /data-server and the sampling rates (registered first: "/data-server" matches by prefix)
+    this->serverAsync.on("/data-server-stats", HTTP_GET,
+        this->metered("/data-server-stats",
+            std::bind(
+                &WebServerClass::DataServerStats, this,
+                std::placeholders::_1
+            )
+        )
+    );
+
     this->serverAsync.on("/data-server", HTTP_GET, 
-        std::bind(
-            &WebServerClass::DataWebServer, this,
-            std::placeholders::_1
+        this->metered("/data-server",
+            std::bind(
+                &WebServerClass::DataWebServer, this,
+                std::placeholders::_1
+            )
         )
     );
     
+    // /ws upgrades refused by the admission filter of the WebSocket handler
+    this->serverAsync.on("/ws", HTTP_GET,
+        this->metered("/ws",
+            std::bind(
+                &WebServerClass::WsRefused, this,
+                std::placeholders::_1
+            )
+        )
+    );
+
+    // Request metrics of these routes, heap and WebSocket gauges (Prometheus text format)
+    this->serverAsync.on("/metrics", HTTP_GET,
+        this->metered("/metrics",
+            std::bind(
+                &WebServerClass::Metrics, this,
+                std::placeholders::_1
+            )
+        )
+    );
+
     // Setup HTTP GET endpoint for recovery page
     this->serverAsync.on("/recovery", HTTP_GET, 
-        std::bind(
-            &WebServerClass::RecoveryPage, this,
-            std::placeholders::_1
+        this->metered("/recovery",
+            std::bind(
+                &WebServerClass::RecoveryPage, this,
+                std::placeholders::_1
+            )
         )
     );
 
     // Setup HTTP GET endpoint for enable blynk
     this->serverAsync.on("/enable-blynk", HTTP_GET,
-        std::bind(
-            &WebServerClass::EnableBlynk, this,
-            std::placeholders::_1
+        this->metered("/enable-blynk",
+            std::bind(
+                &WebServerClass::EnableBlynk, this,
+                std::placeholders::_1
+            )
         )
     );
 
     // Setup HTTP GET endpoint to reboot the system
     this->serverAsync.on("/rst-webserver", HTTP_GET,
-        std::bind(
-            &WebServerClass::RebootSys, this,
-            std::placeholders::_1
+        this->metered("/rst-webserver",
+            std::bind(
+                &WebServerClass::RebootSys, this,
+                std::placeholders::_1
+            )
         )
     );
 
     // Setup HTTP GET endpoint to reset system
     this->serverAsync.on("/reset-system", HTTP_GET,
-        std::bind(
-            &WebServerClass::ResetSys, this,
-            std::placeholders::_1
+        this->metered("/reset-system",
+            std::bind(
+                &WebServerClass::ResetSys, this,
+                std::placeholders::_1
+            )
         )
     );
 
     // Setup HTTP GET endpoint to config wifi sta
     this->serverAsync.on("/config-wifi-sta", HTTP_GET,
-        std::bind(
-            &WebServerClass::WiFi_STA_Config_Main, this,
-            std::placeholders::_1
+        this->metered("/config-wifi-sta",
+            std::bind(
+                &WebServerClass::WiFi_STA_Config_Main, this,
+                std::placeholders::_1
+            )
         )
     );
 
     // Setup HTTP GET endpoint to save config wifi sta
     this->serverAsync.on("/save-config-wifi-sta", HTTP_POST,
-        std::bind(
-            &WebServerClass::Save_WiFi_STA_Config, this,
-            std::placeholders::_1
+        this->metered("/save-config-wifi-sta",
+            std::bind(
+                &WebServerClass::Save_WiFi_STA_Config, this,
+                std::placeholders::_1
+            )
         )
     );
 
     // Setup HTTP GET endpoint to config wifi ap
     this->serverAsync.on("/config-wifi-ap", HTTP_GET,
-        std::bind(
-            &WebServerClass::WiFi_AP_Config_Main, this,
-            std::placeholders::_1
+        this->metered("/config-wifi-ap",
+            std::bind(
+                &WebServerClass::WiFi_AP_Config_Main, this,
+                std::placeholders::_1
+            )
         )
     );
 
     // Setup HTTP GET endpoint to save config wifi ap
     this->serverAsync.on("/save-config-wifi-ap", HTTP_POST,
-        std::bind(
-            &WebServerClass::Save_WiFi_AP_Config, this,
-            std::placeholders::_1
+        this->metered("/save-config-wifi-ap",
+            std::bind(
+                &WebServerClass::Save_WiFi_AP_Config, this,
+                std::placeholders::_1
+            )
+        )
+    );
+
+    // Soil probe calibration: GET queries, POST captures or resets
+    this->serverAsync.on("/calibrate", HTTP_GET | HTTP_POST,
+        this->metered("/calibrate",
+            std::bind(
+                &WebServerClass::Calibrate, this,
+                std::placeholders::_1
+            )
         )
     );
 
     // Update auto change state WiFi mode
     this->serverAsync.on("/auto-change-wifi-mode", HTTP_GET,
-        std::bind(
-            &WebServerClass::UpdateAutoChangeWiFi, this,
-            std::placeholders::_1
+        this->metered("/auto-change-wifi-mode",
+            std::bind(
+                &WebServerClass::UpdateAutoChangeWiFi, this,
+                std::placeholders::_1
+            )
         )
     );
 }
@@ -128,49 +194,125 @@ void WebServerClass::RoutesSystem() {
 void WebServerClass::RoutesRelay() {
     // update relay state (post method)
     this->serverAsync.on("/post-relay", HTTP_POST, [](AsyncWebServerRequest *req) {}, NULL,
+        this->meteredBody("/post-relay",
+            std::bind(
+                &WebServerClass::postRelay, this,
+                std::placeholders::_1,
+                std::placeholders::_2,
+                std::placeholders::_3,
+                std::placeholders::_4,
+                std::placeholders::_5
+            )
+        )
+    );
+
+    // several relay/config operations in one request, one write per config file
+    this->serverAsync.on("/api/v1/batch", HTTP_POST,
         std::bind(
-            &WebServerClass::postRelay, this,
-            std::placeholders::_1,
-            std::placeholders::_2,
-            std::placeholders::_3,
-            std::placeholders::_4,
-            std::placeholders::_5
+            &WebServerClass::BatchRequest, this,
+            std::placeholders::_1
+        ),
+        NULL,
+        this->meteredBody("/api/v1/batch",
+            std::bind(
+                &WebServerClass::Batch, this,
+                std::placeholders::_1,
+                std::placeholders::_2,
+                std::placeholders::_3,
+                std::placeholders::_4,
+                std::placeholders::_5
+            )
         )
     );
 
     // query data relay (return format json)
     this->serverAsync.on("/query-relay", HTTP_GET,
-        std::bind(
-            &WebServerClass::queryDataRelay, this, std::placeholders::_1
+        this->metered("/query-relay",
+            std::bind(
+                &WebServerClass::queryDataRelay, this, std::placeholders::_1
+            )
         )
     );
 
     // getRelayState
     this->serverAsync.on("/getRelayStatus", HTTP_GET,
-        std::bind(
-            &WebServerClass::readRelayState, this,
-            std::placeholders::_1
+        this->metered("/getRelayStatus",
+            std::bind(
+                &WebServerClass::readRelayState, this,
+                std::placeholders::_1
+            )
         )
     );
 
     // update relay state (get method)
     this->serverAsync.on("/check", HTTP_GET,
-        std::bind(
-            &WebServerClass::checkRelayState, this, std::placeholders::_1
+        this->metered("/check",
+            std::bind(
+                &WebServerClass::checkRelayState, this, std::placeholders::_1
+            )
         )
     );
 
     // update auto watering
     this->serverAsync.on("/auto-watering", HTTP_GET,
-        std::bind(
-            &WebServerClass::AutoWatering, this, std::placeholders::_1
+        this->metered("/auto-watering",
+            std::bind(
+                &WebServerClass::AutoWatering, this, std::placeholders::_1
+            )
         )
     );
 
     // update manual watering
     this->serverAsync.on("/manual-watering", HTTP_GET,
-        std::bind(
-            &WebServerClass::ManualWatering, this, std::placeholders::_1
+        this->metered("/manual-watering",
+            std::bind(
+                &WebServerClass::ManualWatering, this, std::placeholders::_1
+            )
+        )
+    );
+
+    // watering controller mode and zone settings
+    this->serverAsync.on("/watering-zones", HTTP_GET,
+        this->metered("/watering-zones",
+            std::bind(
+                &WebServerClass::WateringZones, this, std::placeholders::_1
+            )
+        )
+    );
+
+    // cron-style watering schedules
+    this->serverAsync.on("/schedules", HTTP_GET,
+        this->metered("/schedules",
+            std::bind(
+                &WebServerClass::Schedules, this, std::placeholders::_1
+            )
+        )
+    );
+
+    // user watering rules
+    this->serverAsync.on("/rules", HTTP_GET,
+        this->metered("/rules",
+            std::bind(
+                &WebServerClass::Rules, this, std::placeholders::_1
+            )
+        )
+    );
+
+    // recorded watering sessions and efficiency
+    this->serverAsync.on("/sessions", HTTP_GET,
+        this->metered("/sessions",
+            std::bind(
+                &WebServerClass::Sessions, this, std::placeholders::_1
+            )
+        )
+    );
+
+    // flow meters and flow faults
+    this->serverAsync.on("/flow", HTTP_GET,
+        this->metered("/flow",
+            std::bind(
+                &WebServerClass::Flow, this, std::placeholders::_1
+            )
         )
     );
 }
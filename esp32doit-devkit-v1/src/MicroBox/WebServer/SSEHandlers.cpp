@@ -0,0 +1,187 @@
+/**
+ *  @file SSEHandlers.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "MicroBox/software/WebServer"
+
+/**
+ * @brief A client connected to /events.
+ * @details
+ * Events:
+ *   "state" : the whole dashboard state, as GET /data-server; first event of a new stream
+ *   "delta" : what changed, as the /ws deltas; id = sequence number
+ * A browser that reconnects sends Last-Event-ID: when the events after it are
+ * still in the replay buffer it gets only those, otherwise a new "state".
+ */
+void WebServerClass::sseConnect(AsyncEventSourceClient *client) {
+    std::lock_guard<std::recursive_mutex> lock(this->sseLock);
+
+    SseSlot *slot = nullptr;
+    for (auto &item : this->sseSlots) {
+        if (item.client == nullptr) {
+            slot = &item;
+            break;
+        }
+    }
+    if (slot == nullptr) {
+        this->sseCounters.rejected++;
+        client->close();
+        return;
+    }
+    *slot = SseSlot();
+    slot->client = client;
+    this->sseClients++;
+
+    this->sseAttach(client);
+
+    uint32_t lastId = client->lastId();
+    if (lastId > 0 && lastId <= this->sseSeq && lastId + 1 >= this->sseOldest) {
+        slot->lastId = lastId;
+        this->sseCounters.resumed++;
+        this->sseDrain(*slot);
+        return;
+    }
+
+    std::shared_ptr<const WireBuffer> data = this->dataSnapshot(WIRE_JSON);
+    String state;
+    state.concat((const char *) data->data(), data->size());
+    slot->lastId = this->sseSeq;
+    this->sseSend(*slot, state.c_str(), "state", this->sseSeq, SSE_RETRY_MS);
+}
+
+/**
+ * @brief Queue the events from the async_tcp task, which owns the stream's message queue.
+ * @details
+ * The library changes that queue on every ack and poll, without a lock, so
+ * the web task never calls into a stream. ESPAsyncWebServer 1.2.3 (the bundled
+ * ../Library/ESPAsyncWebServer.zip) has no hook for that, nor a callback when
+ * it frees a stream: the ack, poll and disconnect handlers installed by the
+ * AsyncEventSourceClient constructor are replaced by the same calls plus
+ * sseDrain() and sseDisconnect(). Check them against that constructor when the
+ * library is updated.
+ * An event reaches a stream on its next ack, or within one poll (about 500 ms).
+ */
+void WebServerClass::sseAttach(AsyncEventSourceClient *client) {
+    client->client()->onAck([this](void *arg, AsyncClient *, size_t len, uint32_t time) {
+        AsyncEventSourceClient *stream = (AsyncEventSourceClient *) arg;
+        stream->_onAck(len, time);
+        this->sseDeliver(stream);
+    }, client);
+    client->client()->onPoll([this](void *arg, AsyncClient *) {
+        AsyncEventSourceClient *stream = (AsyncEventSourceClient *) arg;
+        stream->_onPoll();
+        this->sseDeliver(stream);
+    }, client);
+    // Frees the slot before the library frees the client
+    client->client()->onDisconnect([this](void *arg, AsyncClient *tcp) {
+        AsyncEventSourceClient *stream = (AsyncEventSourceClient *) arg;
+        this->sseDisconnect(stream);
+        stream->_onDisconnect();
+        delete tcp;
+    }, client);
+}
+
+void WebServerClass::sseDeliver(AsyncEventSourceClient *client) {
+    std::lock_guard<std::recursive_mutex> lock(this->sseLock);
+    for (auto &slot : this->sseSlots) {
+        if (slot.client != client) continue;
+        // May close the stream: the disconnect handler frees it, so nothing touches it after this
+        this->sseDrain(slot);
+        return;
+    }
+}
+
+void WebServerClass::sseDisconnect(AsyncEventSourceClient *client) {
+    std::lock_guard<std::recursive_mutex> lock(this->sseLock);
+    for (auto &slot : this->sseSlots) {
+        if (slot.client != client) continue;
+        slot.client = nullptr;
+        this->sseClients--;
+    }
+}
+
+void WebServerClass::ssePublish(const JsonDocument &doc) {
+    String data;
+    serializeJson(doc, data);
+
+    std::lock_guard<std::recursive_mutex> lock(this->sseLock);
+    uint32_t id = ++this->sseSeq;
+    SseEvent &event = this->sseReplay[id % SSE_REPLAY];
+    event.id = id;
+    event.data = data;
+    if (id >= SSE_REPLAY && this->sseOldest < id - SSE_REPLAY + 1)
+        this->sseOldest = id - SSE_REPLAY + 1;
+}
+
+void WebServerClass::sseForget() {
+    std::lock_guard<std::recursive_mutex> lock(this->sseLock);
+    // Skip one id: a stream that stopped at the last one cannot resume across the gap
+    this->sseSeq++;
+    this->sseOldest = this->sseSeq + 1;
+}
+
+bool WebServerClass::sseDrain(SseSlot &slot) {
+    while (slot.client != nullptr && slot.lastId < this->sseSeq) {
+        uint32_t id = slot.lastId + 1;
+        const SseEvent &event = this->sseReplay[id % SSE_REPLAY];
+        if (id < this->sseOldest || event.id != id) {
+            // What it missed is gone: the browser reconnects and gets a new "state"
+            // (the disconnect handler frees the slot)
+            this->sseCounters.expired++;
+            slot.client->close();
+            return false;
+        }
+        if (!this->sseSend(slot, event.data.c_str(), "delta", id)) break;
+    }
+    return true;
+}
+
+size_t WebServerClass::sseQueued(const SseSlot &slot) {
+    // The library queue is in sending order: its `waiting` events are the last ones queued here
+    size_t waiting = min<size_t>(slot.client->packetsWaiting(), SSE_CLIENT_MAX_EVENTS);
+    size_t bytes = 0;
+    for (size_t i = 0; i < waiting; i++)
+        bytes += slot.sent[(slot.head + SSE_CLIENT_MAX_EVENTS - i) % SSE_CLIENT_MAX_EVENTS];
+    return bytes;
+}
+
+/**
+ * @brief Queue one event unless the connection is at its memory cap.
+ * @return false when it was held back (it is queued by a later drain).
+ */
+bool WebServerClass::sseSend(SseSlot &slot, const char *data, const char *event, uint32_t id, uint32_t retry) {
+    // Length of the text the library builds and keeps until the client acknowledges it:
+    // [retry: <ms>\r\n] [id: <n>\r\n] event: <name>\r\n data: <json>\r\n\r\n
+    size_t frame = 7 + strlen(event) + 2 + 6 + strlen(data) + 4;
+    if (id) frame += 4 + String(id).length() + 2;
+    if (retry) frame += 7 + String(retry).length() + 2;
+
+    // An empty queue always takes one event, however large
+    size_t waiting = slot.client->packetsWaiting();
+    if (waiting > 0 && (waiting >= SSE_CLIENT_MAX_EVENTS || this->sseQueued(slot) + frame > SSE_CLIENT_MAX_BYTES)) {
+        this->sseCounters.deferred++;
+        return false;
+    }
+
+    slot.client->send(data, event, id, retry);
+    slot.head = (slot.head + 1) % SSE_CLIENT_MAX_EVENTS;
+    slot.sent[slot.head] = frame;
+    slot.lastId = id;
+    return true;
+}
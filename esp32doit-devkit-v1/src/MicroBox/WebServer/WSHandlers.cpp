@@ -41,9 +41,13 @@ void WebServerClass::onEvent(
     if (type == WS_EVT_DATA) {
         AwsFrameInfo *info = (AwsFrameInfo *)arg;
 
-        // Validate the data length and ensure it's a text frame
+        // Over its rate: dropped before anything is copied or parsed
+        if (!this->admitMessage(client)) return;
+
+        // Validate the data length and ensure it's a complete text (JSON) or binary (MessagePack) frame
         constexpr size_t MAX_MESSAGE_SIZE = 512;
-        if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT)
+        if (info->final && info->index == 0 && info->len == len
+            && (info->opcode == WS_TEXT || info->opcode == WS_BINARY))
         {
             if (len > MAX_MESSAGE_SIZE) {
                 Serial.println(F("WebSocket message too large, ignoring..."));
@@ -55,9 +59,11 @@ void WebServerClass::onEvent(
             memcpy(message, data, len);
             message[len] = '\0';
 
-            // Deserialize JSON from the received message
+            // Deserialize the received message
             StaticJsonDocument<300> doc;
-            DeserializationError error = deserializeJson(doc, message);
+            DeserializationError error = info->opcode == WS_BINARY
+                ? deserializeMsgPack(doc, (const uint8_t *) message, len)
+                : deserializeJson(doc, message);
             if (error) {
                 Serial.printf("JSON parse error: %s", error.c_str());
                 return;
@@ -65,14 +71,57 @@ void WebServerClass::onEvent(
 
             // Handle WebSocket events based on the "event" key in the JSON
             const char *event = doc["event"];
+            if (event == nullptr) {
+                return;
+            }
             if (strcmp(event, "data_server") == 0) {
                 this->handleDataServeWS(client); // Handle "data_server" event
             }
+            else if (strcmp(event, "subscribe") == 0) {
+                // Full snapshot first, then deltas from pushState()
+                if (this->subscribe(client->id()))
+                    this->handleDataServeWS(client);
+                else
+                    this->sendAck(client, event, 503, "Too many dashboards");
+            }
+            else if (strcmp(event, "unsubscribe") == 0) {
+                this->unsubscribe(client->id());
+            }
             else if (strcmp(event, "toggle_check") == 0) {
-                // Add logic for the "toggle_check" event here
+                this->handleToggleCheck(client, doc);
             }
             else if (strcmp(event, "relay_handler") == 0) {
-                // Add logic for the "relay_handler" event here
+                this->handleRelayWS(client, doc);
+            }
+            else if (strcmp(event, "auto_watering") == 0) {
+                this->handleWateringWS(client, doc, false);
+            }
+            else if (strcmp(event, "manual_watering") == 0) {
+                this->handleWateringWS(client, doc, true);
+            }
+        }
+    }
+    else if (type == WS_EVT_CONNECT) {
+        // Full bucket for the new client
+        for (auto &quota : this->wsQuota) {
+            if (quota.id != 0) continue;
+            quota.id = client->id();
+            quota.tokens = WS_RATE_BURST * 1000;
+            quota.refilled = millis();
+            quota.limited = false;
+            break;
+        }
+        // Idle clients are pinged: a dead link then times out and is closed
+        client->keepAlivePeriod(WS_KEEPALIVE_S);
+        this->wsAttach(client);
+
+        // arg: the upgrade request; the library echoes the offered subprotocol
+        AsyncWebServerRequest *req = (AsyncWebServerRequest *) arg;
+        if (req != nullptr && req->hasHeader("Sec-WebSocket-Protocol")
+            && req->header("Sec-WebSocket-Protocol") == WS_PROTOCOL_MSGPACK) {
+            for (auto &slot : this->wsMsgPack) {
+                uint32_t free = 0;
+                if (slot.compare_exchange_strong(free, client->id())) break;
             }
         }
     }
@@ -85,7 +134,168 @@ void WebServerClass::onEvent(
         // Log WebSocket client disconnection
         Serial.print(F("WebSocket disconnected: "));
         Serial.println(client->id());
+        this->unsubscribe(client->id());
+        for (auto &slot : this->wsMsgPack) {
+            uint32_t current = client->id();
+            slot.compare_exchange_strong(current, 0);
+        }
+        for (auto &quota : this->wsQuota)
+            if (quota.id == client->id()) quota.id = 0;
+    }
+}
+
+WireFormat WebServerClass::wsFormat(uint32_t id) {
+    for (const auto &slot : this->wsMsgPack)
+        if (slot.load() == id) return WIRE_MSGPACK;
+    return WIRE_JSON;
+}
+
+void WebServerClass::sendWire(AsyncWebSocketClient *client, const JsonDocument &doc) {
+    // Queue full: the library would drop it anyway, after the copy
+    if (!client->canSend()) {
+        this->wsCounters.dropped++;
+        return;
+    }
+    WireFormat format = this->wsFormat(client->id());
+    std::shared_ptr<const WireBuffer> data = serializeWire(doc, format);
+    if (format == WIRE_MSGPACK)
+        client->binary((const char *) data->data(), data->size());
+    else
+        client->text((const char *) data->data(), data->size());
+}
+
+bool WebServerClass::subscribe(uint32_t id) {
+    int found = -1;
+    for (size_t s = 0; s < WS_MAX_CLIENTS && found < 0; s++)
+        if (this->wsSubscribers[s].load() == id) found = s;
+    for (size_t s = 0; s < WS_MAX_CLIENTS && found < 0; s++) {
+        uint32_t free = 0;
+        if (this->wsSubscribers[s].compare_exchange_strong(free, id)) found = s;
     }
+    if (found < 0) return false;
+
+    // The snapshot sent next holds the current state: it gets the deltas published after it
+    WsLag &lag = this->wsLag[found];
+    lag.id = id;
+    lag.since = 0;
+    std::lock_guard<std::mutex> lock(this->wsLock);
+    lag.seq = this->pushSeq;
+    return true;
+}
+
+void WebServerClass::unsubscribe(uint32_t id) {
+    for (auto &slot : this->wsSubscribers) {
+        uint32_t current = id;
+        slot.compare_exchange_strong(current, 0);
+    }
+}
+
+/**
+ * @brief Token bucket of the client: WS_RATE_BURST messages at once, WS_RATE_PER_SEC after that.
+ * @details A client without a bucket (none was free when it connected) is not limited.
+ */
+bool WebServerClass::admitMessage(AsyncWebSocketClient *client) {
+    for (auto &quota : this->wsQuota) {
+        if (quota.id != client->id()) continue;
+
+        // Tokens are counted in 1/1000 message: WS_RATE_PER_SEC per second is that many per millisecond
+        // (the wait is capped at the time to fill the bucket, so the product cannot overflow)
+        uint32_t now = millis();
+        uint32_t elapsed = min<uint32_t>(now - quota.refilled, WS_RATE_BURST * 1000 / WS_RATE_PER_SEC);
+        quota.tokens = min<uint32_t>(quota.tokens + elapsed * WS_RATE_PER_SEC, WS_RATE_BURST * 1000);
+        quota.refilled = now;
+
+        if (quota.tokens >= 1000) {
+            quota.tokens -= 1000;
+            quota.limited = false;
+            return true;
+        }
+
+        this->wsCounters.rateLimited++;
+        if (!quota.limited) {
+            // Told once per burst, so that the replies are not a second flood
+            quota.limited = true;
+            this->sendAck(client, "rate_limit", 429, "Too many messages");
+        }
+        return false;
+    }
+    return true;
+}
+
+void WebServerClass::WsRefused(AsyncWebServerRequest *req) {
+    if (req->requestedConnType() != RCT_WS) {
+        this->handleNotFound(req);
+        return;
+    }
+
+    String content = "{\"status\":503,\"msg\":\"Too many WebSocket clients\"}";
+    AsyncWebServerResponse *res = req->beginResponse(503, APPJSON, content);
+    res->addHeader("Retry-After", String(WS_RETRY_AFTER_S));
+    this->wsCounters.rejected++;
+    this->served(503, content.length());
+    req->send(res);
+}
+
+/**
+ * @brief Reply to a WebSocket command.
+ * @details `{"event":"ack","cmd":<event>,"status":<code>,"msg":<msg>}`; the
+ * new relay/watering state itself reaches every dashboard with the next delta.
+ */
+void WebServerClass::sendAck(AsyncWebSocketClient *client, const char *event, int status, const String &msg) {
+    StaticJsonDocument<128> doc;
+
+    doc["event"]  = "ack";
+    doc["cmd"]    = event;
+    doc["status"] = status;
+    doc["msg"]    = msg;
+    this->sendWire(client, doc);
+}
+
+// {"event":"toggle_check","pinout":<pin>,"state":0|1}, same as GET /check
+void WebServerClass::handleToggleCheck(AsyncWebSocketClient *client, JsonDocument &doc) {
+    String msg = "";
+    int status = 400;
+
+    if (doc.containsKey("pinout") && doc.containsKey("state"))
+        status = this->commandRelay(doc["pinout"].as<int>(), doc["state"].as<int>(), msg);
+    else
+        msg = "Missing parameters";
+
+    this->sendAck(client, "toggle_check", status, msg);
+}
+
+// {"event":"relay_handler","relay<pin>":true|false,...}, same as POST /relay
+void WebServerClass::handleRelayWS(AsyncWebSocketClient *client, JsonDocument &doc) {
+    String msg = "";
+    int status = 400;
+
+    for (const auto &item : RELAY_PINS) {
+        String varName = String(VAR_SWITCH) + String(item);
+        if (doc.containsKey(varName)) {
+            status = this->commandRelay(item, doc[varName].as<bool>(), msg);
+            if (status != 200) break;
+        }
+    }
+    if (msg.length() == 0) msg = "No relay in the message";
+
+    this->sendAck(client, "relay_handler", status, msg);
+}
+
+// {"event":"auto_watering"|"manual_watering","state":0|1}
+void WebServerClass::handleWateringWS(AsyncWebSocketClient *client, JsonDocument &doc, bool manual) {
+    const char *event = manual ? "manual_watering" : "auto_watering";
+    String msg = "";
+    int status = 400;
+
+    if (doc.containsKey("state")) {
+        bool state = doc["state"].as<int>();
+        status = manual
+            ? this->commandManualWatering(state, msg)
+            : this->commandAutoWatering(state, msg);
+    }
+    else msg = "Missing parameters";
+
+    this->sendAck(client, event, status, msg);
 }
 
 /**
@@ -0,0 +1,210 @@
+/**
+ *  @file WSPush.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "MicroBox/software/WebServer"
+#include "MicroBox/hardware/RelayController"
+#include "MicroBox/externobj"
+
+/**
+ * @brief Publish the dashboard state that changed for the subscribed clients.
+ * @details
+ * A delta has the layout of the "data_server" snapshot with only the changed
+ * members, so the page merges it into the state it has:
+ * `{"event":"delta","seq":n,"data_server":{...},"data_relay":{...}}`.
+ * Nothing is built while the state is unchanged. The delta goes to the
+ * replay buffer in both wire formats; wsDeliver() queues it to the clients.
+ */
+void WebServerClass::pushState() {
+    bool subscribed = this->sseClients.load() > 0;
+    for (const auto &slot : this->wsSubscribers)
+        if (slot.load() != 0) subscribed = true;
+    if (!subscribed) {
+        // No delta is built from here: the /events replay buffer cannot bridge the gap
+        if (this->pushed.valid) this->sseForget();
+        this->pushed.valid = false;
+        return;
+    }
+
+    StaticJsonDocument<512> doc;
+    JsonObject data = doc.createNestedObject("data_server");
+    JsonObject relay = doc.createNestedObject("data_relay");
+    bool all = !this->pushed.valid;
+    bool changed = false;
+
+    // Sensor values (compared at the precision they are shown) and their faults
+    size_t i = 0;
+    sensors.forEach([&](auto &ch) {
+        using T = std::decay_t<decltype(ch)>;
+        double scale = pow(10.0, T::DECIMALS);
+        float value = round(ch.value() * scale) / scale;
+        uint8_t fault = ch.health.fault();
+
+        if (all || value != this->pushed.value[i]) {
+            ch.toJson(data);
+            this->pushed.value[i] = value;
+            changed = true;
+        }
+        if (all || fault != this->pushed.fault[i]) {
+            data["sensor_health"][T::KEY]["fault"] = SensorHealth::faultText((SensorFault) fault);
+            this->pushed.fault[i] = fault;
+            changed = true;
+        }
+        i++;
+    });
+
+    bool watering = wateringSys.WateringProcess;
+    if (all || watering != this->pushed.watering) {
+        data["watering_state"] = watering;
+        this->pushed.watering = watering;
+        changed = true;
+    }
+
+    bool autoWatering = wateringSys.AutoWateringState;
+    if (all || autoWatering != this->pushed.autoWatering) {
+        relay["auto"]["id"] = "auto";
+        relay["auto"]["status"] = autoWatering;
+        this->pushed.autoWatering = autoWatering;
+        changed = true;
+    }
+
+    uint8_t relays = 0;
+    for (size_t r = 0; r < WATERING_ZONES; r++) {
+        uint8_t status = RelayController::RELAY_STATE_STR_INT(digitalRead(RELAY_PINS[r]));
+        relays |= status << r;
+        if (all || ((this->pushed.relays >> r) & 1) != status) {
+            JsonObject item = relay.createNestedObject(String(VAR_SWITCH) + String(RELAY_PINS[r]));
+            item["id"] = RELAY_PINS[r];
+            item["status"] = status;
+            changed = true;
+        }
+    }
+    this->pushed.relays = relays;
+    this->pushed.valid = true;
+
+    if (!changed) return;
+    if (data.size() == 0) doc.remove("data_server");
+    if (relay.size() == 0) doc.remove("data_relay");
+
+    doc["event"] = "delta";
+    doc["seq"] = this->pushSeq + 1;
+
+    // Replay buffer and /events streams
+    this->ssePublish(doc);
+
+    // /ws replay buffer, one buffer per wire format shared by every subscriber of that format
+    std::shared_ptr<const WireBuffer> json = serializeWire(doc, WIRE_JSON);
+    std::shared_ptr<const WireBuffer> msgpack = serializeWire(doc, WIRE_MSGPACK);
+    std::lock_guard<std::mutex> lock(this->wsLock);
+    WsEvent &event = this->wsReplay[(this->pushSeq + 1) % WS_REPLAY];
+    event.seq = ++this->pushSeq;
+    event.data[WIRE_JSON] = json;
+    event.data[WIRE_MSGPACK] = msgpack;
+}
+
+/**
+ * @brief Deliver from the async_tcp task, which owns the client list and the message queues.
+ * @details
+ * The library changes them on every ack, poll and disconnect, without a lock,
+ * so the web task never calls into `ws`. ESPAsyncWebServer 1.2.3 (the bundled
+ * ../Library/ESPAsyncWebServer.zip) has no hook to run code in that task: the
+ * ack and poll handlers installed by the AsyncWebSocketClient constructor are
+ * replaced by the same calls plus the delivery. Check them against that
+ * constructor when the library is updated.
+ * A delta reaches a client on its next ack, or within one poll (about 500 ms).
+ */
+void WebServerClass::wsAttach(AsyncWebSocketClient *client) {
+    client->client()->onAck([this](void *arg, AsyncClient *, size_t len, uint32_t time) {
+        AsyncWebSocketClient *socket = (AsyncWebSocketClient *) arg;
+        socket->_onAck(len, time);
+        this->wsDeliver(socket);
+    }, client);
+    client->client()->onPoll([this](void *arg, AsyncClient *) {
+        AsyncWebSocketClient *socket = (AsyncWebSocketClient *) arg;
+        socket->_onPoll();
+        this->wsDeliver(socket);
+        this->wsMaintain();
+    }, client);
+}
+
+void WebServerClass::wsDeliver(AsyncWebSocketClient *client) {
+    if (client->status() != WS_CONNECTED) return;
+    WsLag *lag = nullptr;
+    for (size_t s = 0; s < WS_MAX_CLIENTS; s++)
+        if (this->wsSubscribers[s].load() == client->id() && this->wsLag[s].id == client->id())
+            lag = &this->wsLag[s];
+    if (lag == nullptr) return;
+
+    WireFormat format = this->wsFormat(client->id());
+    while (true) {
+        std::shared_ptr<const WireBuffer> data;
+        uint32_t latest;
+        {
+            std::lock_guard<std::mutex> lock(this->wsLock);
+            latest = this->pushSeq;
+            const WsEvent &event = this->wsReplay[(lag->seq + 1) % WS_REPLAY];
+            if (event.seq == lag->seq + 1) data = event.data[format];
+        }
+        if (lag->seq >= latest) {
+            lag->since = 0;
+            return;
+        }
+
+        // Queue full: nothing more is queued for it, wsMaintain() closes it after WS_STALL_MS
+        if (!client->canSend()) {
+            if (lag->since == 0) lag->since = millis() ? millis() : 1;
+            return;
+        }
+
+        if (data == nullptr) {
+            // What it missed left the replay buffer: the full state replaces those deltas
+            this->wsCounters.coalesced += latest - lag->seq;
+            lag->seq = latest;
+            this->handleDataServeWS(client);
+            continue;
+        }
+        if (format == WIRE_MSGPACK)
+            client->binary((const char *) data->data(), data->size());
+        else
+            client->text((const char *) data->data(), data->size());
+        lag->seq++;
+    }
+}
+
+void WebServerClass::wsMaintain() {
+    uint32_t now = millis();
+    if (now - this->wsCleanedAt < WS_CLEANUP_MS) return;
+    this->wsCleanedAt = now;
+
+    for (auto &lag : this->wsLag) {
+        if (lag.since == 0 || now - lag.since < WS_STALL_MS) continue;
+        AsyncWebSocketClient *client = this->ws.client(lag.id);
+        if (client != nullptr) {
+            Serial.printf("WebSocket %u backlogged for %u ms, closing\n",
+                (unsigned) lag.id, (unsigned) (now - lag.since));
+            client->close();
+            this->wsCounters.evicted++;
+        }
+        lag.since = 0;
+    }
+
+    // Closes the oldest client while more than WS_MAX_CLIENTS are connected
+    if (this->ws.count() > WS_MAX_CLIENTS) this->wsCounters.cleaned++;
+    this->ws.cleanupClients(WS_MAX_CLIENTS);
+}
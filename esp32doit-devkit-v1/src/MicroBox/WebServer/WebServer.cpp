@@ -31,6 +31,11 @@ void WebServerClass::ServerInit() {
         return;
     }
 
+#if WEB_STORE_FLASH
+    // Map the web UI image; LittleFS keeps serving the pages when there is none
+    this->store.begin();
+#endif
+
     // Initialize ElegantOTA for over-the-air update
     ElegantOTA.begin(&this->serverAsync);
 
@@ -45,9 +50,21 @@ void WebServerClass::ServerInit() {
         std::placeholders::_6
     ));
 
+    // Admission: upgrades over WS_MAX_CLIENTS skip the handler and reach WsRefused (503)
+    this->ws.setFilter([this](AsyncWebServerRequest *) {
+        return this->ws.count() < WS_MAX_CLIENTS;
+    });
+
     // add Handler WebSocket on serverAsync
     this->serverAsync.addHandler(&this->ws);
 
+    // Server-Sent Events: one-way telemetry for scripts and kiosk browsers
+    this->sse.onConnect(std::bind(
+        &WebServerClass::sseConnect, this,
+        std::placeholders::_1
+    ));
+    this->serverAsync.addHandler(&this->sse);
+
     // Serve CSS and JavaScript file
     this->run_css_js_webserver();
     
@@ -70,6 +87,20 @@ void WebServerClass::UpdateOTAloop() {
 }
 
 void WebServerClass::run_css_js_webserver() {
+    // Gzipped image: one route per asset, with ETag and Cache-Control
+    if (this->loadAssets()) {
+        for (const auto &asset : this->assets)
+            this->serverAsync.on(asset.url.c_str(), HTTP_GET,
+                std::bind(
+                    &WebServerClass::StaticAsset, this,
+                    std::placeholders::_1
+                )
+            );
+        Serial.printf("Serving %u gzipped assets\n", (unsigned) this->assets.size());
+        return;
+    }
+
+    // Plain image (built without compress_assets.py): serve the files as they are
     // Define lists of CSS and JavaScript files to serve
     const std::vector<String> list_css_files = {
         "recovery.css", "index.css", 
@@ -77,7 +108,7 @@ void WebServerClass::run_css_js_webserver() {
     };
 
     const std::vector<String> list_js_files = {
-        "clock.js", "data_server.js", "reboot.js",
+        "clock.js", "data_server.js", "msgpack.js", "reboot.js",
         "reset-sys.js", "sweetalert.min.js", "switchBlynk.js",
         "toggleCheck.js"
     };
@@ -97,6 +128,116 @@ void WebServerClass::run_css_js_webserver() {
         );
 }
 
+static String assetType(const String &path) {
+    if (path.endsWith(".css")) return "text/css";
+    if (path.endsWith(".js")) return "application/javascript";
+    return TEXTPLAIN;
+}
+
+bool WebServerClass::loadAssets() {
+    DynamicJsonDocument doc(3072);
+    DeserializationError error;
+    bool loaded = false;
+
+#if WEB_STORE_FLASH
+    const uint8_t *data;
+    size_t size;
+    if (this->store.ready() && this->store.find(this->ASSETS.c_str(), &data, &size)) {
+        error = deserializeJson(doc, (const char *) data, size);
+        loaded = true;
+    }
+#endif
+
+    if (!loaded) {
+        this->file = openfile(this->ASSETS, LFS_READ);
+        if (!this->file) return false;
+        error = deserializeJson(doc, this->file);
+        this->file.close();
+    }
+    if (error) {
+        Serial.printf("Asset manifest: %s\n", error.c_str());
+        return false;
+    }
+
+    this->assets.clear();
+    for (JsonObject item : doc.as<JsonArray>()) {
+        WebAsset asset;
+        asset.url  = item["url"]  | "";
+        asset.path = item["path"] | "";
+        asset.etag = "\"" + String(item["etag"] | "") + "\"";
+        if (asset.url != "" && asset.path != "")
+            this->assets.push_back(asset);
+    }
+    return !this->assets.empty();
+}
+
+void WebServerClass::StaticAsset(AsyncWebServerRequest *req) {
+    const WebAsset *asset = nullptr;
+    for (const auto &item : this->assets) {
+        if (item.url == req->url()) {
+            asset = &item;
+            break;
+        }
+    }
+
+    AsyncWebServerResponse *res = nullptr;
+    if (asset != nullptr) {
+        // If-None-Match may list several tags
+#if WEB_STORE_FLASH
+        const uint8_t *data;
+        size_t size;
+#endif
+        if (req->hasHeader("If-None-Match") && req->header("If-None-Match").indexOf(asset->etag) >= 0)
+            res = req->beginResponse(304);
+#if WEB_STORE_FLASH
+        else if (this->store.ready() && this->store.find((asset->path + ".gz").c_str(), &data, &size)) {
+            // Sent straight from the mapped flash: no file handle, no copy
+            res = req->beginResponse_P(200, assetType(asset->path), data, size);
+            res->addHeader("Content-Encoding", "gzip");
+        }
+#endif
+        else
+            // Only `path`.gz is on the image: the response adds Content-Encoding: gzip
+            res = req->beginResponse(LFS, asset->path);
+    }
+    if (res == nullptr) {
+        this->handleNotFound(req);
+        return;
+    }
+
+    res->addHeader("ETag", asset->etag);
+    res->addHeader("Cache-Control", WEB_ASSET_CACHE_CONTROL);
+    req->send(res);
+}
+
+bool WebServerClass::openPage(WebTemplate &page, const String &path) {
+#if WEB_STORE_FLASH
+    if (this->store.ready()) return page.open(this->store, path);
+#endif
+    return page.open(LFS, path);
+}
+
+void WebServerClass::sendTemplate(AsyncWebServerRequest *req, std::shared_ptr<WebTemplate> page) {
+    if (!page->compiled()) {
+        // Image built without compress_assets.py: let the library substitute %NAME% in the raw page
+        // (the substituted length is not known here: only the status is counted)
+        this->served(200, 0);
+        req->send(LFS, page->path(), TEXTHTML, false,
+            [page](const String &name) { return page->value(name); });
+        return;
+    }
+
+    // The filler owns the page: the file stays open until the last chunk or the client is gone
+    RouteMetrics *route = this->activeRoute;
+    this->served(200, 0);
+    req->sendChunked(TEXTHTML,
+        [page, route](uint8_t *buf, size_t maxLen, size_t) -> size_t {
+            size_t len = page->fill(buf, maxLen);
+            if (route != nullptr) route->bytes.fetch_add(len, std::memory_order_relaxed);
+            return len;
+        });
+}
+
 #if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_WebServer)
 /**
  * Create a global instance of WebServerClass
@@ -22,22 +22,6 @@
 #include "MicroBox/software/WebServer"
 #include "MicroBox/externobj"
 
-String WebServerClass::file_buffer(String fileName) {
-    this->file = openfile(fileName, LFS_READ);
-    if (!this->file) {
-        return "";
-    }
-
-    // read file content
-    size_t fileSize = this->file.size();
-    std::unique_ptr<char []> fileBuffer(new char[fileSize + 1]);
-    this->file.readBytes(fileBuffer.get(), fileSize);
-    fileBuffer[fileSize] = '\0';
-    this->file.close();
-
-    return String(fileBuffer.get());
-}
-
 void WebServerClass::RebootSys(AsyncWebServerRequest *req) {
     StaticJsonDocument<100> doc;
     String jsonRes = "";
@@ -47,7 +31,7 @@ void WebServerClass::RebootSys(AsyncWebServerRequest *req) {
     doc["msg"] = "Server has been restart";
 
     serializeJson(doc, jsonRes);
-    req->send_P(codeRes, APPJSON, jsonRes.c_str());
+    this->send(req, codeRes, APPJSON, jsonRes);
 
     __lastTimeReboot__ = millis();
     RebootState = true;
@@ -63,7 +47,7 @@ void WebServerClass::EnableBlynk(AsyncWebServerRequest *req) {
     doc["msg"] = "Enable Blynk, Server has been restart";
 
     serializeJson(doc, jsonRes);
-    req->send_P(codeRes, APPJSON, jsonRes.c_str());
+    this->send(req, codeRes, APPJSON, jsonRes);
 
     myeeprom_obj.save_wifi_state(true);
     delay(50);
@@ -92,7 +76,7 @@ void WebServerClass::UpdateAutoChangeWiFi(AsyncWebServerRequest *req) {
     doc["message"] = message;
     serializeJson(doc, jsonBuffer);
     
-    req->send_P(statusCode, APPJSON, jsonBuffer.c_str());
+    this->send(req, statusCode, APPJSON, jsonBuffer);
 }
 
 // page 404
@@ -114,7 +98,7 @@ void WebServerClass::handleNotFound(AsyncWebServerRequest *req) {
     }
 
     serializeJson(doc, jsonRes);
-    req->send_P(codeRes, APPJSON, jsonRes.c_str());
+    this->send(req, codeRes, APPJSON, jsonRes);
 }
 
 void WebServerClass::handleError_deserializeJson(
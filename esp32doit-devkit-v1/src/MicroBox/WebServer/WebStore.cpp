@@ -0,0 +1,81 @@
+/**
+ *  @file WebStore.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "MicroBox/software/WebStore"
+#include "variable"
+
+#if WEB_STORE_FLASH
+#include <esp_partition.h>
+#include <esp_idf_version.h>
+
+bool WebStore::begin() {
+    const esp_partition_t *part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t) WEB_STORE_SUBTYPE, WEB_STORE_PARTITION);
+    if (part == nullptr) {
+        Serial.println(F("WebStore: no webui partition"));
+        return false;
+    }
+
+    const void *map = nullptr;
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_partition_mmap_handle_t handle;
+    esp_err_t err = esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &map, &handle);
+#else
+    spi_flash_mmap_handle_t handle;
+    esp_err_t err = esp_partition_mmap(part, 0, part->size, SPI_FLASH_MMAP_DATA, &map, &handle);
+#endif
+    if (err != ESP_OK) {
+        Serial.printf("WebStore: mmap failed (%d)\n", err);
+        return false;
+    }
+
+    if (!this->begin((const uint8_t *) map, part->size)) {
+        Serial.println(F("WebStore: no web UI image, run `pio run -t uploadweb`"));
+#if ESP_IDF_VERSION_MAJOR >= 5
+        esp_partition_munmap(handle);
+#else
+        spi_flash_munmap(handle);
+#endif
+        return false;
+    }
+
+    this->_handle = handle;
+    Serial.printf("WebStore: %u files, %u bytes mapped\n", this->_count, ((const WebStoreHeader *) map)->size);
+    return true;
+}
+#else
+bool WebStore::begin() {
+    return false;
+}
+#endif
+
+bool WebStore::begin(const uint8_t *image, size_t size) {
+    if (size < sizeof(WebStoreHeader)) return false;
+    const WebStoreHeader *header = (const WebStoreHeader *) image;
+    uint32_t table = sizeof(WebStoreHeader) + header->count * sizeof(WebStoreEntry);
+    if (header->magic != WEB_STORE_MAGIC || header->version != WEB_STORE_VERSION
+        || header->size > size || table > header->size)
+        return false;
+
+    this->_base = image;
+    this->_entries = (const WebStoreEntry *) (image + sizeof(WebStoreHeader));
+    this->_count = header->count;
+    return true;
+}
@@ -0,0 +1,108 @@
+/**
+ *  @file WebTemplate.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "MicroBox/software/WebTemplate"
+#include "MicroBox/software/LFSMemory"
+
+static const char *const TEMPLATE_NAMES[TPL_COUNT] = {
+    #define X(name) #name,
+    WEB_TEMPLATE_VARS
+    #undef X
+};
+
+String WebTemplate::compiledPath(const String &path) {
+    String compiled = path;
+    if (compiled.endsWith(".html"))
+        compiled = compiled.substring(0, compiled.length() - 5);
+    return compiled + ".tpl";
+}
+
+bool WebTemplate::open(FS &fs, const String &path) {
+    this->_path = path;
+    this->_file = fs.open(compiledPath(path), LFS_READ);
+    this->_compiled = (bool) this->_file;
+    return this->_compiled || fs.exists(path);
+}
+
+bool WebTemplate::open(const WebStore &store, const String &path) {
+    this->_path = path;
+    this->_compiled = store.find(compiledPath(path).c_str(), &this->_mem, &this->_memSize);
+    return this->_compiled;
+}
+
+int WebTemplate::readByte() {
+    if (this->_mem == nullptr) return this->_file.read();
+    return this->_memAt < this->_memSize ? this->_mem[this->_memAt++] : -1;
+}
+
+size_t WebTemplate::readBytes(uint8_t *buf, size_t len) {
+    if (this->_mem == nullptr) return this->_file.read(buf, len);
+    len = min(len, this->_memSize - this->_memAt);
+    memcpy(buf, this->_mem + this->_memAt, len);
+    this->_memAt += len;
+    return len;
+}
+
+String WebTemplate::value(const String &name) const {
+    for (uint8_t id = 0; id < TPL_COUNT; id++)
+        if (name == TEMPLATE_NAMES[id]) return this->_values[id];
+    return String();
+}
+
+size_t WebTemplate::fill(uint8_t *buf, size_t maxLen) {
+    size_t len = 0;
+    while (len < maxLen) {
+        // Placeholder value
+        if (this->_value != nullptr) {
+            size_t n = min(this->_value->length() - this->_valueAt, maxLen - len);
+            memcpy(buf + len, this->_value->c_str() + this->_valueAt, n);
+            len += n;
+            this->_valueAt += n;
+            if (this->_valueAt >= this->_value->length()) this->_value = nullptr;
+            continue;
+        }
+
+        // Literal bytes, read straight into the response buffer
+        if (this->_literal > 0) {
+            size_t n = this->readBytes(buf + len, min((size_t) this->_literal, maxLen - len));
+            if (n == 0) break;
+            len += n;
+            this->_literal -= n;
+            continue;
+        }
+
+        // Next record
+        int tag = this->readByte();
+        if (tag == TPL_LITERAL) {
+            uint8_t size[2];
+            if (this->readBytes(size, 2) != 2) break;
+            this->_literal = size[0] | (size[1] << 8);
+        }
+        else if (tag == TPL_PLACEHOLDER) {
+            int id = this->readByte();
+            if (id < 0 || id >= TPL_COUNT) break;
+            this->_value = &this->_values[id];
+            this->_valueAt = 0;
+            if (this->_value->length() == 0) this->_value = nullptr;
+        }
+        else break; // end of file (or a damaged record)
+    }
+    return len;
+}
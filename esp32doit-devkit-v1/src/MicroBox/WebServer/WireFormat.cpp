@@ -0,0 +1,43 @@
+/**
+ *  @file WireFormat.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "MicroBox/software/WebServer"
+
+WireFormat WebServerClass::wireFormat(AsyncWebServerRequest *req) {
+    if (!req->hasHeader("Accept")) return WIRE_JSON;
+    // Matches application/msgpack and application/x-msgpack
+    return req->header("Accept").indexOf("msgpack") >= 0 ? WIRE_MSGPACK : WIRE_JSON;
+}
+
+void WebServerClass::sendWire(AsyncWebServerRequest *req, int code, WireFormat format,
+    std::shared_ptr<const WireBuffer> data)
+{
+    // Copied from the shared buffer straight into the TCP buffer
+    AsyncWebServerResponse *res = req->beginResponse(wireContentType(format), data->size(),
+        [data](uint8_t *buf, size_t maxLen, size_t index) -> size_t {
+            size_t len = min(maxLen, data->size() - index);
+            memcpy(buf, data->data() + index, len);
+            return len;
+        });
+    res->setCode(code);
+    res->addHeader("Vary", "Accept");
+    this->served(code, data->size());
+    req->send(res);
+}
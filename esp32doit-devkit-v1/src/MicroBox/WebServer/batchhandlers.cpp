@@ -0,0 +1,200 @@
+/**
+ *  @file batchhandlers.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "MicroBox/software/WebServer"
+#include "MicroBox/hardware/RelayController"
+#include "MicroBox/externobj"
+
+enum BatchOpType : uint8_t {
+    BATCH_RELAY,            ///< {"op":"relay","pin":<pin>,"state":bool}, as GET /check
+    BATCH_AUTO_WATERING,    ///< {"op":"auto_watering","state":bool}, as GET /auto-watering
+    BATCH_MANUAL_WATERING,  ///< {"op":"manual_watering","state":bool}, as GET /manual-watering
+    BATCH_AUTO_CHANGE_WIFI  ///< {"op":"auto_change_wifi","state":bool}, as GET /auto-change-wifi-mode
+};
+
+struct BatchOp {
+    BatchOpType type;
+    uint8_t pin;
+    bool state;
+};
+
+static bool batchOpType(const char *name, BatchOpType &type) {
+    if (name == nullptr) return false;
+    if (strcmp(name, "relay") == 0) type = BATCH_RELAY;
+    else if (strcmp(name, "auto_watering") == 0) type = BATCH_AUTO_WATERING;
+    else if (strcmp(name, "manual_watering") == 0) type = BATCH_MANUAL_WATERING;
+    else if (strcmp(name, "auto_change_wifi") == 0) type = BATCH_AUTO_CHANGE_WIFI;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief POST /api/v1/batch: run an ordered list of relay/config operations as one transaction.
+ * @details
+ * Body: `{"ops":[{"op":"relay","pin":4,"state":true},{"op":"auto_watering","state":false},...]}`
+ *
+ * Every operation is validated first, in order, with the checks of the single
+ * routes (an "auto_watering" off earlier in the list allows the relay operations
+ * after it). If one is invalid nothing is applied: the response is 400 and the
+ * valid operations report 424. Otherwise
+ * the final state of each relay and setting is applied once, and relay.json and
+ * state.json are each written once for the whole batch.
+ *
+ * Response: `{"status":200|400,"msg":...,"results":[{"op":...,"status":...,"msg":...}]}`
+ */
+void WebServerClass::Batch(AsyncWebServerRequest *req, uint8_t *data, size_t len, size_t index, size_t total)
+{
+    // Collect the body (it may arrive in several packets); freed with the request.
+    // Too large or out of memory: no body is kept, BatchRequest() replies
+    if (total > BATCH_MAX_BODY) return;
+    if (index == 0) req->_tempObject = malloc(total + 1);
+    char *body = (char *) req->_tempObject;
+    if (body == nullptr) return;
+    memcpy(body + index, data, len);
+    if (index + len < total) return;
+    body[total] = '\0';
+
+    DynamicJsonDocument doc(BATCH_MAX_BODY * 2);
+    DynamicJsonDocument res(256 + BATCH_MAX_OPS * 96);
+    String handleErrorMsg = "";
+    int statusCode = 200; bool errorState;
+
+    this->handleError_deserializeJson(
+        "Batch", deserializeJson(doc, body), &errorState, &statusCode, &handleErrorMsg
+    );
+    JsonArray ops = doc["ops"];
+    if (!errorState && (ops.isNull() || ops.size() == 0 || ops.size() > BATCH_MAX_OPS)) {
+        errorState = true;
+        statusCode = 400;
+        handleErrorMsg = "\"ops\" must list 1 to " + String(BATCH_MAX_OPS) + " operations";
+    }
+    if (errorState) {
+        res["status"] = statusCode;
+        res["msg"] = handleErrorMsg;
+        this->sendWire(req, statusCode, res);
+        return;
+    }
+
+    // Validate every operation, following the auto watering state through the list
+    std::vector<BatchOp> plan;
+    JsonArray results = res.createNestedArray("results");
+    bool autoWatering = wateringSys.AutoWateringState, valid = true;
+    for (JsonObject item : ops) {
+        JsonObject result = results.createNestedObject();
+        const char *name = item["op"];
+        result["op"] = name;
+
+        BatchOp op;
+        String msg = "";
+        int status = 400;
+        if (!batchOpType(name, op.type))
+            msg = "Unknown operation";
+        else if (!item["state"].is<bool>() && !item["state"].is<int>())
+            msg = "Missing state";
+        else if (op.type == BATCH_RELAY)
+            status = this->checkRelay(item["pin"] | -1, autoWatering, msg);
+        else if (op.type == BATCH_MANUAL_WATERING)
+            status = this->checkManualWatering(autoWatering, msg);
+        else
+            status = 200;
+
+        if (status != 200) {
+            result["status"] = status;
+            result["msg"] = msg;
+            valid = false;
+            continue;
+        }
+
+        op.pin = item["pin"] | 0;
+        op.state = item["state"].as<int>();
+        if (op.type == BATCH_AUTO_WATERING) autoWatering = op.state;
+        plan.push_back(op);
+        result["status"] = 200;
+        result["msg"] = "OK";
+    }
+
+    if (!valid) {
+        for (JsonObject result : results) {
+            if (result["status"] != 200) continue;
+            result["status"] = 424;
+            result["msg"] = "Not applied";
+        }
+        res["status"] = 400;
+        res["msg"] = "Batch rejected, nothing applied";
+        this->sendWire(req, 400, res);
+        return;
+    }
+
+    // Final state of each relay and setting: later operations win
+    std::vector<std::pair<uint8_t, bool>> relays;
+    std::vector<std::pair<String, bool>> config;
+    auto setRelay = [&](uint8_t pin, bool state) {
+        for (auto &item : relays)
+            if (item.first == pin) { item.second = state; return; }
+        relays.push_back({pin, state});
+    };
+    auto setConfig = [&](const char *key, bool state) {
+        for (auto &item : config)
+            if (item.first == key) { item.second = state; return; }
+        config.push_back({key, state});
+    };
+    for (const auto &op : plan) {
+        switch (op.type) {
+            case BATCH_RELAY:
+                setRelay(op.pin, op.state);
+                break;
+            case BATCH_MANUAL_WATERING:
+                for (const auto &pin : RELAY_PINS) setRelay(pin, op.state);
+                break;
+            case BATCH_AUTO_WATERING:
+                setConfig(AUTOWATERING, op.state);
+                break;
+            case BATCH_AUTO_CHANGE_WIFI:
+                setConfig(AUTOCHANGE, op.state);
+                break;
+        }
+    }
+
+    // Apply, then one write per file
+    for (const auto &item : config)
+        if (item.first == AUTOWATERING)
+            wateringSys.events.notify(WATERING_EV_AUTO, item.second);
+    RelayController::WRITE_BATCH(relays, 1000);
+    lfsprog.changeConfigStates(config);
+    lfsprog.changeStateRelays(relays);
+
+    Serial.printf("Batch: %u operation(s), %u relay(s), %u setting(s)\n",
+        (unsigned) plan.size(), (unsigned) relays.size(), (unsigned) config.size());
+    res["status"] = 200;
+    res["msg"] = "OK";
+    this->sendWire(req, 200, res);
+}
+
+void WebServerClass::BatchRequest(AsyncWebServerRequest *req) {
+    // Runs once the whole body is in: Batch() has replied when it kept one
+    if (req->_tempObject != nullptr) return;
+
+    if (req->contentLength() > BATCH_MAX_BODY)
+        this->send(req, 413, APPJSON, "{\"status\":413,\"msg\":\"Batch too large\"}");
+    else if (req->contentLength() > 0)
+        this->send(req, 500, APPJSON, "{\"status\":500,\"msg\":\"Out of memory\"}");
+    else
+        this->send(req, 400, APPJSON, "{\"status\":400,\"msg\":\"Missing body\"}");
+}
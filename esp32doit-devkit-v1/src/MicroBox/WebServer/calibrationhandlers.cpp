@@ -0,0 +1,123 @@
+/**
+ *  @file calibrationhandlers.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author
+ *  basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "MicroBox/software/WebServer"
+#include "MicroBox/externobj"
+
+/**
+ * @brief Calibration endpoint.
+ * @details
+ * - `GET /calibrate?probe=N` returns the compiled profile and the last capture;
+ *   while a capture or reset is still running it reports `pending` without the points.
+ * - `POST /calibrate` with `probe=N&percent=X[&samples=S][&save=0]` queues a
+ *   capture of the probe while it sits at X % moisture. The sensor task records
+ *   the raw ADC statistics and, unless `save=0`, stores the point and recompiles the table.
+ * - `POST /calibrate` with `probe=N&reset=1` drops the stored profile (default dry/wet pair).
+ *
+ * A GET carrying `percent` or `reset` is refused with 405, so a prefetch or a
+ * reloaded URL never overwrites a calibration point.
+ */
+void WebServerClass::Calibrate(AsyncWebServerRequest *req) {
+    DynamicJsonDocument doc(1024);
+    String resBuffer = "", message = "OK";
+    int statusCode = 200;
+
+    if (!req->hasArg("probe")) {
+        message = "Missing parameter";
+        statusCode = 400;
+    }
+    else {
+        int probe = req->arg("probe").toInt();
+        bool capture = req->hasArg("percent");
+        bool reset = req->hasArg("reset") && req->arg("reset").toInt();
+        bool post = req->method() == HTTP_POST;
+
+        // The sensor task recompiles soilcal[] only while a capture or reset is pending,
+        // and only the web handlers (async_tcp) queue one: copy the profile before queuing
+        SoilCalPoint profile[SOIL_CAL_MAX_POINTS];
+        uint8_t profileCount = 0;
+        bool busy = soilcalcapture.pending.load(std::memory_order_acquire);
+        if (!busy && probe >= 0 && probe < SOIL_PROBES) {
+            profileCount = soilcal[probe].count;
+            memcpy(profile, soilcal[probe].points, sizeof(SoilCalPoint) * profileCount);
+        }
+
+        if (probe < 0 || probe >= SOIL_PROBES) {
+            message = "Invalid probe";
+            statusCode = 400;
+        }
+        else if ((capture || reset) && !post) {
+            message = "Use POST to capture or reset";
+            statusCode = 405;
+        }
+        else if ((capture || reset) && busy) {
+            message = "Capture in progress";
+            statusCode = 409;
+        }
+        else if (reset) {
+            soilcalcapture.probe = probe;
+            soilcalcapture.reset = true;
+            soilcalcapture.pending.store(true, std::memory_order_release);
+            message = "Reset queued";
+            statusCode = 202;
+        }
+        else if (capture) {
+            float percent = req->arg("percent").toFloat();
+            int samples = req->hasArg("samples") ? req->arg("samples").toInt() : 64;
+
+            soilcalcapture.ready.store(false, std::memory_order_relaxed);
+            soilcalcapture.probe   = probe;
+            soilcalcapture.percent = constrain(percent, 0.0f, 100.0f);
+            soilcalcapture.samples = constrain(samples, 1, 1024);
+            soilcalcapture.save    = !req->hasArg("save") || req->arg("save").toInt();
+            soilcalcapture.pending.store(true, std::memory_order_release);
+            message = "Capture queued";
+            statusCode = 202;
+        }
+
+        doc["probe"] = probe;
+        doc["pending"] = busy;
+        if (!busy && probe >= 0 && probe < SOIL_PROBES) {
+            JsonArray points = doc.createNestedArray("points");
+            for (uint8_t i = 0; i < profileCount; i++) {
+                JsonObject point = points.createNestedObject();
+                point["raw"] = profile[i].raw;
+                point["pct"] = profile[i].percent;
+            }
+        }
+
+        if (soilcalcapture.ready.load(std::memory_order_acquire) && soilcalcapture.probe == probe) {
+            JsonObject last = doc.createNestedObject("last_capture");
+            last["pct"]     = soilcalcapture.percent;
+            last["samples"] = soilcalcapture.result.samples;
+            last["min"]     = soilcalcapture.result.min;
+            last["max"]     = soilcalcapture.result.max;
+            last["mean"]    = soilcalcapture.result.mean;
+            last["sd"]      = soilcalcapture.result.stddev;
+        }
+    }
+
+    doc["status"] = statusCode;
+    doc["message"] = message;
+    serializeJson(doc, resBuffer);
+
+    this->send(req, statusCode, APPJSON, resBuffer);
+}
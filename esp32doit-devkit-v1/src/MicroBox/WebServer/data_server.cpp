@@ -28,43 +28,99 @@ void WebServerClass::GetDataServer(DynamicJsonDocument &doc) {
 
     JsonObject data = doc.createNestedObject("data_server");
 
-    data["dht"]["temp"] = String(dhtprog.temperature, 2);
-    data["dht"]["hum"] = String(dhtprog.humidity, 2);
-    data["soil_moisture"] = soilmoisture.value;
+    sensors.toJson(data);
+#if SOIL_MUX_ENABLE
+    JsonArray probes = data.createNestedArray("soil_probes");
+    for (const auto &v : soilmux.value)
+        probes.add(v);
+    data["soil_probes_scan_us"] = soilmux.scanMicros;
+#endif
     data["watering_state"] = wateringSys.WateringProcess;
+#if FLOW_METER_ENABLE
+    JsonObject flow = data.createNestedObject("flow");
+    flow["lpm"]     = flowmeter.totalLpm();
+    flow["litres"]  = flowmeter.totalLitres();
+    flow["dry_run"] = flowmeter.dryRun();
+    flow["leak"]    = flowmeter.leak();
+#endif
+    sensors.healthJson(data.createNestedObject("sensor_health"));
+
+    // Changes only with a sample (epoch bump); the rates over time are in /data-server-stats
+    JsonObject sampling = data.createNestedObject("sampling");
+    sampling["period_ms"] = sampler.period();
 
     this->queryDataRelayStr(dataRelay);
     doc["data_relay"] = dataRelay;
     dataRelay.clear();
 }
 
+/**
+ * @brief Serialized data-server state, rebuilt only when the StateEpoch moved.
+ * @details
+ * The same bytes answer GET /data-server and the WS "data_server" event
+ * (`{"status":200,"event":"data_server","data_server":{...},"data_relay":{...}}`),
+ * one cached copy per wire format. Only called from the async_tcp task, so the
+ * cache needs no lock; a response still being sent keeps its snapshot alive
+ * through the shared pointer.
+ */
+std::shared_ptr<const WireBuffer> WebServerClass::dataSnapshot(WireFormat format) {
+    DataSnapshot &snapshot = this->snapshots[format];
+
+    // Read the epoch before the state: a change while building forces the next rebuild
+    uint32_t epoch = StateEpoch::now();
+    if (snapshot.data && epoch == snapshot.epoch) {
+        this->snapshotHits++;
+        return snapshot.data;
+    }
+
+    DynamicJsonDocument doc(2048);
+    doc["status"] = 200;
+    doc["event"] = "data_server";
+    this->GetDataServer(doc);
+
+    snapshot.data = serializeWire(doc, format);
+    snapshot.epoch = epoch;
+    this->snapshotMisses++;
+    return snapshot.data;
+}
+
 // WebServer Program
 void WebServerClass::DataWebServer(AsyncWebServerRequest *req) {
-    DynamicJsonDocument doc(1024);
-    String jsonBuffer = "";
-    int codeRes = 200;
+    WireFormat format = wireFormat(req);
+    this->sendWire(req, 200, format, this->dataSnapshot(format));
+}
 
-    doc["status"] = codeRes;
-    this->GetDataServer(doc);
+/**
+ * @brief Snapshot cache counters and the sampling rates, which move with the
+ * clock and are never cached.
+ */
+void WebServerClass::DataServerStats(AsyncWebServerRequest *req) {
+    StaticJsonDocument<192> doc;
+
+    doc["status"] = 200;
+    doc["epoch"]  = StateEpoch::now();
+    doc["hits"]   = this->snapshotHits.load();
+    doc["misses"] = this->snapshotMisses.load();
 
-    serializeJson(doc, jsonBuffer);
-    doc.clear();
-    req->send_P(codeRes, APPJSON, jsonBuffer.c_str());
+    JsonObject sampling = doc.createNestedObject("sampling");
+    sampling["period_ms"] = sampler.period();
+    sampling["samples_per_hour"] = sampler.samplesPerHour(millis());
+    sampling["awake_pct"] = round(sampler.awakePercent(millis()) * 100.0) / 100.0;
+    this->sendWire(req, 200, doc);
 }
 
 // WebSocket program
 void WebServerClass::handleDataServeWS(AsyncWebSocketClient *client) {
-    if (this->ws.count() > 5) {
-        Serial.println("Too many WebSocket clients, rejecting new request.");
+    // Connections over WS_MAX_CLIENTS are refused at the upgrade (WsRefused)
+    if (!client->canSend()) {
+        this->wsCounters.dropped++;
         return;
     }
-    
-    DynamicJsonDocument res(1024);
-    String jsonRes = "";
-
-    res["event"] = "data_server";
-    this->GetDataServer(res);
-    serializeJson(res, jsonRes);
-    client->text(jsonRes.c_str());
-    res.clear();
-}
\ No newline at end of file
+
+    WireFormat format = this->wsFormat(client->id());
+    std::shared_ptr<const WireBuffer> data = this->dataSnapshot(format);
+    if (format == WIRE_MSGPACK)
+        client->binary((const char *) data->data(), data->size());
+    else
+        client->text((const char *) data->data(), data->size());
+}
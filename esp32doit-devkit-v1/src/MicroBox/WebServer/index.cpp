@@ -23,9 +23,8 @@
 #include "MicroBox/externobj"
 
 void WebServerClass::index(AsyncWebServerRequest *req) {
-    // Read file html
-    String page = this->file_buffer(this->DIRHTML + "index.html");
-    if (page == "") {
+    auto page = std::make_shared<WebTemplate>();
+    if (!this->openPage(*page, this->DIRHTML + "index.html")) {
         this->handleNotFound(req);
         return;
     }
@@ -33,33 +32,23 @@ void WebServerClass::index(AsyncWebServerRequest *req) {
     // get list data relay
     std::vector<String>listVar;
     std::vector<int>listPin;
-    // std::vector<int>listId;
 
     for (const auto &relay : RELAY_PINS) {
         RelayController::READ(relay);
         listPin.push_back(RelayController::PIN_IO_RELAY);
         listVar.push_back(RelayController::LABEL_RELAY);
-        // listId.push_back(RelayController::ID_RELAY);
     }
 
-    const String placeholders[] = {
-        "%VERSION_PROJECT%",
-        "%VAR1%", "%VARID1%", "%CHECKED1%",
-        "%VAR2%", "%VARID2%", "%CHECKED2%",
-        "%VAR3%", "%VARID3%", "%CHECKED3%"
-    };
-
-    const String tags_html[] = {
-        this->__VERSION_PROJECT__,
-        "Auto Watering", "auto", this->stateChecked(wateringSys.AutoWateringState),
-        listVar[0], String(listPin[0]), this->RelayChecked(listPin[0]),
-        listVar[1], String(listPin[1]), this->RelayChecked(listPin[1])
-    };
-
-    // Replace page
-    for (size_t item = 0; item < sizeof(tags_html)/sizeof(tags_html[0]); item++) {
-        page.replace(placeholders[item], tags_html[item]);
-    }
-
-    req->send_P(200, TEXTHTML, page.c_str());
+    page->set(TPL_VERSION_PROJECT, this->__VERSION_PROJECT__);
+    page->set(TPL_VAR1, "Auto Watering");
+    page->set(TPL_VARID1, "auto");
+    page->set(TPL_CHECKED1, this->stateChecked(wateringSys.AutoWateringState));
+    page->set(TPL_VAR2, listVar[0]);
+    page->set(TPL_VARID2, String(listPin[0]));
+    page->set(TPL_CHECKED2, this->RelayChecked(listPin[0]));
+    page->set(TPL_VAR3, listVar[1]);
+    page->set(TPL_VARID3, String(listPin[1]));
+    page->set(TPL_CHECKED3, this->RelayChecked(listPin[1]));
+
+    this->sendTemplate(req, page);
 }
\ No newline at end of file
@@ -0,0 +1,312 @@
+/**
+ *  @file metrics.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "MicroBox/software/WebServer"
+
+#define TEXTPROMETHEUS "text/plain; version=0.0.4"
+
+enum MetricsFamily : uint8_t {
+    METRICS_REQUESTS = 0,
+    METRICS_RESPONSES,
+    METRICS_BYTES,
+    METRICS_DURATION,
+    METRICS_GAUGES,
+    METRICS_DONE
+};
+
+static const char *const METRICS_HEADERS[] = {
+    "# HELP microbox_http_requests_total Requests handled, per route.\n"
+    "# TYPE microbox_http_requests_total counter\n",
+    "# HELP microbox_http_responses_total Responses sent, per route and status class.\n"
+    "# TYPE microbox_http_responses_total counter\n",
+    "# HELP microbox_http_response_bytes_total Body bytes sent, per route.\n"
+    "# TYPE microbox_http_response_bytes_total counter\n",
+    "# HELP microbox_http_request_duration_seconds From the handler call until the connection closed.\n"
+    "# TYPE microbox_http_request_duration_seconds histogram\n"
+};
+
+RouteMetrics *WebServerClass::routeSlot(const char *route) {
+    for (uint8_t i = 0; i < this->routeCount; i++)
+        if (strcmp(this->routeMetrics[i].route, route) == 0) return &this->routeMetrics[i];
+
+    if (this->routeCount >= METRICS_MAX_ROUTES) {
+        Serial.printf("Metrics: no slot left for %s (METRICS_MAX_ROUTES)\n", route);
+        return nullptr;
+    }
+    RouteMetrics *slot = &this->routeMetrics[this->routeCount++];
+    slot->route = route;
+    return slot;
+}
+
+void WebServerClass::meterRequest(RouteMetrics *route, AsyncWebServerRequest *req) {
+    uint32_t start = micros();
+    route->requests.fetch_add(1, std::memory_order_relaxed);
+    this->inflight++;
+
+    // The library closes the connection once the response is sent
+    req->onDisconnect([this, route, start]() {
+        route->latency(micros() - start);
+        this->inflight--;
+    });
+}
+
+ArRequestHandlerFunction WebServerClass::metered(const char *route, ArRequestHandlerFunction handler) {
+    RouteMetrics *slot = this->routeSlot(route);
+    if (slot == nullptr) return handler;
+
+    return [this, slot, handler](AsyncWebServerRequest *req) {
+        this->meterRequest(slot, req);
+        this->activeRoute = slot;
+        handler(req);
+        this->activeRoute = nullptr;
+    };
+}
+
+ArBodyHandlerFunction WebServerClass::meteredBody(const char *route, ArBodyHandlerFunction handler) {
+    RouteMetrics *slot = this->routeSlot(route);
+    if (slot == nullptr) return handler;
+
+    // Timed from the first packet of the body
+    return [this, slot, handler](AsyncWebServerRequest *req, uint8_t *data, size_t len, size_t index, size_t total) {
+        if (index == 0) this->meterRequest(slot, req);
+        this->activeRoute = slot;
+        handler(req, data, len, index, total);
+        this->activeRoute = nullptr;
+    };
+}
+
+void WebServerClass::served(int code, size_t len) {
+    // Handlers and their responses run on the async_tcp task, as the wrappers above
+    if (this->activeRoute != nullptr)
+        this->activeRoute->response(code, len);
+}
+
+void WebServerClass::send(AsyncWebServerRequest *req, int code, const char *type, const String &content) {
+    this->served(code, content.length());
+    req->send(code, type, content);
+}
+
+bool WebServerClass::metricsChunk(MetricsCursor &cursor) {
+    char line[256];
+    cursor.pending = "";
+    cursor.at = 0;
+
+    if (cursor.family < METRICS_GAUGES) {
+        // Prometheus wants the lines of a family together: families outside, routes inside
+        if (cursor.route == 0) cursor.pending = METRICS_HEADERS[cursor.family];
+
+        if (cursor.route < this->routeCount) {
+            const RouteMetrics &m = this->routeMetrics[cursor.route];
+            switch (cursor.family) {
+                case METRICS_REQUESTS:
+                    snprintf(line, sizeof(line), "microbox_http_requests_total{route=\"%s\"} %u\n",
+                        m.route, (unsigned) m.requests.load());
+                    cursor.pending += line;
+                    break;
+
+                case METRICS_RESPONSES:
+                    for (uint8_t i = 0; i < 5; i++) {
+                        uint32_t count = m.status[i].load();
+                        if (count == 0) continue;
+                        snprintf(line, sizeof(line), "microbox_http_responses_total{route=\"%s\",code=\"%uxx\"} %u\n",
+                            m.route, (unsigned) i + 1, (unsigned) count);
+                        cursor.pending += line;
+                    }
+                    break;
+
+                case METRICS_BYTES:
+                    snprintf(line, sizeof(line), "microbox_http_response_bytes_total{route=\"%s\"} %u\n",
+                        m.route, (unsigned) m.bytes.load());
+                    cursor.pending += line;
+                    break;
+
+                case METRICS_DURATION: {
+                    uint32_t cumulative = 0;
+                    for (size_t i = 0; i <= METRICS_BUCKETS; i++) {
+                        cumulative += m.bucket[i].load();
+                        if (i < METRICS_BUCKETS)
+                            snprintf(line, sizeof(line),
+                                "microbox_http_request_duration_seconds_bucket{route=\"%s\",le=\"%g\"} %u\n",
+                                m.route, METRICS_BUCKETS_MS[i] / 1000.0, (unsigned) cumulative);
+                        else
+                            snprintf(line, sizeof(line),
+                                "microbox_http_request_duration_seconds_bucket{route=\"%s\",le=\"+Inf\"} %u\n",
+                                m.route, (unsigned) cumulative);
+                        cursor.pending += line;
+                    }
+                    snprintf(line, sizeof(line), "microbox_http_request_duration_seconds_sum{route=\"%s\"} %.6f\n",
+                        m.route, m.latencySum.load() / 1e6);
+                    cursor.pending += line;
+                    // The +Inf bucket, so that the count always matches the buckets
+                    snprintf(line, sizeof(line), "microbox_http_request_duration_seconds_count{route=\"%s\"} %u\n",
+                        m.route, (unsigned) cumulative);
+                    cursor.pending += line;
+                    break;
+                }
+            }
+            cursor.route++;
+        }
+
+        if (cursor.route >= this->routeCount) {
+            cursor.family++;
+            cursor.route = 0;
+        }
+        return true;
+    }
+
+    if (cursor.family == METRICS_GAUGES) {
+        // Dashboards whose WebSocket queue is full (messages are being refused)
+        uint32_t wsBacklogged = 0;
+        for (const auto &slot : this->wsSubscribers) {
+            uint32_t id = slot.load();
+            if (id == 0) continue;
+            AsyncWebSocketClient *client = this->ws.client(id);
+            if (client != nullptr && !client->canSend()) wsBacklogged++;
+        }
+
+        snprintf(line, sizeof(line),
+            "# HELP microbox_heap_free_bytes Free heap.\n"
+            "# TYPE microbox_heap_free_bytes gauge\n"
+            "microbox_heap_free_bytes %u\n",
+            (unsigned) ESP.getFreeHeap());
+        cursor.pending += line;
+        snprintf(line, sizeof(line),
+            "# HELP microbox_heap_min_free_bytes Lowest free heap since boot.\n"
+            "# TYPE microbox_heap_min_free_bytes gauge\n"
+            "microbox_heap_min_free_bytes %u\n",
+            (unsigned) ESP.getMinFreeHeap());
+        cursor.pending += line;
+        snprintf(line, sizeof(line),
+            "# HELP microbox_heap_max_alloc_bytes Largest block that can be allocated.\n"
+            "# TYPE microbox_heap_max_alloc_bytes gauge\n"
+            "microbox_heap_max_alloc_bytes %u\n",
+            (unsigned) ESP.getMaxAllocHeap());
+        cursor.pending += line;
+        snprintf(line, sizeof(line),
+            "# HELP microbox_ws_clients WebSocket clients connected to /ws.\n"
+            "# TYPE microbox_ws_clients gauge\n"
+            "microbox_ws_clients %u\n",
+            (unsigned) this->ws.count());
+        cursor.pending += line;
+        snprintf(line, sizeof(line),
+            "# HELP microbox_ws_clients_backlogged Subscribed dashboards with a full message queue.\n"
+            "# TYPE microbox_ws_clients_backlogged gauge\n"
+            "microbox_ws_clients_backlogged %u\n",
+            (unsigned) wsBacklogged);
+        cursor.pending += line;
+        const struct { const char *name, *help; uint32_t value; } wsTotals[] = {
+            { "rejected", "WebSocket upgrades refused with 503 (WS_MAX_CLIENTS connected).",
+                this->wsCounters.rejected.load() },
+            { "rate_limited", "WebSocket client messages dropped by the token bucket.",
+                this->wsCounters.rateLimited.load() },
+            { "dropped", "WebSocket replies not queued: client queue full.",
+                this->wsCounters.dropped.load() },
+            { "coalesced", "Deltas skipped for a backlogged dashboard.",
+                this->wsCounters.coalesced.load() },
+            { "evicted", "Dashboards closed after WS_STALL_MS backlogged.",
+                this->wsCounters.evicted.load() },
+            { "cleaned", "WebSocket clients closed by cleanupClients().",
+                this->wsCounters.cleaned.load() }
+        };
+        // /events: queued bytes of all streams, to compare with the heap cost of /ws clients
+        size_t sseQueued = 0;
+        {
+            std::lock_guard<std::recursive_mutex> lock(this->sseLock);
+            for (const auto &slot : this->sseSlots)
+                if (slot.client != nullptr) sseQueued += this->sseQueued(slot);
+        }
+        snprintf(line, sizeof(line),
+            "# HELP microbox_sse_clients Streams connected to /events.\n"
+            "# TYPE microbox_sse_clients gauge\n"
+            "microbox_sse_clients %u\n",
+            (unsigned) this->sseClients.load());
+        cursor.pending += line;
+        snprintf(line, sizeof(line),
+            "# HELP microbox_sse_queued_bytes Event bytes queued to the streams, not acknowledged yet.\n"
+            "# TYPE microbox_sse_queued_bytes gauge\n"
+            "microbox_sse_queued_bytes %u\n",
+            (unsigned) sseQueued);
+        cursor.pending += line;
+
+        const struct { const char *name, *help; uint32_t value; } sseTotals[] = {
+            { "rejected", "Streams closed: SSE_MAX_CLIENTS connected.",
+                this->sseCounters.rejected.load() },
+            { "resumed", "Streams resumed from the replay buffer (Last-Event-ID).",
+                this->sseCounters.resumed.load() },
+            { "deferred", "Events held back by the memory cap of a stream.",
+                this->sseCounters.deferred.load() },
+            { "expired", "Streams closed: the events they missed left the replay buffer.",
+                this->sseCounters.expired.load() }
+        };
+        for (const auto &item : sseTotals) {
+            snprintf(line, sizeof(line),
+                "# HELP microbox_sse_%s_total %s\n"
+                "# TYPE microbox_sse_%s_total counter\n"
+                "microbox_sse_%s_total %u\n",
+                item.name, item.help, item.name, item.name, (unsigned) item.value);
+            cursor.pending += line;
+        }
+
+        for (const auto &item : wsTotals) {
+            snprintf(line, sizeof(line),
+                "# HELP microbox_ws_%s_total %s\n"
+                "# TYPE microbox_ws_%s_total counter\n"
+                "microbox_ws_%s_total %u\n",
+                item.name, item.help, item.name, item.name, (unsigned) item.value);
+            cursor.pending += line;
+        }
+        snprintf(line, sizeof(line),
+            "# HELP microbox_http_inflight_requests Requests handled whose connection is still open.\n"
+            "# TYPE microbox_http_inflight_requests gauge\n"
+            "microbox_http_inflight_requests %u\n",
+            (unsigned) this->inflight.load());
+        cursor.pending += line;
+
+        cursor.family++;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief GET /metrics: request metrics of the routes of Routes.cpp, in Prometheus text format.
+ * @details
+ * Written in chunks, one route of one family at a time, so the response never
+ * holds more than a few hundred bytes whatever the number of routes.
+ */
+void WebServerClass::Metrics(AsyncWebServerRequest *req) {
+    auto cursor = std::make_shared<MetricsCursor>();
+    RouteMetrics *route = this->activeRoute;
+    this->served(200, 0);
+
+    req->sendChunked(TEXTPROMETHEUS,
+        [this, cursor, route](uint8_t *buf, size_t maxLen, size_t) -> size_t {
+            size_t len = 0;
+            while (len < maxLen) {
+                if (cursor->at >= cursor->pending.length() && !this->metricsChunk(*cursor)) break;
+                size_t n = min(maxLen - len, cursor->pending.length() - cursor->at);
+                memcpy(buf + len, cursor->pending.c_str() + cursor->at, n);
+                cursor->at += n;
+                len += n;
+            }
+            if (route != nullptr) route->bytes.fetch_add(len, std::memory_order_relaxed);
+            return len;
+        });
+}
@@ -22,9 +22,8 @@
 #include "MicroBox/externobj"
 
 void WebServerClass::RecoveryPage(AsyncWebServerRequest *req) {
-    // read file html
-    String page = this->file_buffer(this->DIRHTML + "recovery.html");
-    if (page == "") {
+    auto page = std::make_shared<WebTemplate>();
+    if (!this->openPage(*page, this->DIRHTML + "recovery.html")) {
         this->handleNotFound(req);
         return;
     }
@@ -43,45 +42,19 @@ void WebServerClass::RecoveryPage(AsyncWebServerRequest *req) {
     bool _autoChangeWiFi;
     lfsprog.readConfigState(AUTOCHANGE, &_autoChangeWiFi);
 
-    const String placeholders[] = {
-        "%VERSION_PROJECT%", 
-        "%HW_VERSION%", 
-        "%SW_VERSION%",
-        "%BUILD_DATE%", 
-        "%FIRMWARE_REGION%",
-        "%LOCALIP%", 
-        "%PORT%",
-        
-        "%SSID_AP%", 
-        "%PASS_AP%",
-        "%SSID_STA%", 
-        "%PASS_STA%",
-        "%AUTO_CHANGE_WIFI%",
-        
-        "%LOCALIP%", "%LOCALIP%", "%LOCALIP%"
-    };
-
-    const String tags_html[] = {
-        this->__VERSION_PROJECT__,
-        this->__HW_VERSION__,
-        this->__SW_VERSION__,
-        this->__BUILD_DATE__,
-        this->__REGION__,
-        this->LocalIP,
-        portWeb,
-
-        ProgramWiFi.__SSID_AP__,
-        ProgramWiFi.__PASS_AP__,
-        ProgramWiFi.__SSID_STA__,
-        ProgramWiFi.__PASS_STA__,
-        _autoChangeWiFi ? "Enable" : "Disable",
-
-        this->LocalIP, this->LocalIP, this->LocalIP
-    };
-
-    // replace page
-    for (size_t i = 0; i < sizeof(tags_html)/sizeof(tags_html[0]); i++)
-        page.replace(placeholders[i], tags_html[i]);
-
-    req->send(200, TEXTHTML, page);
+    page->set(TPL_VERSION_PROJECT, this->__VERSION_PROJECT__);
+    page->set(TPL_HW_VERSION, this->__HW_VERSION__);
+    page->set(TPL_SW_VERSION, this->__SW_VERSION__);
+    page->set(TPL_BUILD_DATE, this->__BUILD_DATE__);
+    page->set(TPL_FIRMWARE_REGION, this->__REGION__);
+    page->set(TPL_LOCALIP, this->LocalIP);
+    page->set(TPL_PORT, portWeb);
+
+    page->set(TPL_SSID_AP, ProgramWiFi.__SSID_AP__);
+    page->set(TPL_PASS_AP, ProgramWiFi.__PASS_AP__);
+    page->set(TPL_SSID_STA, ProgramWiFi.__SSID_STA__);
+    page->set(TPL_PASS_STA, ProgramWiFi.__PASS_STA__);
+    page->set(TPL_AUTO_CHANGE_WIFI, _autoChangeWiFi ? "Enable" : "Disable");
+
+    this->sendTemplate(req, page);
 }
\ No newline at end of file
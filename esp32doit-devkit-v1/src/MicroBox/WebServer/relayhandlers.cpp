@@ -32,18 +32,37 @@ void WebServerClass::updateRelayState(int pinRelay, bool state) {
     RelayController::WRITE(pinRelay, state, 1000);
 }
 
+int WebServerClass::checkRelay(int pin, bool autoWatering, String &msg) {
+    if (autoWatering) {
+        msg = "Auto Watering is Enable";
+        return 400;
+    }
+
+    // Compared as int: narrowed first, pinout=260 would be GPIO 4
+    for (const auto &item : RELAY_PINS) {
+        if (item == pin) {
+            msg = "OK";
+            return 200;
+        }
+    }
+    msg = "Invalid pin";
+    return 400;
+}
+
+int WebServerClass::commandRelay(int pin, bool state, String &msg) {
+    int status = this->checkRelay(pin, wateringSys.AutoWateringState, msg);
+    if (status == 200) this->updateRelayState(pin, state);
+    return status;
+}
+
 void WebServerClass::queryDataRelayStr(StaticJsonDocument<500> &doc) {
     doc["auto"]["id"] = "auto";
     doc["auto"]["status"] = wateringSys.AutoWateringState;
+    // The pin is the key, the state is the output itself: no need to read relay.json
     for (const auto &item : RELAY_PINS) {
         JsonObject relay = doc.createNestedObject(String(VAR_SWITCH) + String(item));
-        RelayController::READ(item);
-
-        // relay["id"] = RelayController::ID_RELAY;
-        relay["id"] = RelayController::PIN_IO_RELAY;
-        relay["status"] = RelayController::RELAY_STATE_STR_INT(
-            digitalRead(RelayController::PIN_IO_RELAY)
-        );
+        relay["id"] = item;
+        relay["status"] = RelayController::RELAY_STATE_STR_INT(digitalRead(item));
     }
 }
 
@@ -66,7 +85,7 @@ void WebServerClass::queryDataRelay(AsyncWebServerRequest *req) {
 
     serializeJson(jsonDoc, jsonres);
     jsonDoc.clear();
-    req->send_P(statusCode, APPJSON, jsonres.c_str());
+    this->send(req, statusCode, APPJSON, jsonres);
 }
 
 void WebServerClass::postRelay(AsyncWebServerRequest *req, uint8_t *data, size_t len, size_t index, size_t total)
@@ -126,21 +145,19 @@ void WebServerClass::postRelay(AsyncWebServerRequest *req, uint8_t *data, size_t
     }
 
     serializeJson(doc, jsonres);
-    req->send_P(statusCode, APPJSON, jsonres.c_str());
+    this->send(req, statusCode, APPJSON, jsonres);
 }
 
 void WebServerClass::readRelayState(AsyncWebServerRequest *req) {
     StaticJsonDocument<500> doc, dataRelay;
-    String resBuffer = "";
     int statusCode = 200;
 
     this->queryDataRelayStr(dataRelay);
     doc["status"] = statusCode;
     doc["data_relay"] = dataRelay;
-    
-    serializeJson(doc, resBuffer);
-    doc.clear();
-    req->send(statusCode, APPJSON, resBuffer);
+
+    // JSON, or MessagePack when the client accepts it
+    this->sendWire(req, statusCode, doc);
 }
 
 void WebServerClass::checkRelayState(AsyncWebServerRequest *req) {
@@ -153,30 +170,9 @@ void WebServerClass::checkRelayState(AsyncWebServerRequest *req) {
         String state   = req->getParam("state")->value();
 
         bool relayState = state.toInt();
-        int _querycount = 0;
-
-        // check auto watering state
-        if (!wateringSys.AutoWateringState) {
-            for (const auto &item : RELAY_PINS) {
-                String varName = String(VAR_SWITCH) + String(item);
-                if (item == _pinOut.toInt()) {
-                    this->updateRelayState(item, relayState);
-                    data[varName] = relayState;
-                    res = "OK";
-                    statusCode = 200;
-                    _querycount++;
-                }
-            }
-
-            if (_querycount <= 0) {
-                res = "Invalid pin";
-                statusCode = 400;
-            }
-        }
-        else {
-            res = "Auto Watering is Enable";
-            statusCode = 400;
-        }
+        statusCode = this->commandRelay(_pinOut.toInt(), relayState, res);
+        if (statusCode == 200)
+            data[String(VAR_SWITCH) + String(_pinOut.toInt())] = relayState;
     }
     else {
         res = "Missing parameters";
@@ -193,5 +189,5 @@ void WebServerClass::checkRelayState(AsyncWebServerRequest *req) {
     }
     
     serializeJson(doc, jsonBuffer);
-    req->send_P(statusCode, APPJSON, jsonBuffer.c_str());
+    this->send(req, statusCode, APPJSON, jsonBuffer);
 }
\ No newline at end of file
@@ -22,9 +22,8 @@
 #include "MicroBox/externobj"
 
 void WebServerClass::ResetSys(AsyncWebServerRequest *req) {
-    // read file html
-    String page = this->file_buffer(DIRHTML + "reset-sys.html");
-    if (page == "") {
+    auto page = std::make_shared<WebTemplate>();
+    if (!this->openPage(*page, DIRHTML + "reset-sys.html")) {
         this->handleNotFound(req);
         return;
     }
@@ -33,21 +32,10 @@ void WebServerClass::ResetSys(AsyncWebServerRequest *req) {
     clientIP = req->client()->localIP();
     LocalIP = clientIP.toString();
 
-    const char *placeholders[] = {
-        "%VERSION_PROJECT%",
-        "%LOCALIP%"
-    };
+    page->set(TPL_VERSION_PROJECT, this->__VERSION_PROJECT__);
+    page->set(TPL_LOCALIP, this->LocalIP);
 
-    const char *tags_html[] = {
-        this->__VERSION_PROJECT__.c_str(),
-        this->LocalIP.c_str()
-    };
-
-    // replace page
-    for (size_t i = 0; i < sizeof(tags_html)/sizeof(tags_html[0]); i++)
-        page.replace(placeholders[i], tags_html[i]);
-
-    req->send_P(200, TEXTHTML, page.c_str());
+    this->sendTemplate(req, page);
 
     // reinitailizing config
     lfsprog.reinitializeState();
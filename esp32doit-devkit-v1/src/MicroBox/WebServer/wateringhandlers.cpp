@@ -22,6 +22,33 @@
 #include "MicroBox/software/WebServer"
 #include "MicroBox/hardware/RelayController"
 #include "MicroBox/externobj"
+#include <sys/time.h>
+
+int WebServerClass::commandAutoWatering(bool state, String &msg) {
+    lfsprog.changeConfigState(AUTOWATERING, state);
+    wateringSys.events.notify(WATERING_EV_AUTO, state);
+    msg = "OK";
+    return 200;
+}
+
+int WebServerClass::checkManualWatering(bool autoWatering, String &msg) {
+    if (autoWatering) {
+        msg = "Auto Watering is Enable";
+        return 400;
+    }
+    msg = "OK";
+    return 200;
+}
+
+int WebServerClass::commandManualWatering(bool state, String &msg) {
+    int status = this->checkManualWatering(wateringSys.AutoWateringState, msg);
+    if (status != 200) return status;
+
+    for (const auto &relay : RELAY_PINS) {
+        this->updateRelayState(relay, state);
+    }
+    return status;
+}
 
 void WebServerClass::AutoWatering(AsyncWebServerRequest *req) {
     StaticJsonDocument<50> jsonDoc;
@@ -30,8 +57,7 @@ void WebServerClass::AutoWatering(AsyncWebServerRequest *req) {
 
     if (req->hasParam("state")) {
         bool state = req->getParam("state")->value().toInt();
-        lfsprog.changeConfigState(AUTOWATERING, state);
-        message = "OK";
+        statusCode = this->commandAutoWatering(state, message);
     }
     else {
         message = "Missing parameter";
@@ -42,7 +68,7 @@ void WebServerClass::AutoWatering(AsyncWebServerRequest *req) {
     jsonDoc["message"] = message;
     serializeJson(jsonDoc, resBuffer);
 
-    req->send_P(statusCode, APPJSON, resBuffer.c_str());
+    this->send(req, statusCode, APPJSON, resBuffer);
 }
 
 void WebServerClass::ManualWatering(AsyncWebServerRequest *req) {
@@ -52,16 +78,7 @@ void WebServerClass::ManualWatering(AsyncWebServerRequest *req) {
 
     if (req->hasParam("state")) {
         bool state = req->getParam("state")->value().toInt();
-        if (!wateringSys.AutoWateringState) {
-            for (const auto &relay : RELAY_PINS) {
-                this->updateRelayState(relay, state);
-            }
-            message = "OK";
-        }
-        else {
-            message = "Auto Watering is Enable";
-            statusCode = 400;
-        }
+        statusCode = this->commandManualWatering(state, message);
     }
     else {
         message = "Missing parameters";
@@ -72,5 +89,516 @@ void WebServerClass::ManualWatering(AsyncWebServerRequest *req) {
     jsonDoc["message"] = message;
     serializeJson(jsonDoc, resBuffer);
 
-    req->send_P(statusCode, APPJSON, resBuffer.c_str());
-}
\ No newline at end of file
+    this->send(req, statusCode, APPJSON, resBuffer);
+}
+/**
+ * @brief Watering controller configuration.
+ * @details
+ * - `GET /watering-zones` returns the mode, the zone settings and the live zone state.
+ * - `mode=pulse|threshold|predictive` selects the controller.
+ * - `low=N` / `high=N` set the start and stop levels of the threshold and predictive modes.
+ * - `pumps=N` sets how many zones may water at once, `policy=fair|priority` their order.
+ * - `forecast_hours=MASK` sets the hours of day (bit per hour) predictive watering may start in.
+ * - `zone=N` with any of `enabled`, `probe`, `start`, `target`, `limit`, `pulse_ms`,
+ *   `pulse_min_ms`, `pulse_max_ms`, `soak_ms`, `max_pulses`, `priority` changes one zone.
+ */
+void WebServerClass::WateringZones(AsyncWebServerRequest *req) {
+    DynamicJsonDocument doc(2048);
+    String resBuffer = "", message = "OK";
+    int statusCode = 200;
+
+    WateringConfig cfg;
+    lfsprog.readWateringConfig(cfg);
+    bool changed = false;
+
+    if (req->hasParam("mode")) {
+        int mode = wateringModeFromText(req->getParam("mode")->value().c_str());
+        if (mode >= 0) {
+            cfg.mode = mode;
+            changed = true;
+        }
+        else {
+            message = "Invalid mode";
+            statusCode = 400;
+        }
+    }
+
+    if (statusCode == 200 && (req->hasParam("low") || req->hasParam("high"))) {
+        long low  = req->hasParam("low")  ? req->getParam("low")->value().toInt()  : cfg.low;
+        long high = req->hasParam("high") ? req->getParam("high")->value().toInt() : cfg.high;
+        if (low < 0 || low >= high || high > 100) {
+            message = "Invalid low/high levels";
+            statusCode = 400;
+        }
+        else {
+            cfg.low  = low;
+            cfg.high = high;
+            changed = true;
+        }
+    }
+
+    if (statusCode == 200 && req->hasParam("pumps")) {
+        int pumps = req->getParam("pumps")->value().toInt();
+        if (pumps < 1 || pumps > (int) WATERING_ZONES) {
+            message = "Invalid pumps";
+            statusCode = 400;
+        }
+        else {
+            cfg.pumps = pumps;
+            changed = true;
+        }
+    }
+
+    if (statusCode == 200 && req->hasParam("policy")) {
+        String policy = req->getParam("policy")->value();
+        if (policy == "fair" || policy == "priority") {
+            cfg.policy = policy == "priority" ? SCHED_PRIORITY : SCHED_FAIR;
+            changed = true;
+        }
+        else {
+            message = "Invalid policy";
+            statusCode = 400;
+        }
+    }
+
+    if (statusCode == 200 && req->hasParam("forecast_hours")) {
+        uint32_t hours = strtoul(req->getParam("forecast_hours")->value().c_str(), nullptr, 0);
+        if (hours == 0 || hours > FORECAST_HOURS_ALL) {
+            message = "Invalid forecast_hours";
+            statusCode = 400;
+        }
+        else {
+            cfg.forecastHours = hours;
+            changed = true;
+        }
+    }
+
+    if (statusCode == 200 && (req->hasParam("rain_on") || req->hasParam("rain_off") ||
+                              req->hasParam("dryout_min") || req->hasParam("skip_min"))) {
+        RainConfig rain = cfg.rain;
+        auto param = [&](const char *name, long fallback) -> long {
+            return req->hasParam(name) ? req->getParam(name)->value().toInt() : fallback;
+        };
+        rain.onLevel   = param("rain_on", rain.onLevel);
+        rain.offLevel  = param("rain_off", rain.offLevel);
+        rain.dryOutMin = param("dryout_min", rain.dryOutMin);
+        rain.skipMin   = param("skip_min", rain.skipMin);
+
+        if (rain.onLevel > 100 || rain.offLevel >= rain.onLevel || rain.dryOutMin > rain.dryOutMaxMin) {
+            message = "Invalid rain settings";
+            statusCode = 400;
+        }
+        else {
+            cfg.rain = rain;
+            changed = true;
+        }
+    }
+
+    if (statusCode == 200 && req->hasParam("zone")) {
+        int index = req->getParam("zone")->value().toInt();
+        if (index < 0 || index >= (int) WATERING_ZONES) {
+            message = "Invalid zone";
+            statusCode = 400;
+        }
+        else {
+            WateringZoneConfig zone = cfg.zones[index];
+            auto param = [&](const char *name, long fallback) -> long {
+                return req->hasParam(name) ? req->getParam(name)->value().toInt() : fallback;
+            };
+
+            zone.enabled    = param("enabled", zone.enabled);
+            zone.probe      = param("probe", zone.probe);
+            zone.start      = param("start", zone.start);
+            zone.target     = param("target", zone.target);
+            zone.limit      = param("limit", zone.limit);
+            zone.pulseMs    = param("pulse_ms", zone.pulseMs);
+            zone.pulseMinMs = param("pulse_min_ms", zone.pulseMinMs);
+            zone.pulseMaxMs = param("pulse_max_ms", zone.pulseMaxMs);
+            zone.soakMs     = param("soak_ms", zone.soakMs);
+            zone.maxPulses  = param("max_pulses", zone.maxPulses);
+            zone.priority   = param("priority", zone.priority);
+
+            if (zone.probe >= SOIL_PROBES ||
+                !(zone.start < zone.target && zone.target <= zone.limit && zone.limit <= 100) ||
+                zone.pulseMinMs == 0 || zone.pulseMinMs > zone.pulseMaxMs || zone.maxPulses == 0) {
+                message = "Invalid zone settings";
+                statusCode = 400;
+            }
+            else {
+                cfg.zones[index] = zone;
+                changed = true;
+            }
+        }
+    }
+
+    if (statusCode == 200 && changed) {
+        lfsprog.changeWateringConfig(cfg);
+        wateringSys.events.notify(WATERING_EV_CONFIG);
+    }
+
+    lfsprog.wateringToJson(cfg, doc.to<JsonObject>());
+    unsigned long now = millis();
+    const auto &sched = wateringSys.scheduler;
+
+    const RainFilter &rf = raincheck.filter;
+    JsonObject rain = doc["rain"];
+    rain["level"]          = rf.level();
+    rain["raining"]        = rf.raining();
+    rain["deferred"]       = rf.deferred(now);
+    rain["defer_left_s"]   = rf.deferRemaining(now) / 1000;
+    rain["rain_24h_s"]     = rf.rainSeconds24h();
+    rain["soaked"]         = rf.soaked();
+    rain["episodes"]       = rf.episodes;
+
+    JsonObject events = doc.createNestedObject("events");
+    events["posted"]          = wateringSys.events.posted.load();
+    events["coalesced"]       = wateringSys.events.coalesced.load();
+    events["overflowed"]      = wateringSys.events.overflowed.load();
+    events["wakeups"]         = wateringSys.wakeups;
+    events["wakeups_per_min"] = wateringSys.wakeupsLastMinute;
+    events["last_latency_us"] = wateringSys.lastLatencyUs;
+    events["max_latency_us"]  = wateringSys.maxLatencyUs;
+
+    JsonObject scheduler = doc.createNestedObject("scheduler");
+    scheduler["active"]            = sched.active();
+    scheduler["queued"]            = sched.waiting();
+    scheduler["serviced"]          = sched.serviced;
+    scheduler["serviced_per_hour"] = round(sched.servicedPerHour(now) * 100.0) / 100.0;
+
+    const DemandForecast &fc = wateringSys.forecast;
+    uint32_t clock = WateringSys::localTime();
+    JsonObject forecast = doc.createNestedObject("forecast");
+    forecast["vpd_kpa"]       = fc.currentVpd();
+    forecast["k"]             = fc.k();
+    forecast["rate_pct_h"]    = fc.rate();
+    forecast["samples"]       = fc.samples;
+    forecast["fits"]          = fc.fits;
+    forecast["crossing"]      = fc.crossing;
+    forecast["crossing_in_s"] = (fc.crossing > clock && clock) ? fc.crossing - clock : 0;
+    forecast["planned"]       = fc.planned;
+    forecast["planned_in_s"]  = (fc.planned > clock && clock) ? fc.planned - clock : 0;
+
+    JsonArray zones = doc["zones"];
+    for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+        const PulseSoakController &ctl = wateringSys.zones[i];
+        const ZoneWaitStats &wait = sched.stats[i];
+        JsonObject live = zones[i].createNestedObject("live");
+        live["state"]          = PulseSoakController::stateText(ctl.state());
+        live["moisture"]       = wateringSys.zoneMoisture(i);
+        live["gain"]           = ctl.gain();
+        live["pulses"]         = ctl.pulses();
+        live["pulse_ms"]       = ctl.pulseLength();
+        live["cycle_water_ms"] = ctl.cycleWaterMs;
+        live["total_water_ms"] = ctl.totalWaterMs;
+        live["cycles"]         = ctl.cycles;
+        live["queued"]         = sched.queued(i);
+        live["waiting_ms"]     = sched.waitingFor(i, now);
+        live["services"]       = wait.services;
+        live["last_wait_ms"]   = wait.lastWaitMs;
+        live["avg_wait_ms"]    = wait.averageWaitMs();
+        live["max_wait_ms"]    = wait.maxWaitMs;
+    }
+
+    doc["status"] = statusCode;
+    doc["message"] = message;
+    serializeJson(doc, resBuffer);
+
+    this->send(req, statusCode, APPJSON, resBuffer);
+}
+
+/**
+ * @brief Cron-style watering schedules.
+ * @details
+ * - `GET /schedules` lists the schedules with their next start (local time).
+ * - `expr`, `duration` (minutes), `zones` (relay bitmask), `catchup=skip|late|once` adds one.
+ * - `id=N&remove=1` removes one, `id=N&enabled=0|1` disables or enables one.
+ * - `time=<unix seconds>` sets the clock (AP mode has no SNTP); a value that is
+ *   not a plain number from SCHEDULE_CLOCK_MIN up to the end of the time_t
+ *   range is refused, and nothing else in the request is applied.
+ * A change restarts the schedules: a running window is closed.
+ */
+void WebServerClass::Schedules(AsyncWebServerRequest *req) {
+    DynamicJsonDocument doc(2048);
+    String resBuffer = "", message = "OK";
+    int statusCode = 200;
+
+    ScheduleEngine engine;
+    lfsprog.readSchedules(engine);
+    bool changed = false;
+
+    if (req->hasParam("time")) {
+        // toInt() would turn garbage into 0 (1970) and wrap after 2038
+        const String &text = req->getParam("time")->value();
+        char *end = nullptr;
+        unsigned long long seconds = strtoull(text.c_str(), &end, 10);
+        if (!isdigit((unsigned char) text[0]) || *end != '\0' || seconds < SCHEDULE_CLOCK_MIN || seconds > UINT32_MAX ||
+            (unsigned long long) (time_t) seconds != seconds) {
+            message = "Invalid time";
+            statusCode = 400;
+        }
+        else {
+            struct timeval tv = { (time_t) seconds, 0 };
+            settimeofday(&tv, nullptr);
+            wateringSys.events.notify(WATERING_EV_SCHEDULES); // recompute the next starts from the new clock
+        }
+    }
+
+    if (statusCode != 200) {
+        // Invalid clock: nothing else is applied
+    }
+    else if (req->hasParam("expr")) {
+        WateringSchedule item;
+        strlcpy(item.expr, req->getParam("expr")->value().c_str(), sizeof(item.expr));
+        if (req->hasParam("duration")) item.duration = req->getParam("duration")->value().toInt();
+        if (req->hasParam("zones")) item.zones = req->getParam("zones")->value().toInt() & WATERING_ZONES_MASK;
+        if (req->hasParam("catchup"))
+            item.catchup = ScheduleEngine::catchupFromText(req->getParam("catchup")->value().c_str());
+
+        if (item.duration == 0 || !item.zones) {
+            message = "Invalid schedule settings";
+            statusCode = 400;
+        }
+        else if (engine.add(item) < 0) {
+            message = engine.count >= SCHEDULE_MAX ? "Schedule list is full" : "Invalid expression";
+            statusCode = 400;
+        }
+        else {
+            changed = true;
+        }
+    }
+    else if (req->hasParam("id")) {
+        int index = req->getParam("id")->value().toInt();
+        if (index < 0 || index >= engine.count) {
+            message = "Invalid id";
+            statusCode = 400;
+        }
+        else if (req->hasParam("remove")) {
+            engine.remove(index);
+            changed = true;
+        }
+        else if (req->hasParam("enabled")) {
+            engine.items[index].enabled = req->getParam("enabled")->value().toInt();
+            changed = true;
+        }
+    }
+
+    if (statusCode == 200 && changed) {
+        lfsprog.changeSchedules(engine);
+        wateringSys.events.notify(WATERING_EV_SCHEDULES);
+    }
+
+    lfsprog.schedulesToJson(engine, doc.to<JsonObject>());
+    uint32_t now = WateringSys::localTime();
+    doc["time"] = now;
+
+    // Live state is only meaningful while the list matches the running one
+    JsonArray list = doc["schedules"];
+    bool live = !changed && engine.count == wateringSys.schedules.count;
+    for (uint8_t i = 0; i < engine.count; i++) {
+        uint32_t next = live ? wateringSys.schedules.next(i) : 0;
+        list[i]["next"]      = next;
+        list[i]["next_in_s"] = (next && now && next > now) ? next - now : 0;
+        list[i]["running"]   = live && wateringSys.schedules.running(i);
+    }
+
+    doc["status"] = statusCode;
+    doc["message"] = message;
+    serializeJson(doc, resBuffer);
+
+    this->send(req, statusCode, APPJSON, resBuffer);
+}
+
+/**
+ * @brief User watering rules.
+ * @details
+ * - `GET /rules` lists the rules with their bytecode size, inputs and last result.
+ * - `rule=<text>` adds one, e.g. `soil < 25 and hour >= 6 -> zone1 on for 120s`
+ *   or `rain >= 50 -> hold for 3600`. It is compiled first and rejected on a syntax error.
+ * - `id=N&remove=1` removes one, `id=N&enabled=0|1` disables or enables one.
+ * A change recompiles the rules: running rule windows and a hold are ended.
+ */
+void WebServerClass::Rules(AsyncWebServerRequest *req) {
+    DynamicJsonDocument doc(3072);
+    String resBuffer = "", message = "OK";
+    int statusCode = 200;
+
+    RuleEngine engine;
+    lfsprog.readRules(engine);
+    bool changed = false;
+
+    if (req->hasParam("rule")) {
+        String text = req->getParam("rule")->value();
+        Rule rule;
+        if (text.length() >= RULE_TEXT_LEN || !engine.compile(text.c_str(), rule, WATERING_ZONES)) {
+            message = "Invalid rule";
+            statusCode = 400;
+        }
+        else if (engine.count >= RULE_MAX) {
+            message = "Rule list is full";
+            statusCode = 400;
+        }
+        else {
+            lfsprog.addRule(text);
+            changed = true;
+        }
+    }
+    else if (req->hasParam("id")) {
+        int index = req->getParam("id")->value().toInt();
+        if (index < 0 || index >= engine.count) {
+            message = "Invalid id";
+            statusCode = 400;
+        }
+        else if (req->hasParam("remove")) {
+            lfsprog.removeRule(index);
+            changed = true;
+        }
+        else if (req->hasParam("enabled")) {
+            lfsprog.enableRule(index, req->getParam("enabled")->value().toInt());
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        lfsprog.readRules(engine);
+        wateringSys.events.notify(WATERING_EV_RULES);
+    }
+
+    lfsprog.rulesToJson(doc.to<JsonObject>());
+
+    // Live state is only meaningful while the list matches the running one
+    JsonArray list = doc["rules"];
+    bool live = !changed && engine.count == wateringSys.rules.count;
+    for (uint8_t i = 0; i < engine.count && i < list.size(); i++) {
+        const Rule &rule = engine.rules[i];
+        list[i]["bytes"] = rule.length;
+        JsonArray inputs = list[i].createNestedArray("inputs");
+        for (uint8_t in = 0; in < RULE_INPUTS; in++)
+            if (rule.inputs & (1 << in)) inputs.add(RuleEngine::inputName(in));
+        list[i]["state"] = live && wateringSys.rules.rules[i].state;
+    }
+
+    JsonObject stats = doc.createNestedObject("stats");
+    stats["evaluations"] = wateringSys.rules.evaluations;
+    stats["skipped"]     = wateringSys.rules.skipped;
+    stats["held"]        = wateringSys.held();
+
+    doc["status"] = statusCode;
+    doc["message"] = message;
+    serializeJson(doc, resBuffer);
+
+    this->send(req, statusCode, APPJSON, resBuffer);
+}
+
+static void sessionToJson(const WateringSession &item, JsonObject obj) {
+    obj["start"]      = item.start;
+    obj["end"]        = item.end;
+    obj["trigger"]    = SessionLog::triggerText(item.trigger);
+    obj["relays"]     = item.relays;
+    obj["on_s"]       = item.onSeconds;
+    obj["before"]     = item.before;
+    obj["after"]      = item.after;
+    obj["gain"]       = item.gain();
+    obj["peak_rate"]  = item.peakRate;
+    obj["litres"]     = item.litres;
+    obj["metered"]    = item.metered;
+    obj["efficiency"] = item.efficiency();
+}
+
+/**
+ * @brief Recorded watering sessions.
+ * @details
+ * - `GET /sessions` lists the recent sessions (newest first), the session in
+ *   progress and the per-day totals. `limit=N` shortens the list.
+ * - Efficiency is moisture points gained per litre; the litres are measured
+ *   by the flow meters when fitted, else estimated from the relay on-time and
+ *   WATERING_FLOW_LPM (`metered` tells which).
+ */
+void WebServerClass::Sessions(AsyncWebServerRequest *req) {
+    DynamicJsonDocument doc(6144);
+    String resBuffer = "";
+    const SessionLog &log = wateringSys.sessions;
+
+    uint8_t limit = log.size;
+    if (req->hasParam("limit"))
+        limit = constrain(req->getParam("limit")->value().toInt(), 0, (int) log.size);
+
+    JsonArray list = doc.createNestedArray("sessions");
+    for (uint8_t i = 0; i < limit; i++)
+        sessionToJson(log.recent(i), list.createNestedObject());
+
+    if (log.active())
+        sessionToJson(log.current(), doc.createNestedObject("active"));
+    else
+        doc["active"] = nullptr;
+
+    float litres = 0, gain = 0;
+    JsonArray days = doc.createNestedArray("days");
+    for (const auto &day : log.days) {
+        if (!day.day) continue;
+        JsonObject item = days.createNestedObject();
+        item["day"]        = day.day;
+        item["sessions"]   = day.sessions;
+        item["on_s"]       = day.onSeconds;
+        item["litres"]     = day.litres;
+        item["gain"]       = day.gain;
+        item["efficiency"] = day.efficiency();
+        litres += day.litres;
+        gain   += day.gain;
+    }
+
+    JsonObject totals = doc.createNestedObject("totals");
+    totals["sessions"]   = log.total;
+    totals["litres"]     = litres;
+    totals["gain"]       = gain;
+    totals["efficiency"] = litres > 0 ? gain / litres : NAN;
+    totals["flow_lpm"]   = log.flowLpm;
+
+    doc["status"] = 200;
+    doc["message"] = "OK";
+    serializeJson(doc, resBuffer);
+
+    this->send(req, 200, APPJSON, resBuffer);
+}
+
+/**
+ * @brief Flow meters of the watering zones.
+ * @details
+ * - `GET /flow` returns the flow rate, the water used since boot and the
+ *   flow fault of every zone, and the zones locked out after a dry run.
+ * - `clear=1` clears the faults; the sensor task serves the request on its
+ *   next counter read and the watering task releases the zones.
+ * Answers 404 when the board is built without FLOW_METER_ENABLE.
+ */
+void WebServerClass::Flow(AsyncWebServerRequest *req) {
+    DynamicJsonDocument doc(1024);
+    String resBuffer = "", message = "OK";
+    int statusCode = 200;
+
+#if FLOW_METER_ENABLE
+    if (req->hasParam("clear") && req->getParam("clear")->value().toInt())
+        flowmeter.clearRequest = true;
+
+    JsonArray list = doc.createNestedArray("zones");
+    for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+        const FlowChannel &ch = flowmeter.channels[i];
+        JsonObject item = list.createNestedObject();
+        item["zone"]   = i;
+        item["lpm"]    = ch.lpm;
+        item["litres"] = ch.litres;
+        item["fault"]  = flowFaultText(ch.fault);
+    }
+    doc["lpm"]     = flowmeter.totalLpm();
+    doc["litres"]  = flowmeter.totalLitres();
+    doc["lockout"] = wateringSys.flowLockout();
+    doc["pulses_per_litre"] = flowmeter.pulsesPerLitre;
+#else
+    message = "Flow meters not fitted";
+    statusCode = 404;
+#endif
+
+    doc["status"] = statusCode;
+    doc["message"] = message;
+    serializeJson(doc, resBuffer);
+
+    this->send(req, statusCode, APPJSON, resBuffer);
+}
@@ -29,9 +29,8 @@ void WebServerClass::WiFi_AP_Config_Main(AsyncWebServerRequest *req) {
 }
 
 void WebServerClass::Save_WiFi_AP_Config(AsyncWebServerRequest *req) {
-    // read file html
-    String page = this->file_buffer(DIRHTML + "save_config_wifi_ap.html");
-    if (page == "") {
+    auto page = std::make_shared<WebTemplate>();
+    if (!this->openPage(*page, DIRHTML + "save_config_wifi_ap.html")) {
         this->handleNotFound(req);
         return;
     }
@@ -48,89 +47,43 @@ void WebServerClass::Save_WiFi_AP_Config(AsyncWebServerRequest *req) {
     clientIP = req->client()->localIP();
     LocalIP = clientIP.toString();
 
-    const char *placeholders[] = {
-        "%VERSION_PROJECT%",
-        "%NEW_SSID%",
-        "%NEW_PASS%",
-        "%LOCALIP%"
-    };
+    page->set(TPL_VERSION_PROJECT, this->__VERSION_PROJECT__);
+    page->set(TPL_NEW_SSID, New_SSID);
+    page->set(TPL_NEW_PASS, New_Pass);
+    page->set(TPL_LOCALIP, this->LocalIP);
 
-    const char *tags_html[] = {
-        this->__VERSION_PROJECT__.c_str(),
-        New_SSID.c_str(),
-        New_Pass.c_str(),
-        this->LocalIP.c_str()
-    };
-
-    // replace page
-    for (size_t i = 0; i < sizeof(tags_html)/sizeof(tags_html[0]); i++)
-        page.replace(placeholders[i], tags_html[i]);
-
-    req->send(200, TEXTHTML, page);
+    this->sendTemplate(req, page);
 }
 
 void WebServerClass::wifi_ap_config_1(AsyncWebServerRequest *req) {
-    // read file html
-    String page = this->file_buffer(DIRHTML + "config_wifi_ap_1.html");
-    if (page == "") {
+    auto page = std::make_shared<WebTemplate>();
+    if (!this->openPage(*page, DIRHTML + "config_wifi_ap_1.html")) {
         this->handleNotFound(req);
         return;
     }
 
-    const char *placeholders[] = {
-        "%VERSION_PROJECT%",
-        "%VERSION_PROJECT%",
-        "%SSID_AP%",
-        "%PASS_AP%",
-        "%SSID_AP%"
-    };
-
-    const char *tags_html[] = {
-        this->__VERSION_PROJECT__.c_str(),
-        this->__VERSION_PROJECT__.c_str(),
-        ProgramWiFi.__SSID_AP__.c_str(),
-        ProgramWiFi.__PASS_AP__.c_str(),
-        ProgramWiFi.__SSID_AP__.c_str()
-    };
+    page->set(TPL_VERSION_PROJECT, this->__VERSION_PROJECT__);
+    page->set(TPL_SSID_AP, ProgramWiFi.__SSID_AP__);
+    page->set(TPL_PASS_AP, ProgramWiFi.__PASS_AP__);
 
-    // replace page
-    for (size_t i = 0; i < sizeof(tags_html)/sizeof(tags_html); i++)
-        page.replace(placeholders[i], tags_html[i]);
-
-    req->send(200, TEXTHTML, page);
+    this->sendTemplate(req, page);
 }
 
 void WebServerClass::wifi_ap_config_2(AsyncWebServerRequest *req) {
-    // read file html
-    String page = file_buffer(DIRHTML + "config_wifi_ap_2.html");
-    if (page == "") {
+    auto page = std::make_shared<WebTemplate>();
+    if (!this->openPage(*page, DIRHTML + "config_wifi_ap_2.html")) {
         this->handleNotFound(req);
         return;
     }
 
-    // get IP Address
+    // get ip address
     clientIP = req->client()->localIP();
     LocalIP = clientIP.toString();
 
-    const char *placeholders[] = {
-        "%VERSION_PROJECT%",
-        "%VERSION_PROJECT%",
-        "%SSID_AP%",
-        "%PASS_AP%",
-        "%LOCALIP%"
-    };
-
-    const char *tags_html[] = {
-        this->__VERSION_PROJECT__.c_str(),
-        this->__VERSION_PROJECT__.c_str(),
-        ProgramWiFi.__SSID_AP__.c_str(),
-        ProgramWiFi.__PASS_AP__.c_str(),
-        this->LocalIP.c_str()
-    };
+    page->set(TPL_VERSION_PROJECT, this->__VERSION_PROJECT__);
+    page->set(TPL_SSID_AP, ProgramWiFi.__SSID_AP__);
+    page->set(TPL_PASS_AP, ProgramWiFi.__PASS_AP__);
+    page->set(TPL_LOCALIP, this->LocalIP);
 
-    // replace page
-    for (size_t i = 0; i < sizeof(tags_html)/sizeof(tags_html[0]); i++)
-        page.replace(placeholders[i], tags_html[i]);
-    
-    req->send(200, TEXTHTML, page);
+    this->sendTemplate(req, page);
 }
\ No newline at end of file
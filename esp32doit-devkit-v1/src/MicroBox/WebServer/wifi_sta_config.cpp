@@ -29,9 +29,8 @@ void WebServerClass::WiFi_STA_Config_Main(AsyncWebServerRequest *req) {
 }
 
 void WebServerClass::Save_WiFi_STA_Config(AsyncWebServerRequest *req) {
-    // read file html
-    String page = this->file_buffer(DIRHTML + "save_config_wifi_sta.html");
-    if (page == "") {
+    auto page = std::make_shared<WebTemplate>();
+    if (!this->openPage(*page, DIRHTML + "save_config_wifi_sta.html")) {
         this->handleNotFound(req);
         return;
     }
@@ -46,64 +45,33 @@ void WebServerClass::Save_WiFi_STA_Config(AsyncWebServerRequest *req) {
 
     // get ip address
     clientIP = req->client()->localIP();
-    LocalIP  = clientIP.toString();
-
-    const char *placeholders[] = {
-        "%VERSION_PROJECT%",
-        "%NEW_SSID%",
-        "%NEW_PASS%",
-        "%LOCALIP%"
-    };
-
-    const char *tags_html[] = {
-        this->__VERSION_PROJECT__.c_str(),
-        New_SSID.c_str(),
-        New_Pass.c_str(),
-        this->LocalIP.c_str()
-    };
+    LocalIP = clientIP.toString();
 
-    // replace page
-    for (size_t i = 0; i < sizeof(tags_html)/sizeof(tags_html[0]); i++)
-        page.replace(placeholders[i], tags_html[i]);
+    page->set(TPL_VERSION_PROJECT, this->__VERSION_PROJECT__);
+    page->set(TPL_NEW_SSID, New_SSID);
+    page->set(TPL_NEW_PASS, New_Pass);
+    page->set(TPL_LOCALIP, this->LocalIP);
 
-    req->send(200, TEXTHTML, page);
+    this->sendTemplate(req, page);
 }
 
 void WebServerClass::wifi_sta_config_1(AsyncWebServerRequest *req) {
-    // read file html
-    String page = this->file_buffer(DIRHTML + "config_wifi_sta_1.html");
-    if (page == "") {
+    auto page = std::make_shared<WebTemplate>();
+    if (!this->openPage(*page, DIRHTML + "config_wifi_sta_1.html")) {
         this->handleNotFound(req);
         return;
     }
 
-    const char *placeholders[] = {
-        "%VERSION_PROJECT%",
-        "%VERSION_PROJECT%",
-        "%SSID_AP%", 
-        "%PASS_AP%",
-        "%SSID_AP%"
-    };
-
-    const char *tags_html[] = {
-        this->__VERSION_PROJECT__.c_str(),
-        this->__VERSION_PROJECT__.c_str(),
-        ProgramWiFi.__SSID_AP__.c_str(),
-        ProgramWiFi.__PASS_AP__.c_str(),
-        ProgramWiFi.__SSID_AP__.c_str()
-    };
+    page->set(TPL_VERSION_PROJECT, this->__VERSION_PROJECT__);
+    page->set(TPL_SSID_AP, ProgramWiFi.__SSID_AP__);
+    page->set(TPL_PASS_AP, ProgramWiFi.__PASS_AP__);
 
-    // replace page
-    for (size_t i = 0; i < sizeof(tags_html)/sizeof(tags_html[0]); i++)
-        page.replace(placeholders[i], tags_html[i]);
-
-    req->send(200, TEXTHTML, page);
+    this->sendTemplate(req, page);
 }
 
 void WebServerClass::wifi_sta_config_2(AsyncWebServerRequest *req) {
-    // read file html
-    String page = file_buffer(DIRHTML + "config_wifi_sta_2.html");
-    if (page == "") {
+    auto page = std::make_shared<WebTemplate>();
+    if (!this->openPage(*page, DIRHTML + "config_wifi_sta_2.html")) {
         this->handleNotFound(req);
         return;
     }
@@ -112,25 +80,10 @@ void WebServerClass::wifi_sta_config_2(AsyncWebServerRequest *req) {
     clientIP = req->client()->localIP();
     LocalIP = clientIP.toString();
 
-    const char *placeholders[] = {
-        "%VERSION_PROJECT%",
-        "%VERSION_PROJECT%",
-        "%SSID_STA%",
-        "%PASS_STA%",
-        "%LOCALIP%"
-    };
-
-    const char *tags_html[] = {
-        this->__VERSION_PROJECT__.c_str(),
-        this->__VERSION_PROJECT__.c_str(),
-        ProgramWiFi.__SSID_STA__.c_str(),
-        ProgramWiFi.__PASS_STA__.c_str(),
-        this->LocalIP.c_str()
-    };
-
-    // replace page
-    for (size_t i = 0; i < sizeof(tags_html)/sizeof(tags_html[0]); i++)
-        page.replace(placeholders[i], tags_html[i]);
+    page->set(TPL_VERSION_PROJECT, this->__VERSION_PROJECT__);
+    page->set(TPL_SSID_STA, ProgramWiFi.__SSID_STA__);
+    page->set(TPL_PASS_STA, ProgramWiFi.__PASS_STA__);
+    page->set(TPL_LOCALIP, this->LocalIP);
 
-    req->send(200, TEXTHTML, page);
+    this->sendTemplate(req, page);
 }
\ No newline at end of file
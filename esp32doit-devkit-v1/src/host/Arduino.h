@@ -0,0 +1,213 @@
+/**
+ *  @file Arduino.h
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Host stand-in for the Arduino core (env:native). The firmware sources are
+ *  compiled unchanged against it: GPIO, ADC, time and the serial port go
+ *  through HostHal, so a program on host decides what the pins read and how
+ *  fast the clock runs.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+
+#include "WString.h"
+#include "HostHal.h"
+// Like Arduino-ESP32, the FreeRTOS task API comes with Arduino.h
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define HIGH         0x1
+#define LOW          0x0
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+#define DEC 10
+#define HEX 16
+
+#define LED_BUILTIN  2
+#define BUILTIN_LED  LED_BUILTIN
+
+#define PROGMEM
+#define F(string_literal) (string_literal)
+
+typedef uint8_t byte;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+using std::min;
+using std::max;
+using std::isnan;
+using std::isinf;
+
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+// newlib (ESP32) has strlcpy, older glibc does not
+inline size_t strlcpy(char *dst, const char *src, size_t size) {
+    size_t len = strlen(src);
+    if (size) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = 0;
+    }
+    return len;
+}
+#endif
+
+inline unsigned long millis() { return HostHal::micros() / 1000; }
+inline unsigned long micros() { return HostHal::micros(); }
+inline void delay(unsigned long ms) { HostHal::advance(ms * 1000ULL); }
+inline void delayMicroseconds(unsigned int us) { HostHal::advance(us); }
+inline void yield() {}
+
+inline void pinMode(uint8_t pin, uint8_t mode) { HostHal::pinMode(pin, mode); }
+inline void digitalWrite(uint8_t pin, uint8_t val) { HostHal::digitalWrite(pin, val); }
+inline int digitalRead(uint8_t pin) { return HostHal::digitalRead(pin); }
+inline uint16_t analogRead(uint8_t pin) { return HostHal::analogRead(pin); }
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    const long dividend = out_max - out_min;
+    const long divisor = in_max - in_min;
+    const long delta = x - in_min;
+    if (divisor == 0) return -1;
+    return (delta * dividend + (divisor / 2)) / divisor + out_min;
+}
+
+/**
+ * @class Print
+ * @brief Arduino Print: everything is formatted and handed to `write()`.
+ */
+class Print {
+    public:
+        virtual ~Print() {}
+        virtual size_t write(uint8_t c) = 0;
+        virtual size_t write(const uint8_t *buffer, size_t size) {
+            size_t n = 0;
+            while (size--) n += this->write(*buffer++);
+            return n;
+        }
+        size_t write(const char *str) { return this->write((const uint8_t *) str, strlen(str)); }
+        virtual void flush() {}
+
+        size_t print(const char *str) { return this->write(str); }
+        size_t print(const String &str) { return this->write((const uint8_t *) str.c_str(), str.length()); }
+        size_t print(char c) { return this->write((uint8_t) c); }
+        size_t print(int n, int base = DEC) { return this->print((long long) n, base); }
+        size_t print(unsigned int n, int base = DEC) { return this->print((unsigned long long) n, base); }
+        size_t print(long n, int base = DEC) { return this->print((long long) n, base); }
+        size_t print(unsigned long n, int base = DEC) { return this->print((unsigned long long) n, base); }
+        size_t print(long long n, int base = DEC) {
+            return base == DEC ? this->printf("%lld", n) : this->printf("%llx", n);
+        }
+        size_t print(unsigned long long n, int base = DEC) {
+            return base == DEC ? this->printf("%llu", n) : this->printf("%llx", n);
+        }
+        size_t print(double n, int digits = 2) { return this->printf("%.*f", digits, n); }
+
+        size_t println() { return this->write("\r\n"); }
+        template <typename T>
+        size_t println(const T &x) { return this->print(x) + this->println(); }
+        template <typename T>
+        size_t println(const T &x, int format) { return this->print(x, format) + this->println(); }
+
+        size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+            char buf[256];
+            va_list args;
+            va_start(args, format);
+            int len = vsnprintf(buf, sizeof(buf), format, args);
+            va_end(args);
+            if (len < 0) return 0;
+            if ((size_t) len < sizeof(buf)) return this->write((const uint8_t *) buf, len);
+
+            std::unique_ptr<char[]> big(new char[len + 1]);
+            va_start(args, format);
+            vsnprintf(big.get(), len + 1, format, args);
+            va_end(args);
+            return this->write((const uint8_t *) big.get(), len);
+        }
+};
+
+/**
+ * @class Stream
+ * @brief Arduino Stream (byte source on top of Print).
+ */
+class Stream : public Print {
+    public:
+        virtual int available() { return 0; }
+        virtual int read() { return -1; }
+        virtual int peek() { return -1; }
+        virtual size_t readBytes(char *buffer, size_t length) {
+            size_t n = 0;
+            int c;
+            while (n < length && (c = this->read()) >= 0) buffer[n++] = (char) c;
+            return n;
+        }
+        String readString() {
+            String ret;
+            int c;
+            while ((c = this->read()) >= 0) ret += (char) c;
+            return ret;
+        }
+};
+
+/**
+ * @class HardwareSerial
+ * @brief Serial port: the output is dropped unless HostHal::serialEcho is set.
+ */
+class HardwareSerial : public Stream {
+    public:
+        void begin(unsigned long baud) { (void) baud; }
+        using Print::write;
+        size_t write(uint8_t c) override { return this->write(&c, 1); }
+        size_t write(const uint8_t *buffer, size_t size) override {
+            if (HostHal::serialEcho) fwrite(buffer, 1, size, stderr);
+            return size;
+        }
+};
+
+extern HardwareSerial Serial;
+
+/**
+ * @class EspClass
+ * @brief Chip information and restart (a restart request is only recorded).
+ */
+class EspClass {
+    public:
+        void restart() { HostHal::restarts++; }
+        uint32_t getFreeHeap() { return 0; }
+        uint32_t getMinFreeHeap() { return 0; }
+        uint32_t getMaxAllocHeap() { return 0; }
+        uint32_t getHeapSize() { return 0; }
+};
+
+extern EspClass ESP;
@@ -0,0 +1,93 @@
+/**
+ *  @file DHT_U.h
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Host stand-in for the Adafruit unified DHT driver (env:native): the readings are HostHal::temperature and HostHal::humidity.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <Arduino.h>
+#include "DHT.h"
+
+typedef struct {
+    char name[12];
+    int32_t version;
+    int32_t sensor_id;
+    int32_t type;
+    float max_value;
+    float min_value;
+    float resolution;
+    int32_t min_delay;
+} sensor_t;
+
+typedef struct {
+    int32_t version;
+    int32_t sensor_id;
+    int32_t type;
+    int32_t timestamp;
+    float temperature;
+    float relative_humidity;
+} sensors_event_t;
+
+class DHT_Unified {
+    public:
+        DHT_Unified(uint8_t pin, uint8_t type) { (void) pin; (void) type; }
+        void begin() {}
+
+        class Temperature {
+            public:
+                bool getEvent(sensors_event_t *event) {
+                    memset(event, 0, sizeof(*event));
+                    event->temperature = HostHal::temperature;
+                    return !isnan(event->temperature);
+                }
+                void getSensor(sensor_t *sensor) {
+                    memset(sensor, 0, sizeof(*sensor));
+                    strncpy(sensor->name, "DHT22", sizeof(sensor->name) - 1);
+                    sensor->max_value = 125;
+                    sensor->min_value = -40;
+                    sensor->resolution = 0.1;
+                    sensor->min_delay = 2000000L;
+                }
+        };
+
+        class Humidity {
+            public:
+                bool getEvent(sensors_event_t *event) {
+                    memset(event, 0, sizeof(*event));
+                    event->relative_humidity = HostHal::humidity;
+                    return !isnan(event->relative_humidity);
+                }
+                void getSensor(sensor_t *sensor) {
+                    memset(sensor, 0, sizeof(*sensor));
+                    strncpy(sensor->name, "DHT22", sizeof(sensor->name) - 1);
+                    sensor->max_value = 100;
+                    sensor->min_value = 0;
+                    sensor->resolution = 0.1;
+                    sensor->min_delay = 2000000L;
+                }
+        };
+
+        Temperature temperature() { return Temperature(); }
+        Humidity humidity() { return Humidity(); }
+};
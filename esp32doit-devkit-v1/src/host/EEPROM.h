@@ -0,0 +1,60 @@
+/**
+ *  @file EEPROM.h
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Host stand-in for the ESP32 EEPROM emulation (env:native), kept in RAM.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <Arduino.h>
+
+class EEPROMClass {
+    uint8_t _data[4096] = {};
+    size_t _size = 0;
+
+    public:
+        bool begin(size_t size) { this->_size = min(size, sizeof(this->_data)); return true; }
+        void end() {}
+        bool commit() { return true; }
+        size_t length() const { return this->_size; }
+
+        uint8_t read(int address) const {
+            return (address >= 0 && (size_t) address < this->_size) ? this->_data[address] : 0;
+        }
+        void write(int address, uint8_t value) {
+            if (address >= 0 && (size_t) address < this->_size) this->_data[address] = value;
+        }
+
+        template <typename T>
+        T &get(int address, T &value) const {
+            if (address >= 0 && address + sizeof(T) <= this->_size) memcpy(&value, this->_data + address, sizeof(T));
+            return value;
+        }
+        template <typename T>
+        const T &put(int address, const T &value) {
+            if (address >= 0 && address + sizeof(T) <= this->_size) memcpy(this->_data + address, &value, sizeof(T));
+            return value;
+        }
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,99 @@
+/**
+ *  @file FS.h
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Host stand-in for the ESP32 `fs::FS` / `fs::File` (env:native): paths are
+ *  resolved under HostHal::fsRoot, so the firmware reads and writes real
+ *  files in a host directory.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+struct FileImpl;
+
+/**
+ * @class File
+ * @brief Open file or directory; copies share the same handle (closed by the last one).
+ */
+class File : public Stream {
+    std::shared_ptr<FileImpl> _impl;
+
+    public:
+        File() {}
+        explicit File(std::shared_ptr<FileImpl> impl) : _impl(impl) {}
+
+        using Print::write;
+        size_t write(uint8_t c) override;
+        size_t write(const uint8_t *buf, size_t size) override;
+        int available() override;
+        int read() override;
+        int peek() override;
+        void flush() override;
+        size_t read(uint8_t *buf, size_t size);
+        size_t readBytes(char *buffer, size_t length) override { return this->read((uint8_t *) buffer, length); }
+        bool seek(uint32_t pos);
+        size_t position() const;
+        size_t size() const;
+        void close();
+        operator bool() const;
+        const char *path() const;
+        const char *name() const;
+        bool isDirectory() const;
+        File openNextFile(const char *mode = FILE_READ);
+};
+
+/**
+ * @class FS
+ * @brief File system mounted on a host directory.
+ */
+class FS {
+    public:
+        File open(const char *path, const char *mode = FILE_READ, bool create = false);
+        File open(const String &path, const char *mode = FILE_READ, bool create = false) {
+            return this->open(path.c_str(), mode, create);
+        }
+        bool exists(const char *path);
+        bool exists(const String &path) { return this->exists(path.c_str()); }
+        bool remove(const char *path);
+        bool remove(const String &path) { return this->remove(path.c_str()); }
+        bool rename(const char *from, const char *to);
+        bool rename(const String &from, const String &to) { return this->rename(from.c_str(), to.c_str()); }
+        bool mkdir(const char *path);
+        bool mkdir(const String &path) { return this->mkdir(path.c_str()); }
+        bool rmdir(const char *path);
+        bool rmdir(const String &path) { return this->rmdir(path.c_str()); }
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
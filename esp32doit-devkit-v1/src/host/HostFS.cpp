@@ -0,0 +1,198 @@
+/**
+ *  @file HostFS.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <LittleFS.h>
+#include <stdio.h>
+#include <filesystem>
+#include <system_error>
+
+namespace stdfs = std::filesystem;
+
+fs::LittleFSFS LittleFS;
+
+namespace fs {
+
+struct FileImpl {
+    FILE *file = nullptr;
+    std::string path;           ///< Path on the board, e.g. "/config/relay.json"
+    std::string name;           ///< Last path component
+    bool directory = false;
+    std::vector<std::string> entries; ///< Directory listing (board paths)
+    size_t next = 0;
+
+    ~FileImpl() { if (this->file) fclose(this->file); }
+};
+
+static stdfs::path hostPath(const char *path) {
+    std::string relative = path ? path : "";
+    while (!relative.empty() && relative.front() == '/') relative.erase(0, 1);
+    return stdfs::path(HostHal::fsRoot) / relative;
+}
+
+size_t File::write(uint8_t c) { return this->write(&c, 1); }
+
+size_t File::write(const uint8_t *buf, size_t size) {
+    if (!this->_impl || !this->_impl->file) return 0;
+    return fwrite(buf, 1, size, this->_impl->file);
+}
+
+int File::available() {
+    if (!this->_impl || !this->_impl->file) return 0;
+    return (int) (this->size() - this->position());
+}
+
+int File::read() {
+    uint8_t c;
+    return this->read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+    if (!this->_impl || !this->_impl->file) return -1;
+    int c = fgetc(this->_impl->file);
+    if (c != EOF) ungetc(c, this->_impl->file);
+    return c == EOF ? -1 : c;
+}
+
+void File::flush() {
+    if (this->_impl && this->_impl->file) fflush(this->_impl->file);
+}
+
+size_t File::read(uint8_t *buf, size_t size) {
+    if (!this->_impl || !this->_impl->file) return 0;
+    return fread(buf, 1, size, this->_impl->file);
+}
+
+bool File::seek(uint32_t pos) {
+    if (!this->_impl || !this->_impl->file) return false;
+    return fseek(this->_impl->file, pos, SEEK_SET) == 0;
+}
+
+size_t File::position() const {
+    if (!this->_impl || !this->_impl->file) return 0;
+    long at = ftell(this->_impl->file);
+    return at < 0 ? 0 : (size_t) at;
+}
+
+size_t File::size() const {
+    if (!this->_impl || !this->_impl->file) return 0;
+    fflush(this->_impl->file);
+    std::error_code error;
+    uintmax_t size = stdfs::file_size(hostPath(this->_impl->path.c_str()), error);
+    return error ? 0 : (size_t) size;
+}
+
+void File::close() { this->_impl.reset(); }
+
+File::operator bool() const { return (bool) this->_impl; }
+
+const char *File::path() const { return this->_impl ? this->_impl->path.c_str() : nullptr; }
+
+const char *File::name() const { return this->_impl ? this->_impl->name.c_str() : nullptr; }
+
+bool File::isDirectory() const { return this->_impl && this->_impl->directory; }
+
+File File::openNextFile(const char *mode) {
+    if (!this->isDirectory()) return File();
+    while (this->_impl->next < this->_impl->entries.size()) {
+        File file = LittleFS.open(this->_impl->entries[this->_impl->next++].c_str(), mode);
+        if (file) return file;
+    }
+    return File();
+}
+
+File FS::open(const char *path, const char *mode, bool create) {
+    stdfs::path target = hostPath(path);
+    auto impl = std::make_shared<FileImpl>();
+    impl->path = path;
+    impl->name = target.filename().string();
+
+    std::error_code error;
+    bool reading = mode[0] == 'r';
+    if (reading && stdfs::is_directory(target, error)) {
+        impl->directory = true;
+        std::string base = impl->path;
+        if (base.empty() || base.back() != '/') base += '/';
+        for (const auto &entry : stdfs::directory_iterator(target, error))
+            impl->entries.push_back(base + entry.path().filename().string());
+        return File(impl);
+    }
+
+    if (!reading && create) stdfs::create_directories(target.parent_path(), error);
+    std::string fmode = std::string(mode) + "b";
+    impl->file = fopen(target.string().c_str(), fmode.c_str());
+    if (!impl->file) return File();
+
+    if (reading) HostHal::fsReads++;
+    else HostHal::fsWrites++;
+    return File(impl);
+}
+
+bool FS::exists(const char *path) {
+    std::error_code error;
+    return stdfs::exists(hostPath(path), error);
+}
+
+bool FS::remove(const char *path) {
+    std::error_code error;
+    stdfs::path target = hostPath(path);
+    return !stdfs::is_directory(target, error) && stdfs::remove(target, error);
+}
+
+bool FS::rename(const char *from, const char *to) {
+    std::error_code error;
+    stdfs::rename(hostPath(from), hostPath(to), error);
+    return !error;
+}
+
+bool FS::mkdir(const char *path) {
+    std::error_code error;
+    stdfs::create_directory(hostPath(path), error);
+    return !error;
+}
+
+bool FS::rmdir(const char *path) {
+    std::error_code error;
+    stdfs::path target = hostPath(path);
+    return stdfs::is_directory(target, error) && stdfs::remove(target, error);
+}
+
+bool LittleFSFS::begin(bool formatOnFail, const char *basePath, uint8_t maxOpenFiles, const char *partitionLabel) {
+    (void) formatOnFail; (void) basePath; (void) maxOpenFiles; (void) partitionLabel;
+    std::error_code error;
+    stdfs::create_directories(HostHal::fsRoot, error);
+    return stdfs::is_directory(HostHal::fsRoot, error);
+}
+
+bool LittleFSFS::format() {
+    std::error_code error;
+    for (const auto &entry : stdfs::directory_iterator(HostHal::fsRoot, error))
+        stdfs::remove_all(entry.path(), error);
+    return !error;
+}
+
+size_t LittleFSFS::usedBytes() {
+    std::error_code error;
+    size_t used = 0;
+    for (const auto &entry : stdfs::recursive_directory_iterator(HostHal::fsRoot, error))
+        if (entry.is_regular_file(error)) used += entry.file_size(error);
+    return used;
+}
+
+} // namespace fs
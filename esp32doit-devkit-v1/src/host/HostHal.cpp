@@ -0,0 +1,63 @@
+/**
+ *  @file HostHal.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <string.h>
+#include "HostHal.h"
+
+uint64_t HostHal::_us = 0;
+time_t HostHal::epoch = 0;
+uint8_t HostHal::level[HOST_PINS];
+uint8_t HostHal::mode[HOST_PINS];
+std::function<uint16_t (uint8_t pin)> HostHal::analog;
+float HostHal::temperature = NAN;
+float HostHal::humidity = NAN;
+bool HostHal::serialEcho = false;
+uint32_t HostHal::restarts = 0;
+std::string HostHal::fsRoot = "lfs";
+uint32_t HostHal::fsReads = 0;
+uint32_t HostHal::fsWrites = 0;
+
+HardwareSerial Serial;
+EspClass ESP;
+EEPROMClass EEPROM;
+
+void HostHal::reset() {
+    _us = 0;
+    epoch = 0;
+    memset(level, 0, sizeof(level));
+    memset(mode, 0, sizeof(mode));
+    restarts = 0;
+    fsReads = 0;
+    fsWrites = 0;
+}
+
+/**
+ * @brief Wall clock of the board (the firmware reads it through time()).
+ * @details Linked in place of the C library time() (POSIX hosts), so
+ *          WateringSys::localTime() follows the virtual clock. Before
+ *          `epoch` is set it counts from 1970, like the ESP32 before SNTP.
+ */
+extern "C" time_t time(time_t *t) {
+    time_t now = HostHal::epoch + (time_t) (HostHal::micros() / 1000000ULL);
+    if (t) *t = now;
+    return now;
+}
@@ -0,0 +1,81 @@
+/**
+ *  @file HostHal.h
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Board under host control (env:native): the virtual clock behind millis(),
+ *  micros(), delay(), vTaskDelay() and time(), the GPIO levels, the ADC
+ *  inputs, the DHT readings and the directory that holds the LittleFS files.
+ *
+ *  Nothing runs by itself: the clock only moves when the firmware waits
+ *  (delay, vTaskDelay) or when the host program calls advance(). Programs
+ *  are single threaded, like one task that owns the whole board.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <functional>
+#include <string>
+
+#define HOST_PINS 40 ///< GPIO0..GPIO39
+
+class HostHal {
+    static uint64_t _us;
+
+    public:
+        // Clock
+        static time_t epoch;        ///< time() when micros() was 0; 0 = clock never set (no SNTP)
+
+        // GPIO and ADC
+        static uint8_t level[HOST_PINS];    ///< Output level written or input level read
+        static uint8_t mode[HOST_PINS];     ///< Last pinMode()
+        static std::function<uint16_t (uint8_t pin)> analog; ///< ADC source, 0 when unset
+
+        // DHT22 (NaN = failed read)
+        static float temperature;
+        static float humidity;
+
+        // Serial port and chip
+        static bool serialEcho;     ///< Copy the serial output to stderr
+        static uint32_t restarts;   ///< ESP.restart() calls
+
+        // LittleFS
+        static std::string fsRoot;  ///< Host directory mounted as the LittleFS root
+        static uint32_t fsReads;    ///< Files opened for reading
+        static uint32_t fsWrites;   ///< Files opened for writing
+
+    public:
+        static uint64_t micros() { return _us; }
+        static void advance(uint64_t us) { _us += us; }
+
+        /**
+         * @brief Power on again: clock, pins and counters back to zero.
+         */
+        static void reset();
+
+        static void pinMode(uint8_t pin, uint8_t value) { if (pin < HOST_PINS) mode[pin] = value; }
+        static void digitalWrite(uint8_t pin, uint8_t value) { if (pin < HOST_PINS) level[pin] = value ? 1 : 0; }
+        static int digitalRead(uint8_t pin) { return pin < HOST_PINS ? level[pin] : 0; }
+        static uint16_t analogRead(uint8_t pin) { return analog ? analog(pin) : 0; }
+};
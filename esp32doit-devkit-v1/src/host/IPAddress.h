@@ -0,0 +1,43 @@
+/**
+ *  @file IPAddress.h
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Host stand-in for the Arduino IPAddress (env:native).
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <Arduino.h>
+
+class IPAddress {
+    uint8_t _bytes[4] = {};
+
+    public:
+        IPAddress() {}
+        IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _bytes{a, b, c, d} {}
+        uint8_t operator[](int index) const { return this->_bytes[index]; }
+        String toString() const {
+            char buf[16];
+            snprintf(buf, sizeof(buf), "%u.%u.%u.%u", this->_bytes[0], this->_bytes[1], this->_bytes[2], this->_bytes[3]);
+            return String(buf);
+        }
+};
@@ -0,0 +1,181 @@
+/**
+ *  @file WString.h
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Host stand-in for the Arduino `String` (env:native), on top of std::string.
+ *  Same interface and results as the core for the calls made by the firmware.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+
+class String {
+    std::string _buf;
+
+    public:
+        String() {}
+        String(const char *cstr) : _buf(cstr ? cstr : "") {}
+        String(const char *cstr, unsigned int length) : _buf(cstr, length) {}
+        String(const String &str) = default;
+        String(String &&str) = default;
+        explicit String(char c) : _buf(1, c) {}
+        explicit String(unsigned char value, unsigned char base = 10) : String((unsigned long long) value, base) {}
+        explicit String(int value, unsigned char base = 10) : String((long long) value, base) {}
+        explicit String(unsigned int value, unsigned char base = 10) : String((unsigned long long) value, base) {}
+        explicit String(long value, unsigned char base = 10) : String((long long) value, base) {}
+        explicit String(unsigned long value, unsigned char base = 10) : String((unsigned long long) value, base) {}
+        explicit String(long long value, unsigned char base = 10) {
+            if (value < 0 && base == 10) {
+                this->_buf = "-";
+                this->appendNumber(0ULL - (unsigned long long) value, base);
+            }
+            else this->appendNumber((unsigned long long) value, base);
+        }
+        explicit String(unsigned long long value, unsigned char base = 10) { this->appendNumber(value, base); }
+        explicit String(float value, unsigned int decimalPlaces = 2) : String((double) value, decimalPlaces) {}
+        explicit String(double value, unsigned int decimalPlaces = 2) {
+            char buf[64];
+            snprintf(buf, sizeof(buf), "%.*f", (int) decimalPlaces, value);
+            this->_buf = buf;
+        }
+
+        String &operator=(const String &rhs) = default;
+        String &operator=(String &&rhs) = default;
+        String &operator=(const char *cstr) { this->_buf = cstr ? cstr : ""; return *this; }
+
+        size_t length() const { return this->_buf.length(); }
+        bool isEmpty() const { return this->_buf.empty(); }
+        const char *c_str() const { return this->_buf.c_str(); }
+        bool reserve(unsigned int size) { this->_buf.reserve(size); return true; }
+
+        bool concat(const String &str) { this->_buf += str._buf; return true; }
+        bool concat(const char *cstr) { if (!cstr) return false; this->_buf += cstr; return true; }
+        bool concat(const char *cstr, unsigned int length) { if (!cstr) return false; this->_buf.append(cstr, length); return true; }
+        bool concat(char c) { this->_buf += c; return true; }
+        template <typename T>
+        bool concat(T value) { return this->concat(String(value)); }
+
+        template <typename T>
+        String &operator+=(const T &rhs) { this->concat(rhs); return *this; }
+
+        int compareTo(const String &s) const { return this->_buf.compare(s._buf); }
+        bool equals(const String &s) const { return this->_buf == s._buf; }
+        bool equals(const char *cstr) const { return this->_buf == (cstr ? cstr : ""); }
+        bool equalsIgnoreCase(const String &s) const {
+            if (this->length() != s.length()) return false;
+            for (unsigned int i = 0; i < this->length(); i++)
+                if (tolower((unsigned char) this->_buf[i]) != tolower((unsigned char) s._buf[i])) return false;
+            return true;
+        }
+        bool operator==(const String &rhs) const { return this->equals(rhs); }
+        bool operator==(const char *cstr) const { return this->equals(cstr); }
+        bool operator!=(const String &rhs) const { return !this->equals(rhs); }
+        bool operator!=(const char *cstr) const { return !this->equals(cstr); }
+        bool operator<(const String &rhs) const { return this->_buf < rhs._buf; }
+        bool operator>(const String &rhs) const { return this->_buf > rhs._buf; }
+        bool startsWith(const String &prefix) const { return this->_buf.compare(0, prefix.length(), prefix._buf) == 0; }
+        bool endsWith(const String &suffix) const {
+            return this->length() >= suffix.length()
+                && this->_buf.compare(this->length() - suffix.length(), suffix.length(), suffix._buf) == 0;
+        }
+
+        char charAt(unsigned int index) const { return index < this->length() ? this->_buf[index] : 0; }
+        void setCharAt(unsigned int index, char c) { if (index < this->length()) this->_buf[index] = c; }
+        char operator[](unsigned int index) const { return this->charAt(index); }
+        char &operator[](unsigned int index) { return this->_buf[index]; }
+        void toCharArray(char *buf, unsigned int size, unsigned int index = 0) const {
+            if (!size || !buf) return;
+            unsigned int n = index < this->length() ? std::min(size - 1, (unsigned int) (this->length() - index)) : 0;
+            memcpy(buf, this->_buf.data() + index, n);
+            buf[n] = 0;
+        }
+
+        int indexOf(char c, unsigned int from = 0) const { return this->position(this->_buf.find(c, from)); }
+        int indexOf(const String &s, unsigned int from = 0) const { return this->position(this->_buf.find(s._buf, from)); }
+        int lastIndexOf(char c) const { return this->position(this->_buf.rfind(c)); }
+        int lastIndexOf(const String &s) const { return this->position(this->_buf.rfind(s._buf)); }
+
+        String substring(unsigned int beginIndex) const { return this->substring(beginIndex, this->length()); }
+        String substring(unsigned int beginIndex, unsigned int endIndex) const {
+            if (beginIndex > endIndex) std::swap(beginIndex, endIndex);
+            if (beginIndex >= this->length()) return String();
+            if (endIndex > this->length()) endIndex = this->length();
+            return String(this->_buf.substr(beginIndex, endIndex - beginIndex).c_str());
+        }
+
+        void replace(char find, char replace) {
+            for (auto &c : this->_buf) if (c == find) c = replace;
+        }
+        void replace(const String &find, const String &replace) {
+            if (find.isEmpty()) return;
+            size_t at = 0;
+            while ((at = this->_buf.find(find._buf, at)) != std::string::npos) {
+                this->_buf.replace(at, find.length(), replace._buf);
+                at += replace.length();
+            }
+        }
+        void remove(unsigned int index) { if (index < this->length()) this->_buf.erase(index); }
+        void remove(unsigned int index, unsigned int count) { if (index < this->length()) this->_buf.erase(index, count); }
+        void toLowerCase() { for (auto &c : this->_buf) c = tolower((unsigned char) c); }
+        void toUpperCase() { for (auto &c : this->_buf) c = toupper((unsigned char) c); }
+        void trim() {
+            size_t begin = this->_buf.find_first_not_of(" \t\r\n\f\v");
+            if (begin == std::string::npos) { this->_buf.clear(); return; }
+            size_t end = this->_buf.find_last_not_of(" \t\r\n\f\v");
+            this->_buf = this->_buf.substr(begin, end - begin + 1);
+        }
+
+        long toInt() const { return atol(this->c_str()); }
+        float toFloat() const { return (float) atof(this->c_str()); }
+        double toDouble() const { return atof(this->c_str()); }
+
+    private:
+        int position(size_t at) const { return at == std::string::npos ? -1 : (int) at; }
+
+        void appendNumber(unsigned long long value, unsigned char base) {
+            char buf[66];
+            char *p = buf + sizeof(buf) - 1;
+            *p = 0;
+            if (base < 2) base = 10;
+            do {
+                unsigned digit = value % base;
+                *--p = digit < 10 ? '0' + digit : 'a' + digit - 10;
+                value /= base;
+            } while (value);
+            this->_buf += p;
+        }
+};
+
+inline String operator+(const String &lhs, const String &rhs) { String s(lhs); s.concat(rhs); return s; }
+inline String operator+(const String &lhs, const char *rhs) { String s(lhs); s.concat(rhs); return s; }
+inline String operator+(const char *lhs, const String &rhs) { String s(lhs); s.concat(rhs); return s; }
+inline String operator+(const String &lhs, char rhs) { String s(lhs); s.concat(rhs); return s; }
+template <typename T>
+inline String operator+(const String &lhs, T rhs) { String s(lhs); s.concat(String(rhs)); return s; }
+inline bool operator==(const char *lhs, const String &rhs) { return rhs.equals(lhs); }
+inline bool operator!=(const char *lhs, const String &rhs) { return !rhs.equals(lhs); }
@@ -0,0 +1,32 @@
+/**
+ *  @file envWiFi.h
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Default WiFi credentials of the host builds (env:native), see include/envWiFi.txt.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#define WIFI_SSID_STA_DEFAULT	""
+#define WIFI_PASS_STA_DEFAULT	""
+#define WIFI_SSID_AP_DEFAULT	"SmartWatering V1"
+#define WIFI_PASS_AP_DEFAULT	"Admin#1234"
@@ -0,0 +1,51 @@
+/**
+ *  @file FreeRTOS.h
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Host stand-in for the FreeRTOS kernel types (env:native). One tick is one millisecond of the HostHal clock.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "../HostHal.h"
+#include "FreeRTOSConfig.h"
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE         ((BaseType_t) 0)
+#define pdTRUE          ((BaseType_t) 1)
+#define pdPASS          pdTRUE
+#define pdFAIL          pdFALSE
+#define errQUEUE_FULL   ((BaseType_t) 0)
+#define portMAX_DELAY   ((TickType_t) 0xffffffffUL)
+#define portTICK_PERIOD_MS ((TickType_t) 1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t) (((uint64_t) (xTimeInMs) * configTICK_RATE_HZ) / 1000U))
+
+/**
+ * @brief Block the only task for `ticks`: on host the time simply passes.
+ */
+inline void hostBlock(TickType_t ticks) {
+    if (ticks != portMAX_DELAY) HostHal::advance((uint64_t) ticks * portTICK_PERIOD_MS * 1000ULL);
+}
@@ -0,0 +1,121 @@
+/**
+ *  @file queue.h
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Host stand-in for the FreeRTOS queues and queue sets (env:native). There is a single task on host, so a receive on an empty queue lets the timeout pass and fails.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <string.h>
+#include <deque>
+#include <vector>
+#include "FreeRTOS.h"
+
+struct QueueDefinition {
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    std::deque<std::vector<uint8_t>> items;
+    QueueDefinition *set = nullptr; ///< Queue set this queue belongs to
+};
+
+typedef QueueDefinition *QueueHandle_t;
+typedef QueueDefinition *QueueSetHandle_t;
+typedef QueueDefinition *QueueSetMemberHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    return new QueueDefinition{ length, itemSize, {} };
+}
+
+inline void vQueueDelete(QueueHandle_t queue) { delete queue; }
+
+/**
+ * @brief Append an item; a member of a set also queues its handle in the set.
+ */
+inline void hostQueuePush(QueueHandle_t queue, const void *item) {
+    const uint8_t *bytes = (const uint8_t *) item;
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+    if (queue->set) {
+        const uint8_t *handle = (const uint8_t *) &queue;
+        queue->set->items.emplace_back(handle, handle + sizeof(queue));
+    }
+}
+
+inline BaseType_t xQueueSendToBack(QueueHandle_t queue, const void *item, TickType_t ticks) {
+    if (queue->items.size() >= queue->length) {
+        hostBlock(ticks);
+        return errQUEUE_FULL;
+    }
+    hostQueuePush(queue, item);
+    return pdTRUE;
+}
+
+/**
+ * @brief Write to a queue of length 1; an item already waiting is replaced (the set is not notified again).
+ */
+inline BaseType_t xQueueOverwrite(QueueHandle_t queue, const void *item) {
+    if (queue->items.empty()) {
+        hostQueuePush(queue, item);
+        return pdPASS;
+    }
+    memcpy(queue->items.front().data(), item, queue->itemSize);
+    return pdPASS;
+}
+
+inline QueueSetHandle_t xQueueCreateSet(UBaseType_t length) {
+    return new QueueDefinition{ length, sizeof(QueueHandle_t), {} };
+}
+
+inline BaseType_t xQueueAddToSet(QueueHandle_t queue, QueueSetHandle_t set) {
+    if (queue->set || !queue->items.empty()) return pdFAIL;
+    queue->set = set;
+    return pdPASS;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks) {
+    return xQueueSendToBack(queue, item, ticks);
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void *buffer, TickType_t ticks) {
+    if (queue->items.empty()) {
+        hostBlock(ticks);
+        return pdFALSE;
+    }
+    memcpy(buffer, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    return pdTRUE;
+}
+
+/**
+ * @brief Next member with an item, in the order the items were queued.
+ */
+inline QueueSetMemberHandle_t xQueueSelectFromSet(QueueSetHandle_t set, TickType_t ticks) {
+    QueueHandle_t member = nullptr;
+    return xQueueReceive(set, &member, ticks) == pdTRUE ? member : nullptr;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) { return queue->items.size(); }
+
+inline BaseType_t xQueueReset(QueueHandle_t queue) {
+    queue->items.clear();
+    return pdPASS;
+}
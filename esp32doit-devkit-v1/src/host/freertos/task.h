@@ -0,0 +1,62 @@
+/**
+ *  @file task.h
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Host stand-in for the FreeRTOS tasks (env:native). Tasks are not created on host; the program drives the task loops itself.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include "FreeRTOS.h"
+
+#define PRO_CPU_NUM 0
+#define APP_CPU_NUM 1
+
+struct HostTask {
+    uint32_t notified = 0;  ///< Pending notification count
+};
+
+typedef HostTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+inline void vTaskDelay(TickType_t ticks) { hostBlock(ticks); }
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() {
+    static HostTask task;
+    return &task;
+}
+
+inline BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    task->notified++;
+    return pdPASS;
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    HostTask *task = xTaskGetCurrentTaskHandle();
+    if (!task->notified) {
+        hostBlock(ticks);
+        return 0;
+    }
+    uint32_t count = task->notified;
+    task->notified = clearOnExit ? 0 : count - 1;
+    return count;
+}
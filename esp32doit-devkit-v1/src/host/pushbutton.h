@@ -0,0 +1,38 @@
+/**
+ *  @file pushbutton.h
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Host stand-in for the PushButton library (env:native): the button reads its GPIO level in HostHal.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <Arduino.h>
+
+class PushButtonDigital {
+    uint8_t _pin, _mode;
+
+    public:
+        PushButtonDigital(uint8_t pin, uint8_t mode) : _pin(pin), _mode(mode) {}
+        void init() { pinMode(this->_pin, this->_mode); }
+        bool digitalReadPushButton() { return digitalRead(this->_pin); }
+};
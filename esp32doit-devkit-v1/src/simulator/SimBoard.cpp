@@ -0,0 +1,234 @@
+/**
+ *  @file SimBoard.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <LittleFS.h>
+#include <limits.h>
+#include "SimBoard"
+#include "MicroBox/hardware/sensor/DHTProgram"
+#include "MicroBox/hardware/sensor/SoilMoisture"
+#include "MicroBox/hardware/sensor/RainCheck"
+#include "MicroBox/hardware/sensor/Sensors"
+#include "MicroBox/hardware/sensor/SoilMux"
+#include "MicroBox/hardware/sensor/SoilCalibration"
+#include "MicroBox/hardware/sensor/AdaptiveSampler"
+#include "MicroBox/hardware/RelayController"
+#include "MicroBox/hardware/LCDdisplay"
+#include "MicroBox/software/MyEEPROM"
+#include "MicroBox/software/LFSMemory"
+#include "MicroBox/software/WateringSys"
+#include "MicroBox/software/SensorSys"
+#include "MicroBox/externobj"
+
+// The globals of MicroBox_main.cpp used by the firmware objects
+LEDBoard led_running, led_warning;
+LCDdisplay lcd = LCDdisplay();
+DHTProgram dhtprog = DHTProgram(PIN_DHT, DHT22);
+SoilMoisture soilmoisture;
+RainCheck raincheck;
+SensorList sensors = SensorList(
+    SoilMoistureChannel(soilmoisture),
+    TemperatureChannel(dhtprog),
+    HumidityChannel(dhtprog),
+    RainChannel(raincheck)
+);
+#if SOIL_MUX_ENABLE
+SoilMux<SOIL_MUX_CHANNELS> soilmux;
+#endif
+SoilCalibrationLUT soilcal[SOIL_PROBES];
+SoilCalCapture soilcalcapture;
+AdaptiveSampler sampler = AdaptiveSampler(
+    SAMPLE_PERIOD_MIN_MS, SAMPLE_PERIOD_MAX_MS,
+    SAMPLE_CHANGE_THRESHOLD, SAMPLE_BOOST_MS
+);
+MyEEPROM myeeprom_prog;
+LFSMemory lfsprog;
+WateringSys wateringSys;
+SensorSys sensorSys;
+unsigned long __lastTimeReboot__ = 0;
+bool RebootState = false;
+
+/**
+ * @brief Two beds with different soils, one per zone.
+ */
+SimBoard::SimBoard(uint32_t seed)
+    : _weather(seed), _beds{ SoilBed(seed + 1), SoilBed(seed + 2) } {
+    // Zone 1: sandier bed, soaks and drains faster and dries out quicker
+    this->_beds[1].params.surfaceLitres = 1.0;
+    this->_beds[1].params.soakTauS = 45;
+    this->_beds[1].params.drainPerHour = 1.2;
+    this->_beds[1].params.etPerKpaHour = 0.45;
+}
+
+/**
+ * @brief ADC inputs: the probe follows bed 0 (4095 dry .. 2500 wet), the rain sensor reads high while it rains.
+ */
+uint16_t SimBoard::adc(uint8_t pin) {
+    if (pin == PIN_SMS) {
+        float level = this->_beds[0].read();
+        return (uint16_t) lroundf(4095 - level * (4095 - 2500) / 100);
+    }
+    if (pin == PIN_RAIN) return this->_rain > 0 ? 3800 : 200;
+    return 0;
+}
+
+void SimBoard::begin(const SimConfig &cfg, const char *root) {
+    HostHal::reset();
+    HostHal::epoch = SIM_EPOCH - SCHEDULE_TZ_OFFSET_SEC;
+    HostHal::fsRoot = root;
+    HostHal::analog = [this](uint8_t pin) { return this->adc(pin); };
+    for (auto &bed : this->_beds) bed.moisture = cfg.soil;
+    this->updateWeather();
+
+    LittleFS.begin(true);
+    LittleFS.format();
+
+    // MicroBox_Main::setup(), with the configuration stored before the tasks start
+    myeeprom_prog.initialize();
+    lfsprog.setupLFS();
+    lfsprog.changeConfigState(AUTOWATERING, cfg.autoWatering);
+    lfsprog.changeWateringConfig(cfg.watering);
+    RelayController::BEGIN(true, 0);
+    wateringSys.events.begin();
+
+    // First lines of vTask1 and vTask4
+    sensorSys.begin();
+    wateringSys.begin();
+
+    this->_start = millis();
+    this->_bedsAt = this->_start;
+    this->_weatherDue = this->_start;
+    this->_wateringDue = this->_start;
+    this->readRelays();
+}
+
+/**
+ * @brief Weather at the current time; sets the DHT22 readings.
+ */
+void SimBoard::updateWeather() {
+    this->_rain = this->_weather.update((millis() - this->_start) / 1000);
+    this->_vpd = DemandForecast::vpd(this->_weather.temperature, this->_weather.humidity);
+    HostHal::temperature = this->_weather.temperature;
+    HostHal::humidity = this->_weather.humidity;
+}
+
+/**
+ * @brief Step the beds up to `now` with the relay states of the step.
+ */
+void SimBoard::stepBeds(unsigned long now) {
+    if (now <= this->_bedsAt) return;
+    float dt = (now - this->_bedsAt) / 1000.0;
+    this->_bedsAt = now;
+
+    for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+        if (this->_on[i]) this->_result.pumpHours += dt / 3600;
+        this->_beds[i].step(dt, this->_on[i] ? WATERING_FLOW_LPM : 0, this->_rain, this->_vpd);
+
+        float level = this->_beds[i].moisture;
+        if (level < SIM_STRESS_LEVEL) this->_result.stressHours += dt / 3600;
+        if (level > this->_beds[i].params.fieldCapacity) this->_result.wetHours += dt / 3600;
+        if (level < this->_result.lowest) this->_result.lowest = level;
+    }
+}
+
+/**
+ * @brief vTask4: one wakeup per queued event, then one on the timer when it is due.
+ */
+void SimBoard::wakeWatering() {
+    bool woken = false;
+    WateringEvent event;
+    while (wateringSys.events.pending() && wateringSys.events.wait(event, 0)) {
+        wateringSys.wakeup(&event);
+        woken = true;
+    }
+    if (!woken && (long) (millis() - this->_wateringDue) >= 0) {
+        wateringSys.wakeup(nullptr);
+        woken = true;
+    }
+    if (woken) this->_wateringDue = millis() + wateringSys.nextTimeout();
+}
+
+/**
+ * @brief Read the relay pins; count the switch-ons.
+ */
+void SimBoard::readRelays() {
+    for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+        bool on = RelayController::RELAY_STATE_STR_INT(digitalRead(RELAY_PINS[i]));
+        if (on && !this->_on[i]) this->_result.cycles++;
+        this->_on[i] = on;
+    }
+}
+
+SimResult SimBoard::run(uint32_t days) {
+    days = min(days, (uint32_t) SIM_MAX_DAYS);
+    const unsigned long end = this->_start + days * 86400000UL;
+    unsigned long sensorDue = millis(), relayDue = millis();
+
+    while (millis() < end) {
+        unsigned long now = millis();
+        this->stepBeds(now);
+
+        // The weather changes slowly: refresh it once per SIM_WEATHER_S
+        if ((long) (now - this->_weatherDue) >= 0) {
+            this->updateWeather();
+            this->_weatherDue += SIM_WEATHER_S * 1000UL;
+        }
+
+        // vTask1 (sleeps at least 10 ms between two passes)
+        if ((long) (now - sensorDue) >= 0)
+            sensorDue = millis() + max(sensorSys.run(), (uint32_t) 10);
+
+        // vTask3 runs the relay queue on its 100 ms tick
+        if ((long) (now - relayDue) >= 0) {
+            RelayController::PROCESSQUEUE();
+            // A switched relay notifies vTask1 (SensorSys::wake())
+            if (ulTaskNotifyTake(pdTRUE, 0)) sensorDue = millis();
+            uint32_t left = RelayController::REMAINING();
+            relayDue = left == UINT32_MAX
+                ? ULONG_MAX
+                : (now / SIM_TICK_MS + 1 + left / SIM_TICK_MS) * SIM_TICK_MS;
+        }
+
+        this->wakeWatering();
+
+        // A relay written without delay is switched on the next vTask3 tick
+        if (relayDue == ULONG_MAX && RelayController::REMAINING() != UINT32_MAX)
+            relayDue = (millis() / SIM_TICK_MS + 1) * SIM_TICK_MS;
+
+        this->readRelays();
+        if (this->onStep) this->onStep((millis() - this->_start) / 1000, *this);
+
+        // Sleep until the next task is due
+        unsigned long next = min(min(sensorDue, relayDue), min(this->_wateringDue, this->_weatherDue));
+        next = min(next, end);
+        if (next > millis()) HostHal::advance((uint64_t) (next - millis()) * 1000ULL);
+    }
+    this->stepBeds(millis());
+
+    for (const auto &bed : this->_beds) {
+        this->_result.pumped  += bed.pumped;
+        this->_result.runoff  += bed.runoff;
+        this->_result.drained += bed.drained;
+        this->_result.rained  += bed.rained;
+    }
+    return this->_result;
+}
@@ -0,0 +1,185 @@
+/**
+ *  @file simulator.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Host simulator for tuning the watering settings. Boots the firmware
+ *  (SensorSys, WateringSys, RelayController, LFSMemory) on the host HAL and
+ *  runs it against the SoilModel beds on a virtual clock (SimBoard), for
+ *  every configuration of a parameter sweep. The firmware objects are
+ *  globals, so each configuration runs in its own process; the processes are
+ *  spread over all host cores. Every configuration sees the same weather and
+ *  probe noise, so the rows compare like for like.
+ *
+ *  Build and run (`env:native` in platformio.ini):
+ *      pio run -e native
+ *      .pio/build/native/program [days] [processes] [seed] > sweep.csv
+ *
+ *  A single configuration of the sweep runs with
+ *      .pio/build/native/program --config <index> [days] [seed]
+ *  (set SIM_SERIAL=1 to see the serial output of the firmware on stderr).
+ *
+ *  Output: one CSV row per configuration with the water pumped, the water
+ *  lost (runoff, drainage), the hours below the stress level and above field
+ *  capacity, and the relay cycles.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "variable"
+#include "MicroBox/software/WateringZone"
+#include "SimBoard"
+
+#define SIM_DAYS 45 ///< Default run length (SIM_MAX_DAYS at most)
+
+/**
+ * @brief Configurations of the sweep.
+ */
+static std::vector<SimConfig> sweep() {
+    std::vector<SimConfig> list;
+
+    for (uint8_t mode : { WATERING_MODE_THRESHOLD, WATERING_MODE_PREDICTIVE }) {
+        for (uint8_t low : { 25, 30, 35, 40 }) {
+            for (uint8_t high : { 60, 70, 80 }) {
+                SimConfig cfg;
+                cfg.watering.mode = mode;
+                cfg.watering.low = low;
+                cfg.watering.high = high;
+                list.push_back(cfg);
+            }
+        }
+    }
+
+    for (uint8_t start : { 30, 35, 40 }) {
+        for (uint8_t target : { 55, 62, 70 }) {
+            for (uint32_t soak : { 60000, 120000, 300000 }) {
+                SimConfig cfg;
+                cfg.watering.mode = WATERING_MODE_PULSE;
+                for (auto &zone : cfg.watering.zones) {
+                    zone.start = start;
+                    zone.target = target;
+                    zone.soakMs = soak;
+                }
+                list.push_back(cfg);
+            }
+        }
+    }
+    return list;
+}
+
+/**
+ * @brief CSV columns of a configuration (mode, start, stop, soak_s).
+ */
+static void printConfig(const SimConfig &cfg) {
+    const WateringConfig &w = cfg.watering;
+    bool pulse = w.mode == WATERING_MODE_PULSE;
+    printf("%s,%u,%u,%lu", wateringModeText(w.mode),
+        pulse ? w.zones[0].start : w.low,
+        pulse ? w.zones[0].target : w.high,
+        pulse ? (unsigned long) (w.zones[0].soakMs / 1000) : 0UL);
+}
+
+/**
+ * @brief Run one configuration in this process and print its result columns.
+ */
+static int runConfig(const SimConfig &cfg, uint32_t days, uint32_t seed) {
+    std::string root = (std::filesystem::temp_directory_path() / ("microbox-sim-" + std::to_string(getpid()))).string();
+
+    SimBoard board(seed);
+    HostHal::serialEcho = getenv("SIM_SERIAL") != nullptr;
+    board.begin(cfg, root.c_str());
+    SimResult r = board.run(days);
+
+    std::error_code error;
+    std::filesystem::remove_all(root, error);
+
+    printf("%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%lu,%.1f\n",
+        r.pumped, r.runoff, r.drained, r.rained,
+        r.stressHours, r.wetHours, r.pumpHours, (unsigned long) r.cycles, r.lowest);
+    return 0;
+}
+
+#ifndef PIO_UNIT_TESTING
+int main(int argc, char **argv) {
+    std::vector<SimConfig> configs = sweep();
+
+    if (argc > 2 && strcmp(argv[1], "--config") == 0) {
+        size_t index = strtoul(argv[2], nullptr, 10);
+        uint32_t days = argc > 3 ? strtoul(argv[3], nullptr, 10) : SIM_DAYS;
+        uint32_t seed = argc > 4 ? strtoul(argv[4], nullptr, 10) : 1;
+        if (index >= configs.size()) return 1;
+        return runConfig(configs[index], days ? days : SIM_DAYS, seed);
+    }
+
+    uint32_t days = argc > 1 ? strtoul(argv[1], nullptr, 10) : SIM_DAYS;
+    uint32_t workers = argc > 2 ? strtoul(argv[2], nullptr, 10) : std::thread::hardware_concurrency();
+    uint32_t seed = argc > 3 ? strtoul(argv[3], nullptr, 10) : 1;
+    if (!days) days = SIM_DAYS;
+    if (days > SIM_MAX_DAYS) {
+        fprintf(stderr, "At most %u days (32-bit millis() fields), running %u\n", SIM_MAX_DAYS, SIM_MAX_DAYS);
+        days = SIM_MAX_DAYS;
+    }
+    if (!workers) workers = 1;
+
+    // One process per configuration, `workers` at a time
+    std::vector<std::string> rows(configs.size());
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (uint32_t n = 0; n < workers; n++) {
+        pool.emplace_back([&]() {
+            for (size_t i = next++; i < configs.size(); i = next++) {
+                String command = String(argv[0]) + " --config " + String((unsigned long) i) + " "
+                    + String(days) + " " + String(seed);
+                FILE *child = popen(command.c_str(), "r");
+                char line[256] = "";
+                if (!child || !fgets(line, sizeof(line), child)) failed = true;
+                if (child && pclose(child) != 0) failed = true;
+                line[strcspn(line, "\n")] = 0;
+                rows[i] = line;
+            }
+        });
+    }
+    for (auto &worker : pool) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    printf("mode,start,stop,soak_s,pumped_l,runoff_l,drained_l,rain_l,stress_h,wet_h,pump_h,cycles,lowest\n");
+    for (size_t i = 0; i < configs.size(); i++) {
+        printConfig(configs[i]);
+        printf(",%s\n", rows[i].c_str());
+    }
+
+    fprintf(stderr, "%zu configurations x %lu days on %lu process(es): %.2f s\n",
+        configs.size(), (unsigned long) days, (unsigned long) workers, seconds);
+    return failed ? 1 : 0;
+}
+#endif
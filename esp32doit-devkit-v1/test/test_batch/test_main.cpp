@@ -0,0 +1,197 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Batch vs separate requests (env:native, pio test -e native -f test_batch).
+ *  The same operations (auto watering off, every relay on, auto change on)
+ *  are applied on a host LittleFS twice: with the relay and config calls of
+ *  the single routes, one request each (/auto-watering, /check per relay,
+ *  /auto-change-wifi-mode), then with the calls of POST /api/v1/batch.
+ *  Reports the files opened for reading and writing (HostHal::fsReads,
+ *  fsWrites) and the time per run (host). On the device each write is a
+ *  LittleFS commit of a whole file.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <chrono>
+#include <filesystem>
+#include "MicroBox/hardware/RelayController"
+#include "MicroBox/software/LFSMemory"
+#include "MicroBox/software/WateringSys"
+#include "MicroBox/externobj"
+
+#define BENCH_ROUNDS 200
+
+namespace stdfs = std::filesystem;
+using BenchClock = std::chrono::steady_clock;
+
+static std::string root;
+
+/**
+ * @brief Files opened and time of one run.
+ */
+struct Run {
+    uint32_t requests = 0;
+    uint32_t reads = 0;
+    uint32_t writes = 0;
+    double us = 0;
+};
+
+/**
+ * @brief Stored state back to auto watering on, relays and auto change off.
+ */
+static void resetState() {
+    lfsprog.changeConfigStates({ { AUTOWATERING, true }, { AUTOCHANGE, false } });
+    std::vector<std::pair<uint8_t, bool>> relays;
+    for (const auto &pin : RELAY_PINS) relays.push_back({ pin, false });
+    lfsprog.changeStateRelays(relays);
+}
+
+/**
+ * @brief Separate requests: commandAutoWatering(), commandRelay() per relay, AutoChangeMode().
+ */
+static void separate(Run &run) {
+    lfsprog.changeConfigState(AUTOWATERING, false);
+    run.requests++;
+    for (const auto &pin : RELAY_PINS) {
+        RelayController::WRITE(pin, true, 0);
+        RelayController::PROCESSQUEUE();
+        run.requests++;
+    }
+    lfsprog.changeConfigState(AUTOCHANGE, true);
+    run.requests++;
+}
+
+/**
+ * @brief One batch: the final states, applied as Batch() does.
+ */
+static void batch(Run &run) {
+    std::vector<std::pair<uint8_t, bool>> relays;
+    for (const auto &pin : RELAY_PINS) relays.push_back({ pin, true });
+    std::vector<std::pair<String, bool>> config = { { AUTOWATERING, false }, { AUTOCHANGE, true } };
+
+    RelayController::WRITE_BATCH(relays, 0);
+    lfsprog.changeConfigStates(config);
+    lfsprog.changeStateRelays(relays);
+    RelayController::PROCESSQUEUE();
+    run.requests++;
+}
+
+template <typename F>
+static Run bench(F &&apply) {
+    Run total;
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        resetState();
+        Run run;
+        uint32_t reads = HostHal::fsReads, writes = HostHal::fsWrites;
+        auto start = BenchClock::now();
+        apply(run);
+        total.us += std::chrono::duration<double, std::micro>(BenchClock::now() - start).count() / BENCH_ROUNDS;
+        total.requests = run.requests;
+        total.reads = HostHal::fsReads - reads;
+        total.writes = HostHal::fsWrites - writes;
+    }
+    return total;
+}
+
+/**
+ * @brief What the two runs leave in relay.json, state.json and on the outputs.
+ */
+static String stored() {
+    String out;
+    bool value;
+    lfsprog.readConfigState(AUTOWATERING, &value);
+    out += value ? "auto:1 " : "auto:0 ";
+    lfsprog.readConfigState(AUTOCHANGE, &value);
+    out += value ? "change:1" : "change:0";
+    for (const auto &pin : RELAY_PINS) {
+        RelayController::READ(pin);
+        out += " relay" + String(pin) + ":" + String((int) RelayController::RELAY_STATE);
+        out += "/" + String((int) RelayController::RELAY_STATE_STR_INT(digitalRead(pin)));
+    }
+    return out;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/**
+ * @brief Both leave the same stored state and outputs.
+ */
+void test_batch_same_state(void) {
+    Run run;
+    resetState();
+    separate(run);
+    String expected = stored();
+
+    resetState();
+    batch(run);
+    String got = stored();
+    printf("stored: %s\n", got.c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), got.c_str());
+    TEST_ASSERT_TRUE(got.startsWith("auto:0 change:1"));
+}
+
+/**
+ * @brief One write per file for the batch, one per operation for the separate requests.
+ */
+void test_batch_file_writes(void) {
+    Run apart = bench(separate);
+    Run once = bench(batch);
+
+    printf("separate: %lu requests, %lu reads, %lu writes, %.0f us (host)\n",
+        (unsigned long) apart.requests, (unsigned long) apart.reads,
+        (unsigned long) apart.writes, apart.us);
+    printf("batch:    %lu request,  %lu reads, %lu writes, %.0f us (host)\n",
+        (unsigned long) once.requests, (unsigned long) once.reads,
+        (unsigned long) once.writes, once.us);
+
+    TEST_ASSERT_EQUAL_UINT32(2 + WATERING_ZONES, apart.requests);
+    TEST_ASSERT_EQUAL_UINT32(2 + WATERING_ZONES, apart.writes);
+    TEST_ASSERT_EQUAL_UINT32(2, once.writes);
+    TEST_ASSERT_LESS_THAN_UINT32(apart.reads, once.reads);
+}
+
+int main(int argc, char **argv) {
+    (void) argc; (void) argv;
+    root = (stdfs::temp_directory_path() / ("microbox-batch-" + std::to_string(getpid()))).string();
+    HostHal::reset();
+    HostHal::fsRoot = root;
+    LittleFS.begin(true);
+    LittleFS.format();
+
+    // MicroBox_Main::setup(): the files and the relay outputs
+    lfsprog.setupLFS();
+    RelayController::BEGIN(true, 0);
+    wateringSys.events.begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_batch_same_state);
+    RUN_TEST(test_batch_file_writes);
+    int failures = UNITY_END();
+
+    std::error_code error;
+    stdfs::remove_all(root, error);
+    return failures;
+}
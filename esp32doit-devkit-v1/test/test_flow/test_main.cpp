@@ -0,0 +1,176 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Flow meter faults on a simulated pulse source (env:native, pio test -e native -f test_flow).
+ *  SimPulseSource produces the pulses of a YF-S201 (FLOW_PULSES_PER_LITRE)
+ *  at the flow set per meter, and FlowMeter reads it every FLOW_PERIOD_MS
+ *  as on the sensor task: totals, the dry-run latch, the leak latch and a
+ *  slow fill that must not raise a fault.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <memory>
+#include "MicroBox/hardware/sensor/FlowMeter"
+
+#define METERS      2
+#define BENCH_RUNS  1000000
+
+using BenchClock = std::chrono::steady_clock;
+
+/**
+ * @brief A source and its monitor on their own clock.
+ */
+struct FlowBench {
+    SimPulseSource<METERS> source;
+    FlowMeter<SimPulseSource<METERS>, METERS> meter = FlowMeter<SimPulseSource<METERS>, METERS>(source);
+    uint32_t now = 0;
+    uint8_t relays = 0;
+
+    FlowBench() {
+        this->meter.begin();
+        this->meter.update(this->relays, this->now);
+    }
+
+    /**
+     * @brief Run `ms` milliseconds, one counter read per FLOW_PERIOD_MS.
+     * @return Time the first fault of `meter` latched (UINT32_MAX if none).
+     */
+    uint32_t run(uint32_t ms, uint8_t meterIndex = 0) {
+        uint32_t latched = UINT32_MAX;
+        for (uint32_t t = 0; t < ms; t += FLOW_PERIOD_MS) {
+            this->source.advance(FLOW_PERIOD_MS);
+            this->now += FLOW_PERIOD_MS;
+            this->meter.update(this->relays, this->now);
+            if (latched == UINT32_MAX && this->meter.channels[meterIndex].fault != FLOW_OK)
+                latched = this->now;
+        }
+        return latched;
+    }
+};
+
+static std::unique_ptr<FlowBench> bench;
+
+void setUp(void) { bench.reset(new FlowBench()); }
+void tearDown(void) { bench.reset(); }
+
+/**
+ * @brief 2 L/min for 5 min totals 10 L, with no fault.
+ */
+void test_flow_total(void) {
+    bench->relays = 0b01;
+    bench->source.setFlow(0, 2.0);
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, bench->run(5 * 60000));
+
+    const FlowChannel &ch = bench->meter.channels[0];
+    printf("2.0 L/min for 5 min: %.3f L, %.2f L/min\n", ch.litres, ch.lpm);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 10.0, ch.litres);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 2.0, ch.lpm);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 0.0, bench->meter.channels[1].litres);
+}
+
+/**
+ * @brief Relay on without flow: the dry run latches after the grace and hold times, and stays.
+ */
+void test_flow_dry_run_latch(void) {
+    uint32_t opened = bench->now;
+    bench->relays = 0b01;
+    uint32_t latched = bench->run(60000);
+    printf("dry run latched %lu s after the relay opened\n", (unsigned long) (latched - opened) / 1000);
+
+    TEST_ASSERT_TRUE(latched != UINT32_MAX);
+    TEST_ASSERT_GREATER_OR_EQUAL(FLOW_START_GRACE_MS + FLOW_DRY_RUN_MS, latched - opened);
+    TEST_ASSERT_LESS_OR_EQUAL(FLOW_START_GRACE_MS + FLOW_DRY_RUN_MS + 2 * FLOW_PERIOD_MS, latched - opened);
+    TEST_ASSERT_EQUAL_UINT8(0b01, bench->meter.dryRun());
+
+    // Latched: water coming back does not clear it, a clear request does
+    bench->source.setFlow(0, 2.0);
+    bench->run(30000);
+    TEST_ASSERT_EQUAL_UINT8(0b01, bench->meter.dryRun());
+    bench->meter.clearRequest = true;
+    bench->run(FLOW_PERIOD_MS);
+    TEST_ASSERT_EQUAL_UINT8(0, bench->meter.dryRun());
+}
+
+/**
+ * @brief Every relay off with water flowing: the leak latches after FLOW_LEAK_MS and clears once it stops.
+ */
+void test_flow_leak_latch(void) {
+    uint32_t started = bench->now;
+    bench->source.setFlow(1, 0.5);
+    uint32_t latched = bench->run(60000, 1);
+    printf("leak latched %lu s after the flow started\n", (unsigned long) (latched - started) / 1000);
+
+    TEST_ASSERT_TRUE(latched != UINT32_MAX);
+    TEST_ASSERT_GREATER_OR_EQUAL(FLOW_LEAK_MS, latched - started);
+    TEST_ASSERT_LESS_OR_EQUAL(FLOW_LEAK_MS + 2 * FLOW_PERIOD_MS, latched - started);
+    TEST_ASSERT_TRUE(bench->meter.leak());
+    TEST_ASSERT_EQUAL_UINT8(0, bench->meter.dryRun());
+
+    bench->source.setFlow(1, 0);
+    bench->run(2 * FLOW_PERIOD_MS);
+    TEST_ASSERT_FALSE(bench->meter.leak());
+}
+
+/**
+ * @brief A line that takes 4 s to fill, then a low flow above FLOW_MIN_LPM: no fault.
+ */
+void test_flow_slow_fill(void) {
+    bench->relays = 0b11;
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, bench->run(4000));
+    bench->source.setFlow(0, 1.5);
+    bench->source.setFlow(1, FLOW_MIN_LPM * 2);
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, bench->run(5 * 60000));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, bench->run(5 * 60000, 1));
+    TEST_ASSERT_EQUAL_UINT8(0, bench->meter.dryRun());
+    TEST_ASSERT_FALSE(bench->meter.leak());
+}
+
+/**
+ * @brief Cost of one update() and memory of the monitor.
+ */
+void test_flow_cost(void) {
+    bench->relays = 0b01;
+    bench->source.setFlow(0, 2.0);
+    auto start = BenchClock::now();
+    for (int i = 0; i < BENCH_RUNS; i++) {
+        bench->now += FLOW_PERIOD_MS;
+        bench->meter.update(bench->relays, bench->now);
+    }
+    double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count() / BENCH_RUNS;
+    printf("update(): %.1f ns (host), sizeof(FlowMeter<%d>) %u B\n",
+        ns, METERS, (unsigned) sizeof(bench->meter));
+    TEST_ASSERT_LESS_THAN_FLOAT(1000.0, ns);
+}
+
+int main(int argc, char **argv) {
+    (void) argc; (void) argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_flow_total);
+    RUN_TEST(test_flow_dry_run_latch);
+    RUN_TEST(test_flow_leak_latch);
+    RUN_TEST(test_flow_slow_fill);
+    RUN_TEST(test_flow_cost);
+    return UNITY_END();
+}
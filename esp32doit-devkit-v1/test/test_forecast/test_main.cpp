@@ -0,0 +1,113 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  DemandForecast replay (env:native, pio test -e native -f test_forecast).
+ *  A synthetic bed dries at k * VPD percent per hour under a diurnal
+ *  weather cycle, and the probe lags the soil by 10 minutes. The forecast
+ *  must learn k and predict the crossing of the threshold.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include "MicroBox/software/DemandForecast"
+
+#define T0 1735689600 ///< 2025-01-01 00:00 local
+
+/**
+ * @brief Dry a bed from 90 % for `hours` (1 min forecast samples).
+ * @param crossingError Largest |forecast - actual| of the 30 % crossing inside the lead window (seconds).
+ * @return Forecast after the run.
+ */
+static DemandForecast dryOut(float k, uint32_t hours, uint32_t *actualCrossing, uint32_t *crossingError) {
+    DemandForecast fc;
+    float soil = 90, probe = 90;
+    uint32_t forecasts[2000] = {};
+    uint32_t n = 0;
+    *actualCrossing = 0;
+
+    for (uint32_t s = 0; s < hours * 3600; s += 60) {
+        uint32_t now = T0 + s;
+        float phase = sin(((now % 86400) / 3600.0 - 9) / 24.0 * 2 * M_PI);
+        float temperature = 27 + 6 * phase, humidity = 75 - 20 * phase;
+        soil -= k * DemandForecast::vpd(temperature, humidity) / 60;
+        probe += (soil - probe) * 60 / 600.0;
+
+        fc.update(probe, temperature, humidity, false, 30, FORECAST_HOURS_ALL, now);
+        if (n < 2000) forecasts[n++] = fc.crossing;
+        if (!*actualCrossing && probe <= 30) *actualCrossing = now;
+    }
+
+    // Forecasts made inside the lead window, where they decide a predictive start
+    *crossingError = 0;
+    for (uint32_t i = 0; i < n && *actualCrossing; i++) {
+        uint32_t at = T0 + i * 60;
+        if (at + FORECAST_WINDOW_S < *actualCrossing || at >= *actualCrossing || !forecasts[i]) continue;
+        uint32_t error = forecasts[i] > *actualCrossing ? forecasts[i] - *actualCrossing : *actualCrossing - forecasts[i];
+        if (error > *crossingError) *crossingError = error;
+    }
+    return fc;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_forecast_learns_k(void) {
+    for (float k : { 0.8f, 1.5f }) {
+        uint32_t crossing, error;
+        DemandForecast fc = dryOut(k, 24 * 5, &crossing, &error);
+        printf("k=%.1f: learned %.2f after %lu fits\n", k, fc.k(), (unsigned long) fc.fits);
+        TEST_ASSERT_FLOAT_WITHIN(k * 0.15, k, fc.k());
+    }
+}
+
+void test_forecast_predicts_crossing(void) {
+    for (float k : { 0.8f, 1.5f }) {
+        uint32_t crossing, error;
+        dryOut(k, 24 * 5, &crossing, &error);
+        printf("k=%.1f: crossing after %.1f h, worst forecast error %.1f h inside the lead window\n",
+            k, (crossing - T0) / 3600.0, error / 3600.0);
+        TEST_ASSERT_TRUE(crossing != 0);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(3600, error);
+    }
+}
+
+void test_forecast_window_limits_plan(void) {
+    uint32_t crossing, error;
+    DemandForecast fc = dryOut(0.8, 24, &crossing, &error);
+    uint32_t now = T0 + 24 * 3600;
+    if (fc.crossing && fc.planned) {
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(fc.crossing - FORECAST_WINDOW_S, fc.planned);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(fc.crossing, fc.planned);
+    }
+    fc.clearPlan();
+    TEST_ASSERT_FALSE(fc.due(now));
+}
+
+int main(int argc, char **argv) {
+    (void) argc; (void) argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_forecast_learns_k);
+    RUN_TEST(test_forecast_predicts_crossing);
+    RUN_TEST(test_forecast_window_limits_plan);
+    return UNITY_END();
+}
@@ -0,0 +1,181 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Sensor health fault traces (env:native, pio test -e native -f test_health).
+ *  The registered channels (Sensors) read the host HAL: each trace sets the
+ *  probe ADC and the DHT22 readings, then samples and checks the sensors the
+ *  way SensorSys does, once per sample at the given period.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include <memory>
+#include "MicroBox/hardware/sensor/Sensors"
+
+/**
+ * @brief The channels of the firmware on fresh drivers.
+ */
+struct Board {
+    SoilMoisture soil;
+    DHTProgram dht = DHTProgram(PIN_DHT, DHT22);
+    RainCheck rain;
+    SensorList sensors = SensorList(
+        SoilMoistureChannel(soil), TemperatureChannel(dht),
+        HumidityChannel(dht), RainChannel(rain)
+    );
+    uint16_t probe = 3300;  ///< PIN_SMS reading
+
+    Board() {
+        HostHal::reset();
+        HostHal::temperature = 27;
+        HostHal::humidity = 70;
+        HostHal::analog = [this](uint8_t pin) { return pin == PIN_SMS ? this->probe : (uint16_t) 200; };
+        this->sensors.begin();
+    }
+
+    /**
+     * @brief Take `count` samples, `periodMs` apart; `trace(i)` sets the inputs of sample i.
+     */
+    template <typename F>
+    void run(uint32_t count, uint32_t periodMs, F &&trace) {
+        for (uint32_t i = 0; i < count; i++) {
+            HostHal::advance((uint64_t) periodMs * 1000ULL);
+            trace(i);
+            this->sensors.sample();
+            this->sensors.checkHealth(millis());
+        }
+    }
+
+    SensorHealth &soilHealth() { return this->sensors.get<SoilMoistureChannel>().health; }
+    SensorHealth &temperatureHealth() { return this->sensors.get<TemperatureChannel>().health; }
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/**
+ * @brief A probe left unplugged reads the ADC rail without noise: stuck after the rail window.
+ */
+void test_health_disconnected_probe(void) {
+    auto board = std::make_unique<Board>();
+    board->probe = 4095;
+    board->run(3, 30000, [](uint32_t) {});
+    TEST_ASSERT_FALSE(board->soilHealth().quarantined());
+
+    board->run(3, 30000, [](uint32_t) {});
+    printf("disconnected: %s after %lu s\n", SensorHealth::faultText(board->soilHealth().fault()), millis() / 1000);
+    TEST_ASSERT_EQUAL(SENSOR_STUCK, board->soilHealth().fault());
+}
+
+/**
+ * @brief A probe in waterlogged soil reads past the wet end (100 %) but its raw value still moves.
+ */
+void test_health_saturated_probe_is_not_railed(void) {
+    auto board = std::make_unique<Board>();
+    board->run(120, 30000, [&](uint32_t i) { board->probe = 2300 + (i * 7) % 5; });
+    printf("saturated: %d %% for %lu min, fault %s\n", board->soil.value, millis() / 60000,
+        SensorHealth::faultText(board->soilHealth().fault()));
+    TEST_ASSERT_EQUAL_INT(100, board->soil.value);
+    TEST_ASSERT_FALSE(board->soilHealth().quarantined());
+}
+
+/**
+ * @brief A shorted probe pins the ADC at 0: stuck at 100 %.
+ */
+void test_health_shorted_probe(void) {
+    auto board = std::make_unique<Board>();
+    board->run(10, 30000, [&](uint32_t) { board->probe = 2300 + millis() % 3; });
+    board->run(10, 30000, [&](uint32_t) { board->probe = 0; });
+    TEST_ASSERT_EQUAL(SENSOR_STUCK, board->soilHealth().fault());
+}
+
+/**
+ * @brief The stuck window is a time: fast sampling of a steady reading is not stuck.
+ */
+void test_health_stuck_window_is_time(void) {
+    auto board = std::make_unique<Board>();
+    board->probe = 3300;
+    board->run(36000, 100, [](uint32_t) {});
+    TEST_ASSERT_FALSE(board->soilHealth().quarantined());
+
+    board->run(6 * 120 + 1, 30000, [](uint32_t) {});
+    printf("steady 46 %%: %s after %.1f h\n", SensorHealth::faultText(board->soilHealth().fault()), millis() / 3600000.0);
+    TEST_ASSERT_EQUAL(SENSOR_STUCK, board->soilHealth().fault());
+}
+
+/**
+ * @brief The detectors see each reading once, so the statistics count samples.
+ */
+void test_health_once_per_sample(void) {
+    auto board = std::make_unique<Board>();
+    board->run(100, 100, [&](uint32_t i) { board->probe = 3300 + i % 7; });
+    TEST_ASSERT_EQUAL_UINT32(100, board->soilHealth().samples);
+
+    // The DHT22 is read at most every 2 s: 100 samples at 100 ms are 5 reads
+    printf("100 samples at 100 ms: %lu soil, %lu DHT readings checked\n",
+        (unsigned long) board->soilHealth().samples, (unsigned long) board->temperatureHealth().samples);
+    TEST_ASSERT_EQUAL_UINT32(board->dht.reads, board->temperatureHealth().samples);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(10, board->temperatureHealth().samples);
+}
+
+/**
+ * @brief One failed DHT read repeated by fast sampling is one bad reading, not a streak.
+ */
+void test_health_single_failed_read(void) {
+    auto board = std::make_unique<Board>();
+    board->run(40, 100, [](uint32_t i) { HostHal::temperature = 27 + (i % 20) * 0.01; });
+    board->run(20, 100, [](uint32_t i) { HostHal::temperature = i == 0 ? NAN : 27.1; });
+    TEST_ASSERT_FALSE(board->temperatureHealth().quarantined());
+    TEST_ASSERT_EQUAL_UINT32(1, board->temperatureHealth().rejected);
+
+    // Three failed reads in a row quarantine the channel, ten good ones release it
+    board->run(3 * 20, 100, [](uint32_t) { HostHal::temperature = NAN; });
+    TEST_ASSERT_EQUAL(SENSOR_INVALID, board->temperatureHealth().fault());
+    board->run(10 * 20, 100, [](uint32_t i) { HostHal::temperature = 27 + (i % 20) * 0.01; });
+    TEST_ASSERT_FALSE(board->temperatureHealth().quarantined());
+}
+
+/**
+ * @brief A single spike is rejected without a quarantine.
+ */
+void test_health_spike(void) {
+    auto board = std::make_unique<Board>();
+    board->run(10, 1000, [&](uint32_t i) { board->probe = 3300 + i % 3; });
+    board->run(1, 1000, [&](uint32_t) { board->probe = 2500; });
+    board->run(10, 1000, [&](uint32_t i) { board->probe = 3300 + i % 3; });
+    TEST_ASSERT_EQUAL_UINT32(1, board->soilHealth().rejected);
+    TEST_ASSERT_FALSE(board->soilHealth().quarantined());
+}
+
+int main(int argc, char **argv) {
+    (void) argc; (void) argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_health_disconnected_probe);
+    RUN_TEST(test_health_saturated_probe_is_not_railed);
+    RUN_TEST(test_health_shorted_probe);
+    RUN_TEST(test_health_stuck_window_is_time);
+    RUN_TEST(test_health_once_per_sample);
+    RUN_TEST(test_health_single_failed_read);
+    RUN_TEST(test_health_spike);
+    return UNITY_END();
+}
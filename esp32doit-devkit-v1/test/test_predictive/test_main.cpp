@@ -0,0 +1,148 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Predictive watering replay (env:native, pio test -e native -f test_predictive).
+ *  Boots the firmware on the SimBoard and runs the same weather and soil
+ *  for the threshold and the predictive modes. Before the fix, a stale
+ *  forecast plan restarted the pump right after each threshold stop:
+ *  predictive 30/80 pumped about 1.9 m³ in about 69000 cycles over 45 days,
+ *  against 119 L in 6 cycles for threshold 30/80.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <filesystem>
+#include "SimBoard"
+
+#define REPLAY_DAYS 45
+#define REPLAY_SEED 1
+
+/**
+ * @brief Totals of one replay, plus the shortest off-time of the relays.
+ */
+struct Replay {
+    SimResult result;
+    uint32_t shortestOffS = UINT32_MAX; ///< Relay off -> on again (seconds)
+    bool ok = false;
+};
+
+/**
+ * @brief Run one configuration in a child process (the firmware objects are globals).
+ */
+static Replay replay(const SimConfig &cfg) {
+    Replay out;
+    int fds[2];
+    if (pipe(fds) != 0) return out;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        std::string root = (std::filesystem::temp_directory_path()
+            / ("microbox-test-" + std::to_string(getpid()))).string();
+
+        Replay run;
+        uint32_t offAt = 0;
+        bool was = false;
+        SimBoard board(REPLAY_SEED);
+        board.onStep = [&](uint32_t t, const SimBoard &b) {
+            bool on = b.relay(0);
+            if (!on && was) offAt = t;
+            if (on && !was && offAt) run.shortestOffS = min(run.shortestOffS, t - offAt);
+            was = on;
+        };
+        board.begin(cfg, root.c_str());
+        run.result = board.run(REPLAY_DAYS);
+        run.ok = true;
+
+        std::error_code error;
+        std::filesystem::remove_all(root, error);
+        bool written = write(fds[1], &run, sizeof(run)) == (ssize_t) sizeof(run);
+        _exit(written ? 0 : 1);
+    }
+
+    close(fds[1]);
+    if (pid > 0 && read(fds[0], &out, sizeof(out)) != (ssize_t) sizeof(out)) out.ok = false;
+    close(fds[0]);
+    if (pid > 0) waitpid(pid, nullptr, 0);
+    return out;
+}
+
+static SimConfig config(uint8_t mode, uint8_t low, uint8_t high) {
+    SimConfig cfg;
+    cfg.watering.mode = mode;
+    cfg.watering.low = low;
+    cfg.watering.high = high;
+    return cfg;
+}
+
+static Replay threshold, predictive;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/**
+ * @brief The predictive mode uses about as much water as the threshold mode.
+ */
+void test_predictive_water_close_to_threshold(void) {
+    TEST_ASSERT_TRUE(threshold.ok && predictive.ok);
+    printf("threshold 30/80: %.1f L, %lu cycles, %.1f h stress\n", threshold.result.pumped,
+        (unsigned long) threshold.result.cycles, threshold.result.stressHours);
+    printf("predictive 30/80: %.1f L, %lu cycles, %.1f h stress\n", predictive.result.pumped,
+        (unsigned long) predictive.result.cycles, predictive.result.stressHours);
+
+    // Same cycles as the threshold mode, started earlier: within 5 % of its water
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(threshold.result.pumped * 1.05, predictive.result.pumped);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(threshold.result.cycles, predictive.result.cycles);
+}
+
+/**
+ * @brief Watering ahead of the crossing does not add plant stress.
+ */
+void test_predictive_no_extra_stress(void) {
+    TEST_ASSERT_TRUE(threshold.ok && predictive.ok);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(threshold.result.stressHours, predictive.result.stressHours);
+}
+
+/**
+ * @brief No restart right after a stop: the relay stays off for the minimum off-time.
+ */
+void test_predictive_minimum_off_time(void) {
+    TEST_ASSERT_TRUE(predictive.ok);
+    printf("shortest off-time: %lu s\n", (unsigned long) predictive.shortestOffS);
+    TEST_ASSERT_TRUE_MESSAGE(predictive.shortestOffS != UINT32_MAX, "no second cycle in the replay");
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(PREDICTIVE_MIN_OFF_MS / 1000, predictive.shortestOffS);
+}
+
+int main(int argc, char **argv) {
+    (void) argc; (void) argv;
+    threshold = replay(config(WATERING_MODE_THRESHOLD, 30, 80));
+    predictive = replay(config(WATERING_MODE_PREDICTIVE, 30, 80));
+
+    UNITY_BEGIN();
+    RUN_TEST(test_predictive_water_close_to_threshold);
+    RUN_TEST(test_predictive_no_extra_stress);
+    RUN_TEST(test_predictive_minimum_off_time);
+    return UNITY_END();
+}
@@ -0,0 +1,189 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Pulse-and-soak vs single-shot watering (env:native, pio test -e native -f test_pulsesoak).
+ *  The SimBoard runs until the first watering cycle of zone 0, once in
+ *  threshold mode (one shot from `start` until the probe reads `target`)
+ *  and once in pulse mode with the same levels. The bed soaks the water in
+ *  with a lag (SoilParams::soakTauS), so the single shot overshoots the
+ *  target and runs off; the pulses stop short of it and let it soak in.
+ *  Reports the peak level, the time to the target, the pump time and the
+ *  runoff of the cycle, and checks that the pulses leave relay.json alone.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <filesystem>
+#include "SimBoard"
+#include "MicroBox/hardware/RelayController"
+
+#define CYCLE_DAYS    1
+#define CYCLE_SEED    1
+#define CYCLE_WINDOW  3600  ///< Seconds after the first switch-on counted as the cycle
+#define CYCLE_START   30
+#define CYCLE_TARGET  60
+
+/**
+ * @brief First watering cycle of zone 0.
+ */
+struct Cycle {
+    uint32_t startS = UINT32_MAX;      ///< First switch-on (seconds since the boot)
+    uint32_t toTargetS = UINT32_MAX;   ///< Switch-on -> root zone at the target (seconds)
+    float peak = 0;                    ///< Highest root zone level of the cycle (percent)
+    double pumped = 0, runoff = 0;     ///< Litres on bed 0 during the cycle
+    uint32_t switchOns = 0;
+    bool stored = false;               ///< relay.json recorded the relay on at some point
+    bool ok = false;
+};
+
+/**
+ * @brief Run one configuration in a child process (the firmware objects are globals).
+ */
+static Cycle measure(const SimConfig &cfg) {
+    Cycle out;
+    int fds[2];
+    if (pipe(fds) != 0) return out;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        std::string root = (std::filesystem::temp_directory_path()
+            / ("microbox-test-" + std::to_string(getpid()))).string();
+
+        Cycle run;
+        double pumpedAt = 0, runoffAt = 0;
+        bool was = false;
+        SimBoard board(CYCLE_SEED);
+        board.onStep = [&](uint32_t t, const SimBoard &b) {
+            const SoilBed &bed = b.bed(0);
+            bool on = b.relay(0);
+            if (on && run.startS == UINT32_MAX) {
+                run.startS = t;
+                pumpedAt = bed.pumped;
+                runoffAt = bed.runoff;
+            }
+            if (run.startS != UINT32_MAX && t - run.startS <= CYCLE_WINDOW) {
+                run.peak = max(run.peak, bed.moisture);
+                if (run.toTargetS == UINT32_MAX && bed.moisture >= CYCLE_TARGET - PULSE_DEADBAND)
+                    run.toTargetS = t - run.startS;
+                if (on && !was) {
+                    run.switchOns++;
+                    RelayController::READ(RELAY_PINS[0]);
+                    run.stored |= RelayController::RELAY_STATE;
+                }
+                run.pumped = bed.pumped - pumpedAt;
+                run.runoff = bed.runoff - runoffAt;
+            }
+            was = on;
+        };
+        board.begin(cfg, root.c_str());
+        board.run(CYCLE_DAYS);
+        run.ok = run.startS != UINT32_MAX;
+
+        std::error_code error;
+        std::filesystem::remove_all(root, error);
+        bool written = write(fds[1], &run, sizeof(run)) == (ssize_t) sizeof(run);
+        _exit(written ? 0 : 1);
+    }
+
+    close(fds[1]);
+    if (pid > 0 && read(fds[0], &out, sizeof(out)) != (ssize_t) sizeof(out)) out.ok = false;
+    close(fds[0]);
+    if (pid > 0) waitpid(pid, nullptr, 0);
+    return out;
+}
+
+static SimConfig config(uint8_t mode) {
+    SimConfig cfg;
+    cfg.watering.mode = mode;
+    cfg.watering.low = CYCLE_START;
+    cfg.watering.high = CYCLE_TARGET;
+    cfg.soil = CYCLE_START - 2;
+    for (auto &zone : cfg.watering.zones) {
+        zone.start = CYCLE_START;
+        zone.target = CYCLE_TARGET;
+    }
+    return cfg;
+}
+
+static void print(const char *name, const Cycle &c) {
+    printf("%-10s start %lu s, peak %.1f %%, target in %lu s, %.0f s pump time, %.2f L runoff, %lu switch-ons\n",
+        name, (unsigned long) c.startS, c.peak, (unsigned long) c.toTargetS,
+        c.pumped / WATERING_FLOW_LPM * 60, c.runoff, (unsigned long) c.switchOns);
+}
+
+static Cycle single, pulse;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/**
+ * @brief The pulses stop at the target without runoff; the single shot overshoots it.
+ */
+void test_pulsesoak_less_overshoot(void) {
+    TEST_ASSERT_TRUE(single.ok && pulse.ok);
+    print("threshold", single);
+    print("pulse", pulse);
+
+    TEST_ASSERT_GREATER_THAN_FLOAT(CYCLE_TARGET + 2 * PULSE_DEADBAND, single.peak);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(CYCLE_TARGET + 2 * PULSE_DEADBAND, pulse.peak);
+    TEST_ASSERT_GREATER_THAN_FLOAT(0.5, single.runoff);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.05, pulse.runoff);
+    TEST_ASSERT_LESS_THAN_FLOAT(single.pumped, pulse.pumped);
+}
+
+/**
+ * @brief Both reach the target; the soaks cost time, bounded by the pulse budget.
+ */
+void test_pulsesoak_time_to_target(void) {
+    TEST_ASSERT_TRUE(single.ok && pulse.ok);
+    TEST_ASSERT_TRUE(single.toTargetS != UINT32_MAX && pulse.toTargetS != UINT32_MAX);
+
+    const WateringZoneConfig zone;
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(zone.maxPulses, pulse.switchOns);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(single.toTargetS, pulse.toTargetS);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(3 * single.toTargetS, pulse.toTargetS);
+}
+
+/**
+ * @brief Controller pulses switch the relay without storing it in relay.json.
+ */
+void test_pulsesoak_relay_not_stored(void) {
+    TEST_ASSERT_TRUE(pulse.ok);
+    TEST_ASSERT_GREATER_THAN_UINT32(1, pulse.switchOns);
+    TEST_ASSERT_FALSE(pulse.stored);
+}
+
+int main(int argc, char **argv) {
+    (void) argc; (void) argv;
+    single = measure(config(WATERING_MODE_THRESHOLD));
+    pulse = measure(config(WATERING_MODE_PULSE));
+
+    UNITY_BEGIN();
+    RUN_TEST(test_pulsesoak_less_overshoot);
+    RUN_TEST(test_pulsesoak_time_to_target);
+    RUN_TEST(test_pulsesoak_relay_not_stored);
+    return UNITY_END();
+}
@@ -0,0 +1,198 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Rain filter traces (env:native, pio test -e native -f test_rain).
+ *  Each trace is a rain sensor level per 1 s sample, shaped like the
+ *  recorded ones: a dry sensor with wiring spikes, a drizzle hovering on
+ *  the threshold, a 40 min storm and two showers. The old check
+ *  (`value >= 50` on a single read) is counted next to the filter.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include <functional>
+#include "MicroBox/hardware/sensor/RainFilter"
+
+#define TRACE_STEP_MS 1000 ///< One sample per second (RAIN_SAMPLE_MS)
+
+/**
+ * @brief Result of one trace.
+ */
+struct RainReplay {
+    RainFilter filter;
+    uint32_t now = 0;
+    uint32_t rawFlips = 0;      ///< State changes of `value >= 50`
+    uint32_t flips = 0;         ///< State changes of the filter
+    uint32_t deferredS = 0;     ///< Time the watering was deferred (seconds)
+    uint32_t wetEndS = 0;       ///< Time the filter last went dry (seconds)
+
+    /**
+     * @brief Feed `seconds` samples; `level(i)` is the sensor level of sample i.
+     */
+    void run(uint32_t seconds, const std::function<float(uint32_t)> &level) {
+        bool raw = false, state = false;
+        for (uint32_t i = 0; i < seconds; i++) {
+            float value = level(i);
+            if ((value >= 50) != raw) {
+                raw = !raw;
+                this->rawFlips++;
+            }
+            this->filter.update(value, this->now);
+            if (this->filter.raining() != state) {
+                state = !state;
+                this->flips++;
+                if (!state) this->wetEndS = this->now / 1000;
+            }
+            if (this->filter.deferred(this->now)) this->deferredS++;
+            this->now += TRACE_STEP_MS;
+        }
+    }
+
+    void print(const char *name) const {
+        printf("%-20s raw flips %4lu | filtered flips %lu, episodes %lu, rain %lu s, soaked %d, deferred %lu min\n",
+            name, (unsigned long) this->rawFlips, (unsigned long) this->flips,
+            (unsigned long) this->filter.episodes, (unsigned long) this->filter.rainSeconds,
+            this->filter.soaked(), (unsigned long) this->deferredS / 60);
+    }
+};
+
+/**
+ * @brief Deterministic noise in [-1, 1].
+ */
+static uint32_t seed = 7;
+static float noise() {
+    seed = seed * 1103515245UL + 12345UL;
+    return ((seed >> 16) % 2001) / 1000.0f - 1.0f;
+}
+
+void setUp(void) { seed = 7; }
+void tearDown(void) {}
+
+/**
+ * @brief Wiring spikes on a dry sensor trip the old check, never the filter.
+ */
+void test_rain_dry_with_spikes(void) {
+    RainReplay replay;
+    replay.run(2 * 3600, [](uint32_t i) { return 10 + 3 * noise() + (i % 900 == 0 ? 90 : 0); });
+    replay.print("dry with spikes");
+    TEST_ASSERT_GREATER_THAN_UINT32(0, replay.rawFlips);
+    TEST_ASSERT_EQUAL_UINT32(0, replay.flips);
+    TEST_ASSERT_EQUAL_UINT32(0, replay.deferredS);
+}
+
+/**
+ * @brief A drizzle hovering on the threshold: the hysteresis keeps one state change at most.
+ */
+void test_rain_drizzle_on_threshold(void) {
+    RainReplay replay;
+    replay.run(2 * 3600, [](uint32_t) { return 50 + 8 * noise(); });
+    replay.print("drizzle at 50 %");
+    TEST_ASSERT_GREATER_THAN_UINT32(100, replay.rawFlips);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, replay.flips);
+}
+
+/**
+ * @brief A 40 min storm is one episode; the dry-out grows with the rain time.
+ */
+void test_rain_storm_dry_out(void) {
+    RainReplay replay;
+    replay.run(4 * 3600, [](uint32_t i) { return (i >= 1800 && i < 1800 + 2400 ? 85 : 10) + 5 * noise(); });
+    replay.print("40 min storm");
+    TEST_ASSERT_EQUAL_UINT32(1, replay.filter.episodes);
+    TEST_ASSERT_EQUAL_UINT32(2, replay.flips);
+    TEST_ASSERT_UINT32_WITHIN(60, 2400, replay.filter.rainSeconds);
+    TEST_ASSERT_TRUE(replay.filter.soaked());
+
+    // Dry-out: RAIN_DRYOUT_MIN + RAIN_DRYOUT_FACTOR per minute of rain
+    uint32_t dryOutS = (RAIN_DRYOUT_MIN + RAIN_DRYOUT_FACTOR * 40) * 60;
+    uint32_t end = replay.wetEndS + dryOutS;
+    TEST_ASSERT_TRUE(replay.filter.deferred((end - 60) * 1000));
+    TEST_ASSERT_FALSE(replay.filter.deferred((end + 60) * 1000));
+}
+
+/**
+ * @brief A shower during the dry-out of the previous one extends the same episode.
+ */
+void test_rain_two_showers(void) {
+    RainReplay replay;
+    replay.run(6 * 3600, [](uint32_t i) {
+        bool wet = (i >= 600 && i < 600 + 600) || (i >= 7200 && i < 7200 + 900);
+        return (wet ? 75 : 12) + 4 * noise();
+    });
+    replay.print("two showers");
+    TEST_ASSERT_EQUAL_UINT32(2, replay.filter.episodes);
+    TEST_ASSERT_UINT32_WITHIN(60, 1500, replay.filter.rainSeconds);
+    TEST_ASSERT_FALSE(replay.filter.soaked());
+
+    // The second dry-out counts both showers (25 min of rain)
+    uint32_t dryOutS = (RAIN_DRYOUT_MIN + RAIN_DRYOUT_FACTOR * 25) * 60;
+    uint32_t end = replay.wetEndS + dryOutS;
+    TEST_ASSERT_TRUE(replay.filter.deferred((end - 120) * 1000));
+    TEST_ASSERT_FALSE(replay.filter.deferred((end + 120) * 1000));
+}
+
+/**
+ * @brief Failed reads (NaN) keep the state and still count the rain time.
+ */
+void test_rain_failed_reads(void) {
+    RainReplay replay;
+    replay.run(600, [](uint32_t) { return 80 + 3 * noise(); });
+    TEST_ASSERT_TRUE(replay.filter.raining());
+    uint32_t before = replay.filter.rainSeconds;
+    replay.run(60, [](uint32_t) { return NAN; });
+    TEST_ASSERT_TRUE(replay.filter.raining());
+    TEST_ASSERT_UINT32_WITHIN(2, before + 60, replay.filter.rainSeconds);
+}
+
+/**
+ * @brief The 24 hour rain time rolls off with the hour bins.
+ */
+void test_rain_24h_roll_off(void) {
+    RainReplay replay;
+    replay.run(3600, [](uint32_t) { return 90; });
+    replay.run(600, [](uint32_t) { return 5; });
+    uint32_t rained = replay.filter.rainSeconds24h();
+    printf("1 h rain: 24 h total %lu s\n", (unsigned long) rained);
+    TEST_ASSERT_UINT32_WITHIN(60, 3600, rained);
+    TEST_ASSERT_TRUE(replay.filter.soaked());
+
+    for (uint32_t i = 0; i < 25 * 60; i++) {
+        replay.now += 60000;
+        replay.filter.update(5, replay.now);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, replay.filter.rainSeconds24h());
+    TEST_ASSERT_FALSE(replay.filter.soaked());
+    TEST_ASSERT_FALSE(replay.filter.deferred(replay.now));
+}
+
+int main(int argc, char **argv) {
+    (void) argc; (void) argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_rain_dry_with_spikes);
+    RUN_TEST(test_rain_drizzle_on_threshold);
+    RUN_TEST(test_rain_storm_dry_out);
+    RUN_TEST(test_rain_two_showers);
+    RUN_TEST(test_rain_failed_reads);
+    RUN_TEST(test_rain_24h_roll_off);
+    return UNITY_END();
+}
@@ -0,0 +1,199 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Rule compiler and VM (env:native, pio test -e native -f test_rules).
+ *  The sample rules are compiled and run against a few inputs, malformed
+ *  and over-deep sources must be refused, then each sample rule is run
+ *  BENCH_RUNS times to report the cost of one run() (host) and the memory
+ *  of one Rule.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <string>
+#include "MicroBox/software/RuleEngine"
+
+#define ZONES      2
+#define BENCH_RUNS 1000000
+
+using BenchClock = std::chrono::steady_clock;
+
+static const char *const SAMPLES[] = {
+    "soil < 25 && hour >= 6 -> zone1 on for 120s",
+    "rain >= 50 -> hold for 3600",
+    "soil < 30 && temp > 32 -> all on for 90",
+    "soil > 60 -> all off",
+    "(temp - hum / 5) > 20 && !(rain > 10) -> zone2 on for 60",
+    "dow == 0 || dow == 6 && hour == 7 -> zone1 on for 300",
+};
+
+static const char *const MALFORMED[] = {
+    "soil < 30",                        // no action
+    "soil < -> zone1 on for 10",        // missing operand
+    "soil < 30 -> zone3 on for 10",     // zone out of range
+    "soil < 30 -> zone1 on for 0",      // duration out of range
+    "soil < 30 -> zone1 on",            // no duration
+    "moisture < 30 -> all off",         // unknown input
+    "(soil < 30 -> all off",            // unbalanced parenthesis
+    "soil < 30 -> all off now",         // trailing text
+};
+
+static RuleEngine engine;
+
+void setUp(void) {
+    engine = RuleEngine();
+}
+
+void tearDown(void) {}
+
+/**
+ * @brief Every sample compiles, fits in a Rule and only fires on its edge.
+ */
+void test_rules_samples_compile(void) {
+    for (const char *text : SAMPLES) {
+        int index = engine.add(text, ZONES);
+        TEST_ASSERT_TRUE_MESSAGE(index >= 0, text);
+        printf("%2u B  %s\n", (unsigned) engine.rules[index].length, text);
+        TEST_ASSERT_LESS_OR_EQUAL(RULE_CODE_MAX, engine.rules[index].length);
+    }
+
+    // soil < 25 && hour >= 6: fires once when it becomes true, not while it stays true
+    uint8_t fired = 0;
+    auto fire = [&](uint8_t index, const Rule &) { if (index == 0) fired++; };
+    engine.set(RULE_IN_SOIL, 40);
+    engine.set(RULE_IN_HOUR, 7);
+    engine.evaluate(fire);
+    TEST_ASSERT_EQUAL_UINT8(0, fired);
+    engine.set(RULE_IN_SOIL, 20);
+    engine.evaluate(fire);
+    TEST_ASSERT_EQUAL_UINT8(1, fired);
+    engine.set(RULE_IN_SOIL, 19);
+    engine.evaluate(fire);
+    TEST_ASSERT_EQUAL_UINT8(1, fired);
+
+    // (temp - hum / 5) > 20 && !(rain > 10)
+    engine.set(RULE_IN_TEMP, 35);
+    engine.set(RULE_IN_HUM, 50);
+    engine.set(RULE_IN_RAIN, 0);
+    TEST_ASSERT_TRUE(engine.run(engine.rules[4]) != 0);
+    engine.set(RULE_IN_RAIN, 80);
+    TEST_ASSERT_TRUE(engine.run(engine.rules[4]) == 0);
+
+    // A failed read (NaN) makes the comparison false
+    engine.set(RULE_IN_SOIL, NAN);
+    TEST_ASSERT_TRUE(engine.run(engine.rules[0]) == 0);
+}
+
+/**
+ * @brief Malformed sources are refused.
+ */
+void test_rules_malformed_rejected(void) {
+    Rule rule;
+    for (const char *text : MALFORMED)
+        TEST_ASSERT_FALSE_MESSAGE(engine.compile(text, rule, ZONES), text);
+    TEST_ASSERT_EQUAL_INT(-1, engine.add(MALFORMED[0], ZONES));
+    TEST_ASSERT_EQUAL_UINT8(0, engine.count);
+}
+
+/**
+ * @brief Nesting deeper than RULE_STACK and sources of RULE_TEXT_LEN are refused.
+ */
+void test_rules_nesting_bounded(void) {
+    Rule rule;
+    auto nested = [](const char *open, const char *close, int depth) {
+        std::string text;
+        for (int i = 0; i < depth; i++) text += open;
+        text += "soil";
+        for (int i = 0; i < depth; i++) text += close;
+        return text + " < 1 -> all off";
+    };
+
+    // The outer expression is one level: RULE_STACK - 1 parentheses is the deepest
+    TEST_ASSERT_TRUE(engine.compile(nested("(", ")", RULE_STACK - 1).c_str(), rule, ZONES));
+    TEST_ASSERT_FALSE(engine.compile(nested("(", ")", RULE_STACK).c_str(), rule, ZONES));
+    TEST_ASSERT_FALSE(engine.compile(nested("-", "", RULE_STACK).c_str(), rule, ZONES));
+    TEST_ASSERT_FALSE(engine.compile(nested("!", "", RULE_STACK).c_str(), rule, ZONES));
+    TEST_ASSERT_FALSE(engine.compile(nested("(-!", ")", RULE_STACK).c_str(), rule, ZONES));
+
+    // Far deeper than the stack: refused without recursing once per character
+    std::string deep(RULE_TEXT_LEN - 1, '(');
+    TEST_ASSERT_FALSE(engine.compile(deep.c_str(), rule, ZONES));
+
+    // Too long, even if valid
+    std::string text = "soil < 30";
+    while (text.size() < RULE_TEXT_LEN) text += " && soil < 30";
+    TEST_ASSERT_FALSE(engine.compile((text + " -> all off").c_str(), rule, ZONES));
+}
+
+/**
+ * @brief Cost of run() per rule and memory per rule.
+ */
+void test_rules_cost(void) {
+    for (const char *text : SAMPLES) engine.add(text, ZONES);
+    engine.set(RULE_IN_SOIL, 20);
+    engine.set(RULE_IN_TEMP, 33);
+    engine.set(RULE_IN_HUM, 60);
+    engine.set(RULE_IN_RAIN, 5);
+    engine.set(RULE_IN_HOUR, 7);
+    engine.set(RULE_IN_DOW, 6);
+
+    volatile float sink = 0;
+    double slowest = 0;
+    for (uint8_t i = 0; i < engine.count; i++) {
+        auto start = BenchClock::now();
+        for (int run = 0; run < BENCH_RUNS; run++) sink = sink + engine.run(engine.rules[i]);
+        double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count() / BENCH_RUNS;
+        printf("%5.1f ns/run  %2u B  %s\n", ns, (unsigned) engine.rules[i].length, SAMPLES[i]);
+        if (ns > slowest) slowest = ns;
+    }
+    printf("sizeof(Rule) %u B, %d rules %u B\n",
+        (unsigned) sizeof(Rule), RULE_MAX, (unsigned) sizeof(engine.rules));
+
+    // The bytecode plus a few bytes of metadata per rule
+    TEST_ASSERT_LESS_OR_EQUAL(RULE_CODE_MAX + 8, sizeof(Rule));
+    TEST_ASSERT_LESS_THAN_FLOAT(1000.0, slowest);
+
+    // One hour of 10 Hz ticks with steady inputs: only the rules of the input that moved run
+    engine.evaluate([](uint8_t, const Rule &) {});
+    uint32_t evaluations = engine.evaluations;
+    for (uint32_t tick = 0; tick < 36000; tick++) {
+        engine.set(RULE_IN_SOIL, 20);
+        engine.set(RULE_IN_TEMP, 33);
+        engine.set(RULE_IN_HOUR, tick < 18000 ? 7 : 8);
+        engine.evaluate([](uint8_t, const Rule &) {});
+    }
+    printf("1 h of 10 Hz ticks: %lu evaluations, %lu skipped\n",
+        (unsigned long) (engine.evaluations - evaluations), (unsigned long) engine.skipped);
+    TEST_ASSERT_EQUAL_UINT32(2, engine.evaluations - evaluations);
+}
+
+int main(int argc, char **argv) {
+    (void) argc; (void) argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_rules_samples_compile);
+    RUN_TEST(test_rules_malformed_rejected);
+    RUN_TEST(test_rules_nesting_bounded);
+    RUN_TEST(test_rules_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,183 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Zone scheduler throughput (env:native, pio test -e native -f test_scheduler).
+ *  The SimBoard boots in pulse mode with both beds below `start`, so both
+ *  zones want their pulses at once, and runs until their cycles are done:
+ *  one pump with the fair policy, one pump with the priority policy (zone 1
+ *  first) and two pumps. Reports the zones served per hour of the watering
+ *  (ZoneScheduler::serviced over the time a relay was on or queued) and the
+ *  waits per zone.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <filesystem>
+#include "SimBoard"
+#include "MicroBox/software/WateringSys"
+#include "MicroBox/externobj"
+
+#define SCHED_DAYS    1
+#define SCHED_SEED    1
+#define SCHED_WINDOW  3600  ///< Seconds after the boot the cycles must be done in
+
+/**
+ * @brief Scheduler state once the cycles are done.
+ */
+struct Throughput {
+    uint32_t serviced = 0;             ///< Pumps granted
+    uint32_t busyS = 0;                ///< Boot -> last relay off or queued zone (seconds)
+    ZoneWaitStats stats[WATERING_ZONES];
+    uint8_t maxActive = 0;             ///< Most zones on at once
+    bool ok = false;
+
+    float perHour() const { return this->busyS ? this->serviced * 3600.0 / this->busyS : 0; }
+};
+
+/**
+ * @brief Run one configuration in a child process (the firmware objects are globals).
+ */
+static Throughput measure(const SimConfig &cfg) {
+    Throughput out;
+    int fds[2];
+    if (pipe(fds) != 0) return out;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        std::string root = (std::filesystem::temp_directory_path()
+            / ("microbox-test-" + std::to_string(getpid()))).string();
+
+        Throughput run;
+        SimBoard board(SCHED_SEED);
+        board.onStep = [&](uint32_t t, const SimBoard &b) {
+            if (t > SCHED_WINDOW) return;
+            uint8_t active = 0;
+            for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+                if (b.relay(i)) active++;
+                if (b.relay(i) || wateringSys.scheduler.queued(i)) run.busyS = t;
+            }
+            run.maxActive = max(run.maxActive, active);
+            run.serviced = wateringSys.scheduler.serviced;
+            memcpy(run.stats, wateringSys.scheduler.stats, sizeof(run.stats));
+        };
+        board.begin(cfg, root.c_str());
+        board.run(SCHED_DAYS);
+        run.ok = run.busyS > 0 && run.busyS < SCHED_WINDOW;
+
+        std::error_code error;
+        std::filesystem::remove_all(root, error);
+        bool written = write(fds[1], &run, sizeof(run)) == (ssize_t) sizeof(run);
+        _exit(written ? 0 : 1);
+    }
+
+    close(fds[1]);
+    if (pid > 0 && read(fds[0], &out, sizeof(out)) != (ssize_t) sizeof(out)) out.ok = false;
+    close(fds[0]);
+    if (pid > 0) waitpid(pid, nullptr, 0);
+    return out;
+}
+
+static SimConfig config(uint8_t pumps, uint8_t policy) {
+    SimConfig cfg;
+    cfg.soil = 28;
+    cfg.watering.mode = WATERING_MODE_PULSE;
+    cfg.watering.pumps = pumps;
+    cfg.watering.policy = policy;
+    for (auto &zone : cfg.watering.zones) {
+        zone.start = 30;
+        zone.target = 60;
+    }
+    cfg.watering.zones[1].priority = 1;
+    return cfg;
+}
+
+static void print(const char *name, const Throughput &r) {
+    printf("%-18s %2lu grants in %4lu s: %5.1f zones/h, at most %u on", name,
+        (unsigned long) r.serviced, (unsigned long) r.busyS, r.perHour(), r.maxActive);
+    for (uint8_t i = 0; i < WATERING_ZONES; i++)
+        printf(", z%u wait avg/max %lu/%lu s", i,
+            (unsigned long) r.stats[i].averageWaitMs() / 1000, (unsigned long) r.stats[i].maxWaitMs / 1000);
+    printf("\n");
+}
+
+static Throughput fair, priority, twoPumps;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/**
+ * @brief Every setup serves the same pulses; the policy does not cost throughput, a second pump adds to it.
+ */
+void test_scheduler_throughput(void) {
+    print("1 pump, fair", fair);
+    print("1 pump, priority", priority);
+    print("2 pumps, fair", twoPumps);
+    TEST_ASSERT_TRUE(fair.ok && priority.ok && twoPumps.ok);
+
+    TEST_ASSERT_UINT32_WITHIN(2, fair.serviced, priority.serviced);
+    TEST_ASSERT_UINT32_WITHIN(2, fair.serviced, twoPumps.serviced);
+    TEST_ASSERT_GREATER_OR_EQUAL_FLOAT(fair.perHour() * 0.95, priority.perHour());
+    TEST_ASSERT_GREATER_OR_EQUAL_FLOAT(fair.perHour(), twoPumps.perHour());
+}
+
+/**
+ * @brief The capacity holds, and a zone waits at most for the pulse in progress.
+ */
+void test_scheduler_capacity(void) {
+    TEST_ASSERT_TRUE(fair.ok && priority.ok && twoPumps.ok);
+    TEST_ASSERT_EQUAL_UINT8(1, fair.maxActive);
+    TEST_ASSERT_EQUAL_UINT8(1, priority.maxActive);
+    TEST_ASSERT_EQUAL_UINT8(2, twoPumps.maxActive);
+
+    const WateringZoneConfig zone;
+    for (uint8_t i = 0; i < WATERING_ZONES; i++) {
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(zone.pulseMaxMs, fair.stats[i].maxWaitMs);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(zone.pulseMaxMs, priority.stats[i].maxWaitMs);
+        TEST_ASSERT_EQUAL_UINT32(0, twoPumps.stats[i].maxWaitMs);
+    }
+}
+
+/**
+ * @brief With the priority policy the waits move from zone 1 to zone 0.
+ */
+void test_scheduler_priority_first(void) {
+    TEST_ASSERT_TRUE(fair.ok && priority.ok);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(fair.stats[1].totalWaitMs, priority.stats[1].totalWaitMs);
+    TEST_ASSERT_LESS_THAN_UINT32(priority.stats[0].totalWaitMs, priority.stats[1].totalWaitMs);
+}
+
+int main(int argc, char **argv) {
+    (void) argc; (void) argv;
+    fair = measure(config(1, SCHED_FAIR));
+    priority = measure(config(1, SCHED_PRIORITY));
+    twoPumps = measure(config(2, SCHED_FAIR));
+
+    UNITY_BEGIN();
+    RUN_TEST(test_scheduler_throughput);
+    RUN_TEST(test_scheduler_capacity);
+    RUN_TEST(test_scheduler_priority_first);
+    return UNITY_END();
+}
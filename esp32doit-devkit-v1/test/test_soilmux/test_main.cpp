@@ -0,0 +1,172 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  SoilMux scanner on a mock mux/ADC (env:native, pio test -e native -f test_soilmux).
+ *  The mock keeps its own microsecond clock: a select line write costs
+ *  MOCK_WRITE_US and one ADC conversion MOCK_ADC_US, about what an ESP32
+ *  digitalWrite() and analogRead() take. The scan latency printed here is
+ *  the one quoted for SOIL_OVERSAMPLING in include/variable.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include "MicroBox/hardware/sensor/SoilMux"
+
+#define MOCK_WRITE_US 2
+#define MOCK_ADC_US   10
+#define MOCK_SETTLE   200
+
+/**
+ * @brief Mux and ADC with the SoilMuxHardware interface.
+ * @details Channel `ch` reads 4095 - 100 * ch, so a value tells which channel was selected.
+ */
+struct MockMux {
+    static unsigned long us, ms;
+    static uint8_t pins[4];     ///< Select pins, in S0..S3 order
+    static uint8_t selected;    ///< Channel on the select lines
+    static uint32_t writes, reads;
+
+    static void reset() { us = 0; ms = 0; selected = 0; writes = 0; reads = 0; }
+    static void output(uint8_t pin) { (void) pin; }
+    static void input(uint8_t pin) { (void) pin; }
+    static void write(uint8_t pin, bool level) {
+        for (uint8_t bit = 0; bit < 4; bit++) {
+            if (pins[bit] != pin) continue;
+            selected = level ? (selected | (1 << bit)) : (selected & ~(1 << bit));
+        }
+        us += MOCK_WRITE_US;
+        writes++;
+    }
+    static int read(uint8_t pin, uint8_t samples) {
+        (void) pin;
+        if (samples == 0) samples = 1;
+        us += MOCK_ADC_US * samples;
+        reads += samples;
+        return 4095 - 100 * selected;
+    }
+    static void settle(uint32_t wait) { us += wait; }
+    static unsigned long now() { return us; }
+    static unsigned long nowMillis() { return ms; }
+};
+
+unsigned long MockMux::us = 0, MockMux::ms = 0;
+uint8_t MockMux::pins[4] = { 16, 17, 19, 23 };
+uint8_t MockMux::selected = 0;
+uint32_t MockMux::writes = 0, MockMux::reads = 0;
+
+static void begin(SoilMux<16, MockMux> &mux) {
+    MockMux::reset();
+    mux.begin(16, 17, 19, 23, 36, MOCK_SETTLE, 1000);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/**
+ * @brief Every channel is read with its own select code.
+ */
+void test_soilmux_reads_every_channel(void) {
+    SoilMux<16, MockMux> mux;
+    begin(mux);
+    mux.scan(false);
+    for (uint8_t ch = 0; ch < 16; ch++)
+        TEST_ASSERT_EQUAL_INT(4095 - 100 * ch, mux.value[ch]);
+
+    mux.scan(true, 4095, 2500);
+    TEST_ASSERT_EQUAL_INT(4095 - 1500, mux.raw[15]);
+    TEST_ASSERT_EQUAL_INT(0, mux.value[0]);
+    TEST_ASSERT_EQUAL_INT(SoilMoisture::toPercent(4095 - 1500, 4095, 2500), mux.value[15]);
+}
+
+/**
+ * @brief Only the select bits that change are written: 4 + 26 writes for the first scan, 30 after.
+ */
+void test_soilmux_toggles_changed_bits(void) {
+    SoilMux<16, MockMux> mux;
+    begin(mux);
+    mux.scan();
+    TEST_ASSERT_EQUAL_UINT32(30, MockMux::writes);
+
+    MockMux::writes = 0;
+    mux.scan();
+    printf("select writes per scan: %lu (64 when every line is written)\n", (unsigned long) MockMux::writes);
+    TEST_ASSERT_EQUAL_UINT32(30, MockMux::writes);
+}
+
+/**
+ * @brief Scan latency: settling plus one conversion per read and channel, plus the switching.
+ */
+void test_soilmux_scan_latency(void) {
+    for (uint8_t oversampling : { 1, 4 }) {
+        SoilMux<16, MockMux> mux;
+        begin(mux);
+        mux.oversampling = oversampling;
+        mux.scan();
+        mux.scan();
+
+        unsigned long expected = 16 * (MOCK_SETTLE + MOCK_ADC_US * oversampling) + 30 * MOCK_WRITE_US;
+        printf("oversampling %u: scan %lu us, switch %lu us per channel, %lu ADC reads\n",
+            oversampling, mux.scanMicros, mux.switchMicros, (unsigned long) MockMux::reads / 2);
+        TEST_ASSERT_EQUAL_UINT32(expected, mux.scanMicros);
+        TEST_ASSERT_EQUAL_UINT32(30 * MOCK_WRITE_US / 16, mux.switchMicros);
+    }
+}
+
+/**
+ * @brief run() publishes one scan per period.
+ */
+void test_soilmux_period(void) {
+    SoilMux<16, MockMux> mux;
+    begin(mux);
+    MockMux::ms = 1000;
+    TEST_ASSERT_TRUE(mux.run());
+    MockMux::ms = 1999;
+    TEST_ASSERT_FALSE(mux.run());
+    MockMux::ms = 2000;
+    TEST_ASSERT_TRUE(mux.run());
+    mux.setPeriod(5000);
+    MockMux::ms = 6999;
+    TEST_ASSERT_FALSE(mux.run());
+    TEST_ASSERT_EQUAL_UINT32(2, mux.scanCount);
+}
+
+/**
+ * @brief The default is a single conversion per sample.
+ */
+void test_soilmux_default_oversampling(void) {
+    SoilMux<16, MockMux> mux;
+    SoilMoisture probe;
+    TEST_ASSERT_EQUAL_UINT8(1, mux.oversampling);
+    TEST_ASSERT_EQUAL_UINT8(1, probe.oversampling);
+}
+
+int main(int argc, char **argv) {
+    (void) argc; (void) argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_soilmux_reads_every_channel);
+    RUN_TEST(test_soilmux_toggles_changed_bits);
+    RUN_TEST(test_soilmux_scan_latency);
+    RUN_TEST(test_soilmux_period);
+    RUN_TEST(test_soilmux_default_oversampling);
+    return UNITY_END();
+}
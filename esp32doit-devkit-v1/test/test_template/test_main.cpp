@@ -0,0 +1,297 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Template heap and time-to-first-byte bench (env:native, pio test -e native -f test_template).
+ *  The pages of data/WEB/html are compiled into .tpl files the way
+ *  compress_assets.py does, on a host LittleFS. Each page is then rendered
+ *  two ways: the old handlers (whole page read into a String, one
+ *  String::replace per placeholder, then copied into the response) and
+ *  WebTemplate::fill() in send-buffer-sized chunks, as sendTemplate()'s
+ *  filler does. The heap is the peak of operator new while a page is served.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <regex>
+#include "MicroBox/software/WebTemplate"
+#include "MicroBox/software/LFSMemory"
+
+#define BENCH_CHUNK  1436   ///< Send buffer of one chunk (TCP MSS of the ESP32 stack)
+#define BENCH_ROUNDS 2000
+
+namespace stdfs = std::filesystem;
+using BenchClock = std::chrono::steady_clock;
+
+// Heap accounting: live and peak bytes of operator new while `heapTrack` is set
+static size_t heapLive = 0, heapPeak = 0;
+static bool heapTrack = false;
+
+void *operator new(size_t size) {
+    size_t *block = (size_t *) malloc(size + sizeof(max_align_t));
+    if (block == nullptr) throw std::bad_alloc();
+    *block = size;
+    if (heapTrack) {
+        heapLive += size;
+        if (heapLive > heapPeak) heapPeak = heapLive;
+    }
+    return (uint8_t *) block + sizeof(max_align_t);
+}
+
+void operator delete(void *ptr) noexcept {
+    if (ptr == nullptr) return;
+    size_t *block = (size_t *) ((uint8_t *) ptr - sizeof(max_align_t));
+    if (heapTrack) heapLive -= min(heapLive, *block);
+    free(block);
+}
+
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete[](void *ptr) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { operator delete(ptr); }
+
+static void heapStart() {
+    heapLive = heapPeak = 0;
+    heapTrack = true;
+}
+
+static size_t heapStop() {
+    heapTrack = false;
+    return heapPeak;
+}
+
+static const char *const NAMES[TPL_COUNT] = {
+    #define X(name) #name,
+    WEB_TEMPLATE_VARS
+    #undef X
+};
+
+static const stdfs::path PAGES = stdfs::path(__FILE__).parent_path() / "../../data/WEB/html";
+static const String DIRHTML = "/WEB/html/";
+static std::string root;
+
+/**
+ * @brief Compile one page into a .tpl (compile_template() of compress_assets.py).
+ */
+static void compilePage(const stdfs::path &src, const stdfs::path &dest) {
+    std::ifstream in(src, std::ios::binary);
+    std::string page((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::string out;
+
+    auto literal = [&](const std::string &data) {
+        for (size_t at = 0; at < data.size(); at += 0xFFFF) {
+            std::string part = data.substr(at, 0xFFFF);
+            out += (char) TPL_LITERAL;
+            out += (char) (part.size() & 0xFF);
+            out += (char) (part.size() >> 8);
+            out += part;
+        }
+    };
+
+    std::regex placeholder("%([A-Z0-9_]+)%");
+    size_t at = 0;
+    for (auto it = std::sregex_iterator(page.begin(), page.end(), placeholder); it != std::sregex_iterator(); ++it) {
+        uint8_t id = 0;
+        while (id < TPL_COUNT && it->str(1) != NAMES[id]) id++;
+        TEST_ASSERT_TRUE_MESSAGE(id < TPL_COUNT, it->str(0).c_str());
+        literal(page.substr(at, it->position() - at));
+        out += (char) TPL_PLACEHOLDER;
+        out += (char) id;
+        at = it->position() + it->length();
+    }
+    literal(page.substr(at));
+
+    std::ofstream(dest, std::ios::binary) << out;
+}
+
+/**
+ * @brief Values of the index page (WebServerClass::index()), a short value for the others.
+ */
+static void fillValues(WebTemplate &page) {
+    for (uint8_t id = 0; id < TPL_COUNT; id++)
+        page.set((TemplateVar) id, String("v") + id);
+    page.set(TPL_VERSION_PROJECT, "MicroBox v1.0.0");
+    page.set(TPL_VAR1, "Auto Watering");
+    page.set(TPL_VARID1, "auto");
+    page.set(TPL_CHECKED1, "checked");
+    page.set(TPL_VAR2, "Relay 1");
+    page.set(TPL_VARID2, "26");
+    page.set(TPL_CHECKED2, "");
+    page.set(TPL_VAR3, "Relay 2");
+    page.set(TPL_VARID3, "27");
+    page.set(TPL_CHECKED3, "checked");
+}
+
+/**
+ * @brief Old handlers: file_buffer(), String::replace per placeholder, response copy.
+ */
+static void renderReplace(const String &path, std::string &out, double *firstByteUs) {
+    auto start = BenchClock::now();
+    WebTemplate values;
+    fillValues(values);
+
+    File file = LittleFS.open(path, LFS_READ);
+    size_t size = file.size();
+    std::unique_ptr<char[]> buffer(new char[size + 1]);
+    file.readBytes(buffer.get(), size);
+    buffer[size] = 0;
+    file.close();
+
+    String page(buffer.get());
+    buffer.reset();
+    for (uint8_t id = 0; id < TPL_COUNT; id++)
+        page.replace(String("%") + NAMES[id] + "%", values.value(NAMES[id]));
+    String response(page);
+    *firstByteUs = std::chrono::duration<double, std::micro>(BenchClock::now() - start).count();
+    out.assign(response.c_str(), response.length());
+}
+
+/**
+ * @brief WebTemplate streamed in `chunk`-byte pieces (sendTemplate()'s filler).
+ */
+static void renderStream(const String &path, size_t chunk, std::string &out, double *firstByteUs) {
+    auto start = BenchClock::now();
+    auto page = std::make_shared<WebTemplate>();
+    TEST_ASSERT_TRUE(page->open(LittleFS, path));
+    TEST_ASSERT_TRUE(page->compiled());
+    fillValues(*page);
+
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[chunk]);  // the library's send buffer
+    size_t len;
+    *firstByteUs = 0;
+    while ((len = page->fill(buffer.get(), chunk)) > 0) {
+        if (*firstByteUs == 0)
+            *firstByteUs = std::chrono::duration<double, std::micro>(BenchClock::now() - start).count();
+        out.append((const char *) buffer.get(), len);
+    }
+}
+
+/**
+ * @brief Heap peak and mean first-byte time of a render over BENCH_ROUNDS.
+ * @details The output is collected in a string reserved beforehand, so it is not counted.
+ */
+struct Bench {
+    size_t peak = 0;
+    double firstByteUs = 0;
+    size_t bytes = 0;
+};
+
+template <typename F>
+static Bench bench(F &&render) {
+    Bench result;
+    std::string out;
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        double first = 0;
+        out.clear();
+        out.reserve(1 << 16);
+        heapStart();
+        render(out, &first);
+        result.peak = max(result.peak, heapStop());
+        result.firstByteUs += first / BENCH_ROUNDS;
+        result.bytes = out.size();
+    }
+    return result;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/**
+ * @brief The streamed page is byte for byte the page of the old handlers.
+ */
+void test_template_same_output(void) {
+    for (const auto &entry : stdfs::directory_iterator(PAGES)) {
+        String path = DIRHTML + entry.path().filename().string().c_str();
+        double first;
+        std::string expected, small, chunk;
+        renderReplace(path, expected, &first);
+        renderStream(path, 64, small, &first);
+        renderStream(path, BENCH_CHUNK, chunk, &first);
+        TEST_ASSERT_GREATER_THAN(0, expected.size());
+        TEST_ASSERT_EQUAL_STRING(expected.c_str(), small.c_str());
+        TEST_ASSERT_EQUAL_STRING(expected.c_str(), chunk.c_str());
+    }
+}
+
+/**
+ * @brief Heap of the index page: the page is never held in RAM, the peak follows the chunk.
+ */
+void test_template_heap_bounded_by_chunk(void) {
+    String index = DIRHTML + "index.html";
+    Bench before = bench([&](std::string &out, double *first) { renderReplace(index, out, first); });
+    Bench small = bench([&](std::string &out, double *first) { renderStream(index, 256, out, first); });
+    Bench chunk = bench([&](std::string &out, double *first) { renderStream(index, BENCH_CHUNK, out, first); });
+
+    printf("index.html %lu B, String::replace: peak heap %lu B\n",
+        (unsigned long) before.bytes, (unsigned long) before.peak);
+    printf("index.tpl streamed: peak heap %lu B with 256 B chunks, %lu B with %d B chunks\n",
+        (unsigned long) small.peak, (unsigned long) chunk.peak, BENCH_CHUNK);
+
+    // Page object and values, plus the chunk: a bigger chunk adds at most its own size
+    TEST_ASSERT_LESS_OR_EQUAL(chunk.peak, small.peak);
+    TEST_ASSERT_LESS_OR_EQUAL(BENCH_CHUNK - 256, chunk.peak - small.peak);
+    TEST_ASSERT_LESS_THAN(before.bytes, chunk.peak);
+    // The old handlers held the page at least twice (read buffer or String, and the response copy)
+    TEST_ASSERT_GREATER_OR_EQUAL(2 * before.bytes, before.peak);
+}
+
+/**
+ * @brief Time to first byte: the first chunk goes out before the page is read.
+ */
+void test_template_first_byte(void) {
+    String index = DIRHTML + "index.html";
+    Bench before = bench([&](std::string &out, double *first) { renderReplace(index, out, first); });
+    Bench chunk = bench([&](std::string &out, double *first) { renderStream(index, BENCH_CHUNK, out, first); });
+
+    printf("index first byte: %.1f us String::replace, %.1f us streamed (host)\n",
+        before.firstByteUs, chunk.firstByteUs);
+    TEST_ASSERT_LESS_THAN_FLOAT(before.firstByteUs, chunk.firstByteUs);
+}
+
+int main(int argc, char **argv) {
+    (void) argc; (void) argv;
+    root = (stdfs::temp_directory_path() / ("microbox-template-" + std::to_string(getpid()))).string();
+    HostHal::fsRoot = root;
+    LittleFS.begin(true);
+    stdfs::create_directories(root + DIRHTML.c_str());
+    for (const auto &entry : stdfs::directory_iterator(PAGES)) {
+        stdfs::path page = root + DIRHTML.c_str() + entry.path().filename().string();
+        stdfs::copy_file(entry.path(), page, stdfs::copy_options::overwrite_existing);
+        compilePage(entry.path(), stdfs::path(page).replace_extension(".tpl"));
+    }
+
+    UNITY_BEGIN();
+    RUN_TEST(test_template_same_output);
+    RUN_TEST(test_template_heap_bounded_by_chunk);
+    RUN_TEST(test_template_first_byte);
+    int failures = UNITY_END();
+
+    std::error_code error;
+    stdfs::remove_all(root, error);
+    return failures;
+}
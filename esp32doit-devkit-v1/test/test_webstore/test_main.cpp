@@ -0,0 +1,272 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @date 2025
+ *  @author basyair7
+ *
+ *  @brief
+ *  Web UI store bench (env:native, pio test -e native -f test_webstore).
+ *  data/WEB is copied to a host LittleFS and packed into a webui image the
+ *  way compress_assets.py does, then 4 clients fetch the assets and pages
+ *  over and over. As on the device, one task serves the clients in turn,
+ *  one send buffer per chunk: from LittleFS the response reads an open file
+ *  (AsyncFileResponse), from the image it copies straight out of the mapped
+ *  bytes (beginResponse_P). Reports requests per second (host) and the
+ *  peak heap while the 4 responses are in flight. On the device each open
+ *  LittleFS file also holds its own cache, which the host FS does not have.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include "MicroBox/software/WebStore"
+#include "MicroBox/software/LFSMemory"
+
+#define BENCH_CLIENTS  4
+#define BENCH_CHUNK    1436    ///< Send buffer of one chunk (TCP MSS of the ESP32 stack)
+#define BENCH_REQUESTS 20000   ///< Requests per run, over all clients
+
+namespace stdfs = std::filesystem;
+using BenchClock = std::chrono::steady_clock;
+
+// Heap accounting: live and peak bytes of operator new while `heapTrack` is set
+static size_t heapLive = 0, heapPeak = 0;
+static bool heapTrack = false;
+
+void *operator new(size_t size) {
+    size_t *block = (size_t *) malloc(size + sizeof(max_align_t));
+    if (block == nullptr) throw std::bad_alloc();
+    *block = size;
+    if (heapTrack) {
+        heapLive += size;
+        if (heapLive > heapPeak) heapPeak = heapLive;
+    }
+    return (uint8_t *) block + sizeof(max_align_t);
+}
+
+void operator delete(void *ptr) noexcept {
+    if (ptr == nullptr) return;
+    size_t *block = (size_t *) ((uint8_t *) ptr - sizeof(max_align_t));
+    if (heapTrack) heapLive -= min(heapLive, *block);
+    free(block);
+}
+
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete[](void *ptr) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { operator delete(ptr); }
+
+static const stdfs::path DATA = stdfs::path(__FILE__).parent_path() / "../../data";
+static std::string root;
+static std::vector<String> paths;       ///< Files of the web UI ("/WEB/...")
+static std::vector<uint8_t> image;      ///< Packed webui image
+static WebStore store;
+
+/**
+ * @brief Pack the files into one image (Assets.pack() of compress_assets.py).
+ */
+static std::vector<uint8_t> pack(const std::vector<std::pair<std::string, std::string>> &files) {
+    std::vector<uint8_t> entries, data;
+    uint32_t offset = sizeof(WebStoreHeader) + files.size() * sizeof(WebStoreEntry);
+    for (const auto &file : files) {
+        offset += (4 - offset % 4) % 4;
+        data.resize(data.size() + (4 - data.size() % 4) % 4, 0);
+
+        WebStoreEntry entry = {};
+        entry.offset = offset;
+        entry.size = file.second.size();
+        strncpy(entry.path, file.first.c_str(), WEB_STORE_PATH_MAX - 1);
+        entries.insert(entries.end(), (uint8_t *) &entry, (uint8_t *) &entry + sizeof(entry));
+        data.insert(data.end(), file.second.begin(), file.second.end());
+        offset += file.second.size();
+    }
+    data.resize(data.size() + (4 - data.size() % 4) % 4, 0);
+
+    WebStoreHeader header = { WEB_STORE_MAGIC, WEB_STORE_VERSION, (uint16_t) files.size(),
+        (uint32_t) (sizeof(header) + entries.size() + data.size()) };
+    std::vector<uint8_t> out((uint8_t *) &header, (uint8_t *) &header + sizeof(header));
+    out.insert(out.end(), entries.begin(), entries.end());
+    out.insert(out.end(), data.begin(), data.end());
+    return out;
+}
+
+/**
+ * @brief One response in flight: the open file, or the bytes in the image.
+ */
+struct Response {
+    File file;
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+    size_t sent = 0;
+    bool active = false;
+};
+
+/**
+ * @brief Requests per second and heap of one run.
+ */
+struct Bench {
+    double perSecond = 0;
+    size_t peak = 0;
+    uint32_t opened = 0;        ///< Files opened (HostHal::fsReads)
+    uint64_t bytes = 0;
+    uint32_t checksum = 0;      ///< Sum of all bytes sent, same for both stores
+};
+
+/**
+ * @brief Serve BENCH_REQUESTS to BENCH_CLIENTS clients, one chunk per client in turn.
+ */
+static Bench serve(bool mapped) {
+    Bench result;
+    Response clients[BENCH_CLIENTS];
+    uint32_t started = 0, done = 0;
+    uint32_t reads = HostHal::fsReads;
+
+    heapLive = heapPeak = 0;
+    heapTrack = true;
+    auto start = BenchClock::now();
+    while (done < BENCH_REQUESTS) {
+        for (auto &client : clients) {
+            if (!client.active) {
+                if (started == BENCH_REQUESTS) continue;
+                const String &path = paths[started++ % paths.size()];
+                if (mapped) {
+                    TEST_ASSERT_TRUE(store.find(path.c_str(), &client.data, &client.size));
+                }
+                else {
+                    client.file = LittleFS.open(path, LFS_READ);
+                    TEST_ASSERT_TRUE((bool) client.file);
+                    client.size = client.file.size();
+                }
+                client.sent = 0;
+                client.active = true;
+            }
+
+            // One _ack(): a send buffer filled from the response, then handed to TCP
+            size_t len = min((size_t) BENCH_CHUNK, client.size - client.sent);
+            std::unique_ptr<uint8_t[]> buffer(new uint8_t[len ? len : 1]);
+            if (mapped) memcpy(buffer.get(), client.data + client.sent, len);
+            else TEST_ASSERT_EQUAL_UINT32(len, client.file.read(buffer.get(), len));
+            for (size_t i = 0; i < len; i++) result.checksum += buffer[i];
+            client.sent += len;
+            result.bytes += len;
+
+            if (client.sent == client.size) {
+                if (!mapped) client.file.close();
+                client.active = false;
+                done++;
+            }
+        }
+    }
+    double seconds = std::chrono::duration<double>(BenchClock::now() - start).count();
+    heapTrack = false;
+
+    result.perSecond = BENCH_REQUESTS / seconds;
+    result.peak = heapPeak;
+    result.opened = HostHal::fsReads - reads;
+    return result;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/**
+ * @brief The packed image lists every file with the same bytes as LittleFS.
+ */
+void test_webstore_image(void) {
+    TEST_ASSERT_EQUAL_UINT32(paths.size(), store.count());
+    for (const auto &path : paths) {
+        const uint8_t *data;
+        size_t size;
+        TEST_ASSERT_TRUE_MESSAGE(store.find(path.c_str(), &data, &size), path.c_str());
+        File file = LittleFS.open(path, LFS_READ);
+        std::vector<uint8_t> content(file.size());
+        file.read(content.data(), content.size());
+        TEST_ASSERT_EQUAL_UINT32(content.size(), size);
+        TEST_ASSERT_TRUE(memcmp(content.data(), data, size) == 0);
+    }
+
+    const uint8_t *data;
+    size_t size;
+    TEST_ASSERT_FALSE(store.find("/WEB/js/missing.js", &data, &size));
+
+    // A damaged image is refused
+    WebStore damaged;
+    std::vector<uint8_t> copy = image;
+    copy[0] ^= 0xFF;
+    TEST_ASSERT_FALSE(damaged.begin(copy.data(), copy.size()));
+    TEST_ASSERT_FALSE(damaged.begin(image.data(), sizeof(WebStoreHeader) - 1));
+    TEST_ASSERT_FALSE(damaged.ready());
+}
+
+/**
+ * @brief 4 clients: the mapped image serves more requests with no file handle.
+ */
+void test_webstore_four_clients(void) {
+    Bench lfs = serve(false);
+    Bench mapped = serve(true);
+
+    printf("%d clients, %d requests, %.1f KB each on average\n", BENCH_CLIENTS, BENCH_REQUESTS,
+        lfs.bytes / 1024.0 / BENCH_REQUESTS);
+    printf("LittleFS: %.0f req/s, peak heap %lu B, %lu files opened\n",
+        lfs.perSecond, (unsigned long) lfs.peak, (unsigned long) lfs.opened);
+    printf("mapped:   %.0f req/s, peak heap %lu B, %lu files opened (host)\n",
+        mapped.perSecond, (unsigned long) mapped.peak, (unsigned long) mapped.opened);
+
+    TEST_ASSERT_EQUAL_UINT32(lfs.checksum, mapped.checksum);
+    TEST_ASSERT_EQUAL_UINT32(BENCH_REQUESTS, lfs.opened);
+    TEST_ASSERT_EQUAL_UINT32(0, mapped.opened);
+    TEST_ASSERT_LESS_OR_EQUAL(BENCH_CLIENTS * BENCH_CHUNK, mapped.peak);
+    TEST_ASSERT_LESS_THAN(lfs.peak, mapped.peak);
+    TEST_ASSERT_GREATER_THAN_FLOAT(lfs.perSecond, mapped.perSecond);
+}
+
+int main(int argc, char **argv) {
+    (void) argc; (void) argv;
+    root = (stdfs::temp_directory_path() / ("microbox-webstore-" + std::to_string(getpid()))).string();
+    HostHal::fsRoot = root;
+    LittleFS.begin(true);
+    stdfs::copy(DATA / "WEB", stdfs::path(root) / "WEB", stdfs::copy_options::recursive);
+
+    std::vector<std::pair<std::string, std::string>> files;
+    for (const auto &entry : stdfs::recursive_directory_iterator(stdfs::path(root) / "WEB")) {
+        if (!entry.is_regular_file()) continue;
+        std::string path = "/" + stdfs::relative(entry.path(), root).generic_string();
+        std::ifstream in(entry.path(), std::ios::binary);
+        files.emplace_back(path, std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>()));
+    }
+    std::sort(files.begin(), files.end());
+    for (const auto &file : files) paths.push_back(file.first.c_str());
+    image = pack(files);
+    store.begin(image.data(), image.size());
+
+    UNITY_BEGIN();
+    RUN_TEST(test_webstore_image);
+    RUN_TEST(test_webstore_four_clients);
+    int failures = UNITY_END();
+
+    std::error_code error;
+    stdfs::remove_all(root, error);
+    return failures;
+}
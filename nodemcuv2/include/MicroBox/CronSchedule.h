@@ -0,0 +1,414 @@
+/**
+ *  @file CronSchedule.h
+ *  @version 1.0.1
+ *  @author basyair7
+ *  @date 2025
+ *
+ *  @brief
+ *  Cron-style watering schedules. An expression ("min hour dom mon dow",
+ *  with `*`, lists, ranges and steps) is compiled into bitmasks, and the next
+ *  fire time is computed directly from the masks: a bit scan per field and at
+ *  most one step per month, instead of testing every minute. Times are local
+ *  epoch seconds (seconds since 1970-01-01 00:00 in local time).
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <Arduino.h>
+
+#define SCHEDULE_MAX        8   ///< Schedules kept in memory
+#define SCHEDULE_EXPR_LEN   40  ///< Longest cron expression (including terminator)
+#define SCHEDULE_GRACE_SEC  60  ///< A fire later than this counts as missed
+
+#define CATCHUP_SKIP 0 ///< Missed windows are dropped
+#define CATCHUP_LATE 1 ///< Join a missed window for the time it has left
+#define CATCHUP_ONCE 2 ///< Run a missed window once, in full, as soon as possible
+
+/**
+ * @class CronExpr
+ * @brief Compiled five-field cron expression.
+ */
+class CronExpr {
+    uint64_t _minutes = 0; ///< Bits 0..59
+    uint32_t _hours = 0;   ///< Bits 0..23
+    uint32_t _days = 0;    ///< Bits 1..31
+    uint16_t _months = 0;  ///< Bits 1..12
+    uint8_t _weekdays = 0; ///< Bits 0..6, Sunday = 0
+    bool _anyDay = true, _anyWeekday = true;
+
+    public:
+        /**
+         * @brief Compile an expression.
+         * @return `false` if the expression is invalid (the previous one is kept).
+         */
+        bool parse(const char *expr) {
+            uint64_t fields[5];
+            bool any[5];
+            const uint8_t lo[5] = { 0, 0, 1, 1, 0 };
+            const uint8_t hi[5] = { 59, 23, 31, 12, 7 };
+
+            const char *p = expr;
+            for (uint8_t f = 0; f < 5; f++) {
+                while (*p == ' ') p++;
+                const char *end = p;
+                while (*end && *end != ' ') end++;
+                if (end == p || !parseField(p, end, lo[f], hi[f], fields[f], any[f]))
+                    return false;
+                p = end;
+            }
+            while (*p == ' ') p++;
+            if (*p) return false;
+
+            this->_minutes  = fields[0];
+            this->_hours    = fields[1];
+            this->_days     = fields[2];
+            this->_months   = fields[3];
+            this->_weekdays = (fields[4] | (fields[4] >> 7)) & 0x7F; // 7 is Sunday as well
+            this->_anyDay     = any[2];
+            this->_anyWeekday = any[4];
+            return true;
+        }
+
+        /**
+         * @brief First fire time strictly after `after`.
+         * @return Local epoch seconds, or 0 if nothing matches within eight years.
+         */
+        uint32_t next(uint32_t after) const {
+            if (!this->_minutes || !this->_hours || !this->_months) return 0;
+
+            uint32_t t = after - after % 60 + 60;
+            int32_t days = t / 86400;
+            int hour = (t % 86400) / 3600, minute = (t % 3600) / 60;
+            int year, month, day;
+            civil(days, year, month, day);
+
+            // Every iteration moves to a later month, so the loop is bounded
+            for (uint8_t guard = 0; guard < 100; guard++) {
+                if (!(this->_months & (1U << month))) {
+                    nextMonth(year, month, day, hour, minute);
+                    continue;
+                }
+
+                int last = daysInMonth(year, month);
+                uint32_t mask = this->dayMask(year, month, last) & (0xFFFFFFFFUL << day);
+                while (mask) {
+                    int d = __builtin_ctzl(mask);
+                    if (d != day) hour = minute = 0;
+                    day = d;
+                    int h = nextBit(this->_hours, hour);
+                    int m = (h == hour) ? nextBit(this->_minutes, minute) : -1;
+                    if (h == hour && m < 0) h = nextBit(this->_hours, hour + 1);
+                    if (h >= 0) {
+                        if (m < 0 || h != hour) m = nextBit(this->_minutes, 0);
+                        return (uint32_t) daysFromCivil(year, month, day) * 86400 + h * 3600 + m * 60;
+                    }
+                    // Nothing left on this day
+                    mask &= mask - 1;
+                }
+                nextMonth(year, month, day, hour, minute);
+            }
+
+            return 0;
+        }
+
+        /**
+         * @brief Days since 1970-01-01 of a civil date.
+         */
+        static int32_t daysFromCivil(int y, int m, int d) {
+            y -= m <= 2;
+            const int32_t era = (y >= 0 ? y : y - 399) / 400;
+            const uint32_t yoe = (uint32_t) (y - era * 400);
+            const uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+            const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+            return era * 146097 + (int32_t) doe - 719468;
+        }
+
+        /**
+         * @brief Civil date of a day count since 1970-01-01.
+         */
+        static void civil(int32_t z, int &y, int &m, int &d) {
+            z += 719468;
+            const int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+            const uint32_t doe = (uint32_t) (z - era * 146097);
+            const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+            const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            const uint32_t mp = (5 * doy + 2) / 153;
+            d = doy - (153 * mp + 2) / 5 + 1;
+            m = mp < 10 ? mp + 3 : mp - 9;
+            y = (int) yoe + era * 400 + (m <= 2);
+        }
+
+    private:
+        static int daysInMonth(int y, int m) {
+            static const uint8_t DAYS[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+            bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+            return DAYS[m - 1] + (m == 2 && leap);
+        }
+
+        static int nextBit(uint64_t mask, int from) {
+            if (from > 63) return -1;
+            uint64_t rest = mask & (~0ULL << from);
+            return rest ? __builtin_ctzll(rest) : -1;
+        }
+
+        static void nextMonth(int &y, int &m, int &d, int &hour, int &minute) {
+            if (++m > 12) { m = 1; y++; }
+            d = 1;
+            hour = minute = 0;
+        }
+
+        /**
+         * @brief Days of a month (bits 1..last) matching the day-of-month and weekday fields.
+         * @details Standard cron rule: if both fields are restricted a day matches either.
+         */
+        uint32_t dayMask(int y, int m, int last) const {
+            uint32_t month = (last == 31) ? 0xFFFFFFFEUL : (((1UL << last) - 1) << 1);
+
+            // Weekly pattern rotated so bit 0 is the weekday of the 1st
+            uint8_t first = (uint8_t) ((daysFromCivil(y, m, 1) % 7 + 11) % 7); // 1970-01-01 was a Thursday
+            uint32_t week = ((this->_weekdays >> first) | (this->_weekdays << (7 - first))) & 0x7F;
+            uint32_t weekdays = (week | week << 7 | week << 14 | week << 21 | week << 28) << 1;
+
+            uint32_t mask;
+            if (this->_anyDay && this->_anyWeekday) mask = month;
+            else if (this->_anyDay)                 mask = weekdays;
+            else if (this->_anyWeekday)             mask = this->_days;
+            else                                    mask = this->_days | weekdays;
+            return mask & month;
+        }
+
+        /**
+         * @brief Parse one field: `*`, `a`, `a-b`, any of them with `/step`, comma separated.
+         */
+        static bool parseField(const char *p, const char *end, uint8_t lo, uint8_t hi, uint64_t &mask, bool &any) {
+            mask = 0;
+            any = (*p == '*');
+            while (p < end) {
+                int from, to, step = 1;
+                if (*p == '*') {
+                    from = lo; to = hi; p++;
+                }
+                else {
+                    if (!readNumber(p, end, from)) return false;
+                    to = from;
+                    if (p < end && *p == '-') {
+                        p++;
+                        if (!readNumber(p, end, to)) return false;
+                    }
+                }
+                if (p < end && *p == '/') {
+                    p++;
+                    if (!readNumber(p, end, step) || step == 0) return false;
+                    if (from == to) to = hi;
+                }
+                if (from < lo || to > hi || from > to) return false;
+                for (int v = from; v <= to; v += step) mask |= 1ULL << v;
+
+                if (p < end) {
+                    if (*p != ',') return false;
+                    p++;
+                    any = false;
+                }
+            }
+            return mask != 0;
+        }
+
+        static bool readNumber(const char *&p, const char *end, int &value) {
+            if (p >= end || *p < '0' || *p > '9') return false;
+            value = 0;
+            while (p < end && *p >= '0' && *p <= '9') value = value * 10 + (*p++ - '0');
+            return true;
+        }
+};
+
+/**
+ * @brief One stored watering schedule.
+ */
+struct WateringSchedule {
+    char expr[SCHEDULE_EXPR_LEN] = "0 7 * * *"; ///< Cron expression
+    uint16_t duration = 60;                     ///< Window length (minutes)
+    uint8_t zones = 0xFF;                       ///< Bitmask of relays opened by the schedule
+    uint8_t catchup = CATCHUP_SKIP;             ///< What to do with a missed window
+    bool enabled = true;
+    uint32_t last = 0;                          ///< Start of the last window (local epoch)
+};
+
+/**
+ * @class ScheduleEngine
+ * @brief Keeps the next fire and the end of the running window of every schedule.
+ * @details The caller sleeps until `nextEvent()` and then calls `poll()`; the
+ *          expressions are only evaluated when a window starts.
+ */
+class ScheduleEngine {
+    CronExpr _cron[SCHEDULE_MAX];
+    uint32_t _next[SCHEDULE_MAX] = {};  ///< Next start (0 = none)
+    uint32_t _until[SCHEDULE_MAX] = {}; ///< End of the running window (0 = not running)
+    uint32_t _catchupUntil[SCHEDULE_MAX] = {}; ///< End of a window joined late
+
+    public:
+        WateringSchedule items[SCHEDULE_MAX];
+        uint8_t count = 0;
+        bool dirty = false; ///< `last` changed and should be stored
+
+    public:
+        /**
+         * @brief Add a schedule.
+         * @return Index, or -1 if the expression is invalid or the table is full.
+         */
+        int add(const WateringSchedule &item) {
+            if (this->count >= SCHEDULE_MAX) return -1;
+            CronExpr cron;
+            if (!cron.parse(item.expr)) return -1;
+
+            uint8_t i = this->count++;
+            this->items[i] = item;
+            this->_cron[i] = cron;
+            this->_next[i] = this->_until[i] = this->_catchupUntil[i] = 0;
+            return i;
+        }
+
+        /**
+         * @brief Remove a schedule (a running window is dropped without a stop event).
+         */
+        bool remove(uint8_t index) {
+            if (index >= this->count) return false;
+            for (uint8_t i = index; i + 1 < this->count; i++) {
+                this->items[i] = this->items[i + 1];
+                this->_cron[i] = this->_cron[i + 1];
+                this->_next[i] = this->_next[i + 1];
+                this->_until[i] = this->_until[i + 1];
+                this->_catchupUntil[i] = this->_catchupUntil[i + 1];
+            }
+            this->count--;
+            return true;
+        }
+
+        void clear() { this->count = 0; }
+
+        /**
+         * @brief Compute every next fire from the clock, applying the catch-up policies.
+         * @details Call at boot and whenever the clock was adjusted.
+         */
+        void begin(uint32_t now) {
+            for (uint8_t i = 0; i < this->count; i++)
+                this->resolve(i, now);
+        }
+
+        /**
+         * @brief Start and stop the windows that are due.
+         * @param now Current local epoch.
+         * @param start Callable `(uint8_t index, const WateringSchedule &item, uint32_t seconds)`.
+         * @param stop Callable `(uint8_t index, const WateringSchedule &item)`.
+         */
+        template <typename Start, typename Stop>
+        void poll(uint32_t now, Start &&start, Stop &&stop) {
+            for (uint8_t i = 0; i < this->count; i++) {
+                WateringSchedule &item = this->items[i];
+
+                if (this->_until[i] && now >= this->_until[i]) {
+                    this->_until[i] = 0;
+                    stop(i, item);
+                }
+
+                if (!item.enabled || !this->_next[i] || now < this->_next[i]) continue;
+
+                // Fired much later than planned (clock jump, long stall): apply the policy
+                if (now - this->_next[i] > SCHEDULE_GRACE_SEC && !this->_catchupUntil[i]) {
+                    this->resolve(i, now);
+                    if (!this->_next[i] || now < this->_next[i]) continue;
+                }
+
+                uint32_t until = this->_catchupUntil[i] ? this->_catchupUntil[i] : now + item.duration * 60UL;
+                this->_catchupUntil[i] = 0;
+                if (until > now) {
+                    this->_until[i] = until;
+                    item.last = now;
+                    this->dirty = true;
+                    start(i, item, until - now);
+                }
+                this->_next[i] = this->_cron[i].next(now);
+            }
+        }
+
+        /**
+         * @brief Earliest pending start or stop (0 if none).
+         */
+        uint32_t nextEvent() const {
+            uint32_t event = 0;
+            for (uint8_t i = 0; i < this->count; i++) {
+                uint32_t n = this->items[i].enabled ? this->_next[i] : 0;
+                if (n && (!event || n < event)) event = n;
+                if (this->_until[i] && (!event || this->_until[i] < event)) event = this->_until[i];
+            }
+            return event;
+        }
+
+        uint32_t next(uint8_t index) const { return index < this->count ? this->_next[index] : 0; }
+        bool running(uint8_t index) const { return index < this->count && this->_until[index]; }
+
+        static const char *catchupText(uint8_t policy) {
+            switch (policy) {
+                case CATCHUP_LATE: return "late";
+                case CATCHUP_ONCE: return "once";
+                default:           return "skip";
+            }
+        }
+
+        static uint8_t catchupFromText(const char *text) {
+            if (strcmp(text, "late") == 0) return CATCHUP_LATE;
+            if (strcmp(text, "once") == 0) return CATCHUP_ONCE;
+            return CATCHUP_SKIP;
+        }
+
+    private:
+        /**
+         * @brief Set the next fire of a schedule, queueing a catch-up run if a window was missed.
+         */
+        void resolve(uint8_t i, uint32_t now) {
+            const WateringSchedule &item = this->items[i];
+            const CronExpr &cron = this->_cron[i];
+            uint32_t window = item.duration * 60UL;
+            this->_catchupUntil[i] = 0;
+
+            if (!this->_until[i]) {
+                if (item.catchup == CATCHUP_LATE) {
+                    // Latest window that is still open
+                    uint32_t from = (now > window) ? now - window : 0;
+                    if (item.last > from) from = item.last;
+                    uint32_t open = cron.next(from);
+                    if (open && open + SCHEDULE_GRACE_SEC < now && open + window > now) {
+                        this->_next[i] = now;
+                        this->_catchupUntil[i] = open + window;
+                        return;
+                    }
+                }
+                else if (item.catchup == CATCHUP_ONCE && item.last) {
+                    // Missed at least one window since the last run
+                    uint32_t missed = cron.next(item.last);
+                    if (missed && missed + SCHEDULE_GRACE_SEC < now) {
+                        this->_next[i] = now;
+                        this->_catchupUntil[i] = now + window;
+                        return;
+                    }
+                }
+            }
+
+            this->_next[i] = cron.next(now - 1);
+        }
+};
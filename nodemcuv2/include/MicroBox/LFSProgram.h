@@ -32,6 +32,7 @@
 #include <ArduinoJson.h>
 #include <vector>
 #include "variable.h"
+#include "CronSchedule.h"
 #include "envWiFi.h"
 
 extern "C" {
@@ -158,14 +159,35 @@ class LFSProgram {
          */
         void readConfigState(String stateConfig, bool *value);
 
+        /**
+         * @brief Load the stored watering schedules (invalid entries are skipped).
+         * @param engine Destination engine (cleared first).
+         */
+        void readSchedules(ScheduleEngine &engine);
+
+        /**
+         * @brief Store the watering schedules (including the last run of each).
+         * @param engine Schedules to store.
+         */
+        void changeSchedules(const ScheduleEngine &engine);
+
+        /**
+         * @brief Serialize watering schedules.
+         * @param engine Schedules to serialize.
+         * @param obj Destination object -> {"schedules": [...]}
+         */
+        void schedulesToJson(const ScheduleEngine &engine, JsonObject obj);
+
     private:
         void initializeOrUpdateWiFiConfig(const String &cfile, std::function<void (StaticJsonDocument<500>&)> updateFunc);
         void initializeOrUpdateState(const String &cfile, std::function<void (StaticJsonDocument<200>&)> updateFunc);
         void initializeOrUpdateVarRelay(const String &cfile, std::function<void (DynamicJsonDocument&)> updateFunc);
+        void initializeOrUpdateSchedules(const String &cfile, std::function<void (DynamicJsonDocument&)> updateFunc);
 
         void initializeState(void);
         void initializeWiFiConfig(void);
         void initializeVarRelay(void);
+        void initializeSchedules(void);
 
         String readconfig(const String path);
         bool removefileconfig(const String path);
@@ -220,4 +242,5 @@ class LFSProgram {
         const String file_config_wifi  = "/CONFIG/config_wifi.json";
         const String file_config_relay = "/CONFIG/config_relay.json";
         const String file_config_state = "/CONFIG/config_state.json";
+        const String file_config_schedule = "/CONFIG/config_schedule.json";
 };
@@ -24,11 +24,13 @@
 #pragma once
 
 #include <Arduino.h>
+#include "RainFilter.h"
 
 class RainCheck {
     public:
         static int VALUE;
         int value;
+        RainFilter filter; ///< Filtered rain state (mapped readings only)
         
     public:
         static RainCheck &instance() {
@@ -61,7 +63,13 @@ class RainCheck {
             }
 
             int _raw_result = analogRead(this->__pinIn__);
-            this->value = mapping ? map(_raw_result, 0, in_max, 0, 100) : _raw_result;
+            if (mapping) {
+                this->value = constrain(map(_raw_result, 0, in_max, 0, 100), 0, 100);
+                this->filter.update(this->value, millis());
+            }
+            else {
+                this->value = _raw_result;
+            }
         }
 
     private:
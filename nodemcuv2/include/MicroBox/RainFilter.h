@@ -0,0 +1,248 @@
+/**
+ *  @file RainFilter.h
+ *  @version 1.0.0
+ *  @author basyair7
+ *  @date 2025
+ *
+ *  @brief
+ *  Rain detection from the analog rain sensor level. A 5-sample median drops
+ *  single-read spikes and an exponential average smooths the rest; the wet
+ *  and dry states switch on two different levels (hysteresis) and only after
+ *  the new state held for `confirmMs`. After the rain stops, watering stays
+ *  deferred for a dry-out window that grows with how long it rained. The rain
+ *  time of the last 24 hours is kept in hourly bins, so a deferred watering
+ *  can be skipped when it already rained long enough.
+ *
+ *  @copyright
+ *  Copyright (C) 2025, basyair7
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <Arduino.h>
+#include <math.h>
+
+#ifndef RAIN_ON_LEVEL
+#define RAIN_ON_LEVEL       50       ///< Filtered level that starts a rain (percent)
+#endif
+#ifndef RAIN_OFF_LEVEL
+#define RAIN_OFF_LEVEL      35       ///< Filtered level that ends a rain (percent)
+#endif
+#ifndef RAIN_CONFIRM_MS
+#define RAIN_CONFIRM_MS     20000    ///< A new state must hold this long (milliseconds)
+#endif
+#ifndef RAIN_DRYOUT_MIN
+#define RAIN_DRYOUT_MIN     120      ///< Base dry-out window after the rain (minutes)
+#endif
+#ifndef RAIN_DRYOUT_FACTOR
+#define RAIN_DRYOUT_FACTOR  2        ///< Extra dry-out per minute of rain (minutes)
+#endif
+#ifndef RAIN_DRYOUT_MAX_MIN
+#define RAIN_DRYOUT_MAX_MIN 1440     ///< Longest dry-out window (minutes)
+#endif
+#ifndef RAIN_SKIP_MIN
+#define RAIN_SKIP_MIN       30       ///< Rain in the last 24 hours that makes a deferred watering unnecessary (minutes)
+#endif
+
+#define RAIN_MEDIAN_N       5        ///< Median window (samples)
+#define RAIN_EMA_ALPHA      0.3      ///< Weight of a new median in the average
+
+/**
+ * @brief Rain detection settings.
+ */
+struct RainConfig {
+    uint8_t onLevel = RAIN_ON_LEVEL;
+    uint8_t offLevel = RAIN_OFF_LEVEL;
+    uint32_t confirmMs = RAIN_CONFIRM_MS;
+    uint16_t dryOutMin = RAIN_DRYOUT_MIN;
+    uint8_t dryOutFactor = RAIN_DRYOUT_FACTOR;
+    uint16_t dryOutMaxMin = RAIN_DRYOUT_MAX_MIN;
+    uint16_t skipMin = RAIN_SKIP_MIN;
+};
+
+/**
+ * @class RainFilter
+ * @brief Filtered rain state, dry-out window and 24 hour rain time.
+ * @details Time is passed in by the caller (millis()) so the filter can run on host.
+ */
+class RainFilter {
+    float _window[RAIN_MEDIAN_N];
+    uint8_t _count = 0, _next = 0;
+    float _level = NAN;
+
+    bool _raining = false;
+    bool _pending = false;         ///< The other state is being confirmed
+    uint32_t _pendingSince = 0;
+    uint32_t _last = 0;            ///< Time of the previous sample
+    bool _started = false;
+
+    bool _recovering = false;      ///< Dry-out window running
+    uint32_t _dryAt = 0;           ///< End of the last rain
+    uint32_t _recoveryMs = 0;      ///< Length of the current dry-out window
+    uint32_t _episodeMs = 0;       ///< Rain time of the current episode
+
+    uint16_t _hourSec[24] = {};    ///< Rain seconds per hour bin
+    uint32_t _hour = 0;            ///< Hour (since boot) of the current bin
+    uint32_t _carryMs = 0;         ///< Rain milliseconds not yet counted in a bin
+
+    public:
+        RainConfig config;
+        uint32_t episodes = 0;         ///< Rains detected since boot
+        uint32_t rainSeconds = 0;      ///< Rain time since boot
+
+    public:
+        /**
+         * @brief Feed one sensor level.
+         * @param value Rain level (percent), NaN if the read failed.
+         * @param now Milliseconds (millis()).
+         */
+        void update(float value, uint32_t now) {
+            if (!this->_started) {
+                this->_started = true;
+                this->_last = now;
+                this->_hour = now / 3600000UL;
+            }
+            this->roll(now);
+
+            // Rain time since the previous sample
+            if (this->_raining) this->addRain(now - this->_last);
+            this->_last = now;
+
+            if (isnan(value)) return;
+            this->_window[this->_next] = value;
+            this->_next = (this->_next + 1) % RAIN_MEDIAN_N;
+            if (this->_count < RAIN_MEDIAN_N) this->_count++;
+
+            float median = this->median();
+            this->_level = isnan(this->_level) ? median : this->_level + RAIN_EMA_ALPHA * (median - this->_level);
+
+            bool wet = this->_raining
+                ? this->_level > this->config.offLevel
+                : this->_level >= this->config.onLevel;
+            if (wet == this->_raining) {
+                this->_pending = false;
+                return;
+            }
+            if (!this->_pending) {
+                this->_pending = true;
+                this->_pendingSince = now;
+            }
+            if (now - this->_pendingSince < this->config.confirmMs) return;
+
+            this->_pending = false;
+            this->_raining = wet;
+            if (wet) {
+                // Rain again during the dry-out continues the same episode
+                if (!this->recovering(now)) this->_episodeMs = 0;
+                this->_recovering = false;
+                this->episodes++;
+            }
+            else {
+                this->_recoveryMs = this->recoveryFor(this->_episodeMs);
+                this->_dryAt = now;
+                this->_recovering = true;
+            }
+        }
+
+        /**
+         * @brief Filtered level (percent), NaN before the first sample.
+         */
+        float level() const { return this->_level; }
+
+        bool raining() const { return this->_raining; }
+
+        /**
+         * @brief `true` while it rains or the soil is drying out after the rain.
+         */
+        bool deferred(uint32_t now) const {
+            return this->_raining || this->recovering(now);
+        }
+
+        /**
+         * @brief Milliseconds until the dry-out window ends (0 when not deferred).
+         */
+        uint32_t deferRemaining(uint32_t now) const {
+            if (this->_raining) return this->recoveryFor(this->_episodeMs);
+            if (!this->recovering(now)) return 0;
+            return this->_recoveryMs - (now - this->_dryAt);
+        }
+
+        /**
+         * @brief Rain time of the last 24 hours (seconds).
+         */
+        uint32_t rainSeconds24h() const {
+            uint32_t total = this->_carryMs / 1000;
+            for (const auto &bin : this->_hourSec) total += bin;
+            return total;
+        }
+
+        /**
+         * @brief `true` when it rained at least `skipMin` minutes in the last 24 hours.
+         */
+        bool soaked() const {
+            return this->rainSeconds24h() >= this->config.skipMin * 60UL;
+        }
+
+    private:
+        bool recovering(uint32_t now) const {
+            return this->_recovering && now - this->_dryAt < this->_recoveryMs;
+        }
+
+        /**
+         * @brief Dry-out window after an episode of `rainMs` of rain.
+         */
+        uint32_t recoveryFor(uint32_t rainMs) const {
+            uint32_t minutes = this->config.dryOutMin + this->config.dryOutFactor * (rainMs / 60000UL);
+            return (minutes > this->config.dryOutMaxMin ? this->config.dryOutMaxMin : minutes) * 60000UL;
+        }
+
+        float median() const {
+            float sorted[RAIN_MEDIAN_N];
+            for (uint8_t i = 0; i < this->_count; i++) {
+                // Insertion sort, at most RAIN_MEDIAN_N values
+                float v = this->_window[i];
+                int8_t j = i - 1;
+                while (j >= 0 && sorted[j] > v) {
+                    sorted[j + 1] = sorted[j];
+                    j--;
+                }
+                sorted[j + 1] = v;
+            }
+            return sorted[this->_count / 2];
+        }
+
+        void addRain(uint32_t ms) {
+            this->_episodeMs += ms;
+            this->_carryMs += ms;
+            uint32_t seconds = this->_carryMs / 1000;
+            this->_carryMs %= 1000;
+            this->rainSeconds += seconds;
+            uint16_t &bin = this->_hourSec[this->_hour % 24];
+            bin = (bin + seconds > 3600) ? 3600 : bin + seconds;
+        }
+
+        /**
+         * @brief Clear the bins of the hours that passed since the last sample.
+         */
+        void roll(uint32_t now) {
+            uint32_t hour = now / 3600000UL;
+            for (uint8_t step = 0; this->_hour != hour && step < 24; step++) {
+                this->_hour++;
+                this->_hourSec[this->_hour % 24] = 0;
+            }
+            this->_hour = hour;
+        }
+};
@@ -28,15 +28,21 @@
 #include "DS3231rtc.hh"
 #include "MyEEPROM.hh"
 #include "LEDBoard.h"
+#include "CronSchedule.h"
 #include "variable.h"
 
 class WateringSys {
     public:
         bool WateringProcess = false;
         bool AutoWateringState = false;
+
+        ScheduleEngine schedules;               ///< Cron-style watering windows
+        bool schedulesChanged = false;          ///< Set after the schedules or the RTC were changed
         
         String NextWateringDate() const {
-            DateTime nextWatering = this->getNextWateringDate();
+            uint32_t next = this->getNextWateringDate();
+            if (next == 0) return "-";
+            DateTime nextWatering(next);
             return String(nextWatering.day()) + "/" + String(nextWatering.month()) + "/" + String(nextWatering.year());
         }
 
@@ -48,9 +54,12 @@ class WateringSys {
         
         void begin();
         void run();
+        void setAutoWatering(bool state);
         
     private:
-        DateTime getNextWateringDate() const;
+        uint32_t getNextWateringDate() const;
+        void runSchedules();
+        void runRainDeferral(uint32_t elapsed, uint8_t open);
         bool __WateringProcess__() const {
             int _countRelayOn = 0;
             // read relay state on or off
@@ -69,19 +78,27 @@ class WateringSys {
     private:
         bool hasStarted = false;
         bool hasCompleted = false;
-        bool hasRainCancelled = false;
 
         void resetFlags() {
             this->hasStarted = false;
             this->hasCompleted = false;
-            this->hasRainCancelled = false;
         }
 
     private:
         unsigned long __LastMillis1__ = 0, __LastResetFlags__ = 0;
         uint32_t lastWateringDay;
         bool _isWatering = false;
-        int Rainlvl;
+        bool _rainDeferred = false;         // raining, or drying out after the rain
+        uint32_t _owedMs = 0;               // window time lost to a rain deferral
+        uint8_t _owedZones = 0;             // relays the owed time belongs to
+        unsigned long _makeupUntil = 0;     // end (millis) of the make-up run
+        uint8_t _makeupZones = 0;           // relays inside the make-up run
+        uint8_t _activeZones = 0;           // relays opened by startWatering()
+        bool _scheduleSynced = false;       // next starts computed from the RTC
+        uint8_t _scheduleZones = 0;         // relays inside a running window
+        unsigned long _scheduleDue = 0;     // millis() of the next RTC read
+        unsigned long _due = 0;             // millis() of the next event run() has to handle
+        unsigned long _lastPass = 0;        // millis() of the last pass past the deadline check
         MyEEPROM __myEEPROM__;
 };
 
@@ -86,6 +86,7 @@ class WebServer : protected Info {
     private:
         void AutoWatering(AsyncWebServerRequest *req);
         void ManualWatering(AsyncWebServerRequest *req);
+        void Schedules(AsyncWebServerRequest *req);
         String StateChecked(bool x) {
             return (x ? "checked" : "");
         }
@@ -24,7 +24,11 @@
 #define FREEPIN6        D10
 */
 
-#define INTERVALDAYSDEFAULT 2
+// Default watering schedule (cron: minute hour day-of-month month day-of-week)
+#define SCHEDULE_EXPR_DEFAULT     "0 7 */2 * *" // 07:00 every second day
+#define SCHEDULE_DURATION_DEFAULT 180           // minutes (07:00 - 10:00)
+#define SCHEDULE_RESYNC_MS        3600000       // longest sleep between two RTC reads
+// Rain detection and dry-out window defaults (RAIN_ON_LEVEL, RAIN_DRYOUT_MIN, ...) are in RainFilter.h
 
 // PIN Output for Relay Module
 inline const uint16_t RELAY_PINS[2] = {
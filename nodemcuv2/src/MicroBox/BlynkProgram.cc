@@ -81,7 +81,7 @@ BLYNK_WRITE(V2) {
  * @details Updates the auto-watering configuration in the LittleFS file system.
  */
 BLYNK_WRITE(V1) {
-    lfsprog.changeConfigState(AUTOWATERING, param.asInt() == 1 ? true : false);
+    wateringsys.setAutoWatering(param.asInt() == 1 ? true : false);
 }
 
 /**
@@ -144,6 +144,47 @@ void LFSProgram::initializeOrUpdateState(const String &cfile, std::function<void
     this->writeconfig(cfile, __newconf__);
 }
 
+/**
+ * Initializes or updates the watering schedules in the specified configuration file.
+ * The default schedule (SCHEDULE_EXPR_DEFAULT) is written if the file is missing or corrupted.
+ * 
+ * @param cfile: Configuration file name containing the schedules.
+ * @param updateFunc: Lambda function to update configuration data in the file.
+ */
+void LFSProgram::initializeOrUpdateSchedules(const String &cfile, std::function<void (DynamicJsonDocument&)> updateFunc)
+{
+    DynamicJsonDocument doc(1536);
+    String __readconf__ = this->readconfig(cfile), __newconf__ = "";
+
+    if (__readconf__ == "null" || !lfsIsExists(cfile)) {
+        // Initialize with the default schedule (07:00 - 10:00, every second day, all relays)
+        ScheduleEngine engine;
+        WateringSchedule item;
+        strncpy(item.expr, SCHEDULE_EXPR_DEFAULT, sizeof(item.expr) - 1);
+        item.duration = SCHEDULE_DURATION_DEFAULT;
+        item.catchup = CATCHUP_LATE;
+        engine.add(item);
+        this->schedulesToJson(engine, doc.to<JsonObject>());
+    }
+    else {
+        DeserializationError error = deserializeJson(doc, __readconf__);
+        if (error) {
+            this->handleError_deserializeJson(
+                "initializeOrUpdateSchedules", // Function name for error tracking
+                error.c_str()   // Error message
+            );
+            return;
+        }
+    }
+
+    // Apply the changes using the provided lambda function
+    updateFunc(doc);
+
+    // Serialize updated data and write it back to the file
+    serializeJson(doc, __newconf__);
+    this->writeconfig(cfile, __newconf__);
+}
+
 /**
  * Initializes WiFi configuration with values from the configuration file.
  */
@@ -171,6 +212,18 @@ void LFSProgram::initializeVarRelay(void) {
     );
 }
 
+/**
+ * Initializes the watering schedule file.
+ */
+void LFSProgram::initializeSchedules(void) {
+    this->initializeOrUpdateSchedules(
+        this->file_config_schedule,
+        [&](DynamicJsonDocument &data) {
+            // Placeholder for schedule updates
+        }
+    );
+}
+
 /**
  * Initializes system state settings from the configuration file.
  */
@@ -261,6 +314,7 @@ void LFSProgram::setupLFS(void) {
     this->initializeWiFiConfig();
     this->initializeState();
     this->initializeVarRelay();
+    this->initializeSchedules();
     this->listFiles();
     
     Serial.println(F("\nConfiguration WiFi Client : "));
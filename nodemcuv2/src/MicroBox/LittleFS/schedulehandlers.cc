@@ -0,0 +1,74 @@
+/**
+ *  @file schedulehandlers.cc
+ *  @version 1.0.1
+ *  @author basyair7
+ *  @date 2025
+*/
+
+#include "MicroBox/LFSProgram.h"
+
+/*! schedulesToJson
+ * @param engine
+ * @param obj -> {"schedules": [{"expr": ..., "duration": ..., ...}]}
+*/
+void LFSProgram::schedulesToJson(const ScheduleEngine &engine, JsonObject obj)
+{
+    JsonArray list = obj.createNestedArray("schedules");
+    for (uint8_t i = 0; i < engine.count; i++) {
+        const WateringSchedule &item = engine.items[i];
+        JsonObject entry = list.createNestedObject();
+        entry["expr"]     = (const char*) item.expr;
+        entry["duration"] = item.duration;
+        entry["zones"]    = item.zones;
+        entry["catchup"]  = ScheduleEngine::catchupText(item.catchup);
+        entry["enabled"]  = item.enabled;
+        entry["last"]     = item.last;
+    }
+}
+
+/*! readSchedules
+ * @param engine
+*/
+void LFSProgram::readSchedules(ScheduleEngine &engine)
+{
+    DynamicJsonDocument data(1536);
+    engine.clear();
+
+    String __readconf__ = this->readconfig(this->file_config_schedule);
+    if (__readconf__ == "null") return;
+
+    DeserializationError error = deserializeJson(data, __readconf__);
+    if (error) {
+        this->handleError_deserializeJson("readSchedules", error.c_str());
+        return;
+    }
+
+    for (JsonObject entry : data["schedules"].as<JsonArray>()) {
+        WateringSchedule item;
+        strncpy(item.expr, entry["expr"] | "", sizeof(item.expr) - 1);
+        item.expr[sizeof(item.expr) - 1] = '\0';
+        item.duration = entry["duration"] | item.duration;
+        item.zones    = entry["zones"]    | item.zones;
+        item.catchup  = ScheduleEngine::catchupFromText(entry["catchup"] | "skip");
+        item.enabled  = entry["enabled"]  | item.enabled;
+        item.last     = entry["last"]     | item.last;
+
+        if (engine.add(item) < 0) {
+            Serial.print(F("Invalid schedule skipped : "));
+            Serial.println(item.expr);
+        }
+    }
+}
+
+/*! changeSchedules
+ * @param engine
+*/
+void LFSProgram::changeSchedules(const ScheduleEngine &engine)
+{
+    this->initializeOrUpdateSchedules(
+        this->file_config_schedule,
+        [&](DynamicJsonDocument &data) {
+            this->schedulesToJson(engine, data.to<JsonObject>());
+        }
+    );
+}
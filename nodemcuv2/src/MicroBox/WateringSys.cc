@@ -8,8 +8,8 @@
  * 
  * This module provides functionality to control an automatic watering system 
  * based on specific conditions such as time, rain levels, and user configurations.
- * It ensures the watering process occurs only during predefined time intervals 
- * and prevents unnecessary watering during rain or within restricted intervals.
+ * It ensures the watering process occurs only inside the configured cron-style
+ * schedule windows and defers the watering while it rains or the soil dries out.
  * 
  * @copyright
  * Copyright (C) 2024, basyair7
@@ -32,29 +32,45 @@
 #include "MicroBox/externprog.h"
 
 /**
- * @brief Calculates the next watering date based on the interval.
+ * @brief Earliest next start of the enabled schedules.
  * 
- * @return DateTime object representing the next watering date.
+ * @return Local epoch seconds of the next watering, 0 if none is planned.
  */
-DateTime WateringSys::getNextWateringDate() const {
-    // Convert lastWateringDay (UNIX timestamp) to DateTime
-    DateTime _lastWateringDate(this->lastWateringDay);
-
-    // Add the interval in days to _lastWateringDate
-    DateTime _nextWateringDate = _lastWateringDate + TimeSpan(INTERVALDAYSDEFAULT * 86400);
-
-    // Return the next watering date
-    return _nextWateringDate;
+uint32_t WateringSys::getNextWateringDate() const {
+    uint32_t next = 0;
+    for (uint8_t i = 0; i < this->schedules.count; i++) {
+        uint32_t n = this->schedules.items[i].enabled ? this->schedules.next(i) : 0;
+        if (n && (!next || n < next)) next = n;
+    }
+    return next;
 }
 
 /**
  * @brief Initializes the watering system.
  * 
- * Retrieves the last recorded watering day from EEPROM and ensures 
- * the system starts with no active watering process.
+ * Retrieves the last recorded watering day from EEPROM and loads the
+ * watering schedules.
  */
 void WateringSys::begin() {
     this->__myEEPROM__.get(ADDR_EEPROM_SAVE_STATE_WATERING, this->lastWateringDay);
+    lfsprog.readConfigState(AUTOWATERING, &this->AutoWateringState);
+    lfsprog.readSchedules(this->schedules);
+    Serial.printf("Watering schedules : %u\n", this->schedules.count);
+}
+
+/**
+ * @brief Enables or disables automatic watering.
+ * 
+ * Stores the state in LittleFS and keeps the cached copy that run() uses,
+ * so the configuration file is only read once at boot.
+ * 
+ * @param state New automatic watering state.
+ */
+void WateringSys::setAutoWatering(bool state) {
+    lfsprog.changeConfigState(AUTOWATERING, state);
+    this->AutoWateringState = state;
+    this->_due = millis();
+    this->_lastPass = millis();
 }
 
 /**
@@ -62,10 +78,14 @@ void WateringSys::begin() {
  * 
  * This method evaluates the conditions for starting or stopping watering:
  * - Checks if automatic watering is enabled.
- * - Monitors rain levels and cancels watering if rain is sufficient.
- * - Starts watering at 07:00 and stops at 10:00 if conditions are met.
- * - Prevents watering within two days of the last watering.
- * - Updates the last watering day in EEPROM when necessary.
+ * - Starts and stops the scheduled watering windows (default 07:00 - 10:00
+ *   every second day, see SCHEDULE_EXPR_DEFAULT).
+ * - Defers the window while it rains (filtered, see RainFilter.h) and during the
+ *   dry-out window after it; the lost time is made up afterwards unless it
+ *   already rained long enough.
+ * 
+ * Between two events (window start or stop, end of a make-up run, change of
+ * the rain deferral or of the configuration) a pass is a few comparisons.
  */
 void WateringSys::run() {
     if (millis() - this->__LastResetFlags__ >= 60000) {
@@ -79,54 +99,150 @@ void WateringSys::run() {
         
         this->WateringProcess = this->__WateringProcess__();
 
-        // Check if automatic watering is enabled
-        lfsprog.readConfigState(AUTOWATERING, &this->AutoWateringState);
+        // Check if automatic watering is enabled (cached, see setAutoWatering())
         if (!this->AutoWateringState) return;
 
-        // Save last watering regardless of mode
-        TimeSpan timeSinceLastWateringState;
-        int currentHour, currentMinute;
-        this->LastWatering(&timeSinceLastWateringState, &currentHour, &currentMinute);
+        // Nothing is due before the computed deadline unless the rain deferral changed
+        bool deferred = rainCheck.filter.deferred(millis());
+        if (!this->schedulesChanged && deferred == this->_rainDeferred && (long) (millis() - this->_due) < 0)
+            return;
+        uint32_t elapsed = millis() - this->_lastPass;
+        this->_lastPass = millis();
 
-        // Retrieve current rain level
-        this->Rainlvl = rainCheck.value;
-        
-        // Skip watering if the interval is too short (e.g., less that 2 days)
-        if (timeSinceLastWateringState.days() < INTERVALDAYSDEFAULT) return;
-
-        // Cancel watering if rain levels are sufficient
-        if (this->Rainlvl >= 50) {
-            if (!this->hasRainCancelled) {
-                Serial.println(F("Automatic watering was canceled due to rain."));
-                this->hasRainCancelled = true;
-            }
-            this->stopWatering();
+        // Windows that were open since the previous pass, for the owed time
+        uint8_t open = this->_scheduleZones;
+        this->runSchedules();
+        this->runRainDeferral(elapsed, open);
+
+        // Next deadline: the next RTC read of the schedules or the end of the make-up run
+        this->_due = this->_scheduleDue;
+        if (this->_makeupZones && (long) (this->_makeupUntil - this->_due) < 0)
+            this->_due = this->_makeupUntil;
+
+        // A new set of zones restarts the relays
+        uint8_t zones = this->_rainDeferred ? 0 : (this->_scheduleZones | this->_makeupZones);
+        if (zones != this->_activeZones && this->_isWatering) this->stopWatering();
+        this->_activeZones = zones;
+
+        // Window over, no window or deferred: close the relays
+        if (!zones) {
+            if (this->_isWatering) this->stopWatering();
             return;
         }
 
-        // Handle watering based on specific time intervals
-        if (currentHour == 7 && currentMinute == 0) {
-            if (this->_isWatering) return; // Watering already active
+        if (!this->_isWatering)
             this->startWatering();
+    }
+}
+
+/**
+ * @brief Start and stop the scheduled windows.
+ * 
+ * The RTC is only read when the next start or stop is due (or at least every
+ * SCHEDULE_RESYNC_MS); between two events this is a single millis() comparison.
+ */
+void WateringSys::runSchedules() {
+    if (this->schedulesChanged) {
+        this->schedulesChanged = false;
+        lfsprog.readSchedules(this->schedules);
+        this->_scheduleZones = 0;
+        this->_scheduleSynced = false;
+        this->_scheduleDue = millis();
+    }
+
+    if ((long) (millis() - this->_scheduleDue) < 0) return;
+
+    uint32_t now = rtcprog.now().unixtime();
+    if (!this->_scheduleSynced) {
+        this->schedules.begin(now);
+        this->_scheduleSynced = true;
+    }
+
+    this->schedules.poll(now,
+        [](uint8_t index, const WateringSchedule &item, uint32_t seconds) {
+            Serial.printf("Schedule %u (%s) started for %lu s.\n", index, item.expr, (unsigned long) seconds);
+        },
+        [](uint8_t index, const WateringSchedule &item) {
+            Serial.printf("Schedule %u (%s) completed.\n", index, item.expr);
+        }
+    );
+
+    if (this->schedules.dirty) {
+        this->schedules.dirty = false;
+        lfsprog.changeSchedules(this->schedules);
+    }
+
+    uint8_t zones = 0;
+    for (uint8_t i = 0; i < this->schedules.count; i++) {
+        if (this->schedules.running(i))
+            zones |= this->schedules.items[i].zones;
+    }
+    this->_scheduleZones = zones;
+
+    // Sleep until the next event
+    uint32_t wait = SCHEDULE_RESYNC_MS, next = this->schedules.nextEvent();
+    if (next && next - now < SCHEDULE_RESYNC_MS / 1000)
+        wait = (next > now) ? (next - now) * 1000UL : 0;
+    this->_scheduleDue = millis() + wait;
+}
+
+/**
+ * @brief Defer the windows while it rains or the soil dries out after the rain.
+ * 
+ * Window time that falls inside the deferral is owed; when the dry-out window
+ * ends it is run as a make-up, unless it rained at least RAIN_SKIP_MIN minutes
+ * in the last 24 hours.
+ * 
+ * @param elapsed Milliseconds since the previous call.
+ * @param open Relays of the windows that were running during `elapsed`.
+ */
+void WateringSys::runRainDeferral(uint32_t elapsed, uint8_t open) {
+    bool deferred = rainCheck.filter.deferred(millis());
+    if (deferred != this->_rainDeferred) {
+        this->_rainDeferred = deferred;
+        Serial.println(deferred
+            ? F("Rain detected, automatic watering deferred.")
+            : F("Rain dry-out window over, automatic watering resumed."));
+    }
+
+    if (deferred) {
+        if (open) {
+            this->_owedMs += elapsed;
+            this->_owedZones |= open;
         }
-        else if (currentHour == 10 && currentMinute == 0 && this->_isWatering) {
-            this->stopWatering();
-            return; // Exit after stopping watering
+        this->_makeupZones = 0;
+        return;
+    }
+
+    if (this->_owedMs) {
+        if (rainCheck.filter.soaked()) {
+            Serial.println(F("Deferred watering skipped, enough rain."));
+        }
+        else {
+            Serial.printf("Make-up watering for %lu s.\n", (unsigned long) (this->_owedMs / 1000));
+            this->_makeupUntil = millis() + this->_owedMs;
+            this->_makeupZones = this->_owedZones;
         }
+        this->_owedMs = 0;
+        this->_owedZones = 0;
     }
+
+    if (this->_makeupZones && (long) (millis() - this->_makeupUntil) >= 0)
+        this->_makeupZones = 0;
 }
 
 /**
  * @brief Starts the watering process.
  * 
- * Activates all relays connected to the watering system and sets the system 
+ * Activates the relays of the running (or make-up) windows and sets the system 
  * state to indicate active watering. Outputs a log message to confirm operation.
  */
 void WateringSys::startWatering() {
     this->_isWatering = true;
     this->LastWatering();
-    for (const auto &pins : RELAY_PINS) {
-        RelayController::write_without_save(pins, true, 1000); // Turn on relays
+    for (uint8_t i = 0; i < sizeof(RELAY_PINS) / sizeof(RELAY_PINS[0]); i++) {
+        if (this->_activeZones & (1 << i))
+            RelayController::write_without_save(RELAY_PINS[i], true, 1000); // Turn on relays
     }
     if (!this->hasStarted) {
         Serial.println(F("Automatic Watering is started."));
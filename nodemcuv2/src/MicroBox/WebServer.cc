@@ -157,6 +157,13 @@ void WebServer::ServerInit() {
         )
     );
 
+    // cron-style watering schedules
+    this->serverAsync.on("/schedules", HTTP_GET,
+        std::bind(
+            &WebServer::Schedules, this, std::placeholders::_1
+        )
+    );
+
     // update auto change state wifi mode
     this->serverAsync.on("/auto-change-wifi-mode", HTTP_GET,
         std::bind(
@@ -24,6 +24,7 @@ void WebServer::__getDataServer__(DynamicJsonDocument &doc) {
     data["dht"]["temp"] = dhtprog.temperature;
     data["dht"]["hum"]  = dhtprog.humidity;
     data["rainlvl"]     = rainCheck.value;
+    data["rain_deferred"] = rainCheck.filter.deferred(millis());
     data["WateringState"] = wateringsys.WateringProcess;
     data["ScheduleWatering"] = wateringsys.NextWateringDate();
     
@@ -33,7 +34,7 @@ void WebServer::__getDataServer__(DynamicJsonDocument &doc) {
 
 // webserver program
 void WebServer::DataWebServer(AsyncWebServerRequest *req) {
-    DynamicJsonDocument doc(500);
+    DynamicJsonDocument doc(640);
     String jsonBuffer = "";
     int codeRes = 200;
     
@@ -50,7 +51,7 @@ void WebServer::DataWebServer(AsyncWebServerRequest *req) {
 
 // websocket program
 void WebServer::handleDataServerWS(AsyncWebSocketClient *client) {
-    DynamicJsonDocument response(500);
+    DynamicJsonDocument response(640);
     response["event"] = "data_server";
     response["heap_memory"]["total_heap"] = String(__totalHeapMemory__, 2);
     response["heap_memory"]["free_heap"] = String(__freeHeapMemory__, 2);
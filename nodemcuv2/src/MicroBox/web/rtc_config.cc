@@ -69,6 +69,7 @@ void WebServer::Save_RTC_Config(AsyncWebServerRequest *req) {
             __MONTH__, __DAY__, __YEAR__,
             __HOUR__, __MINUTE__, __SECOND__
         );
+        wateringsys.schedulesChanged = true; // next starts follow the new clock
     }
 
     // get ip address
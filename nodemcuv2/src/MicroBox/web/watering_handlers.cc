@@ -16,7 +16,7 @@ void WebServer::AutoWatering(AsyncWebServerRequest *req) {
 
     if (req->hasParam("state")) {
         bool state = req->getParam("state")->value().toInt();
-        lfsprog.changeConfigState(AUTOWATERING, state);
+        wateringsys.setAutoWatering(state);
         message = "OK";
     }
     else {
@@ -35,9 +35,8 @@ void WebServer::ManualWatering(AsyncWebServerRequest *req) {
     StaticJsonDocument<200> jsonDoc;
     String resBuffer = "", message = "";
     int statusCode = 200;
-    bool _check_watering_state;
+    bool _check_watering_state = wateringsys.AutoWateringState;
 
-    lfsprog.readConfigState(AUTOWATERING, &_check_watering_state);
     if (req->hasParam("state")) {
         bool state = req->getParam("state")->value().toInt();
 
@@ -64,3 +63,80 @@ void WebServer::ManualWatering(AsyncWebServerRequest *req) {
 
     req->send_P(statusCode, APPJSON, resBuffer.c_str());
 }
+
+/*! Schedules
+ * GET /schedules lists the schedules with their next start (RTC time).
+ * expr, duration (minutes), zones (relay bitmask), catchup=skip|late|once adds one.
+ * id=N&remove=1 removes one, id=N&enabled=0|1 disables or enables one.
+ * A change restarts the schedules: a running window is closed.
+*/
+void WebServer::Schedules(AsyncWebServerRequest *req) {
+    DynamicJsonDocument doc(2048);
+    String resBuffer = "", message = "OK";
+    int statusCode = 200;
+
+    ScheduleEngine engine;
+    lfsprog.readSchedules(engine);
+    bool changed = false;
+
+    if (req->hasParam("expr")) {
+        WateringSchedule item;
+        strncpy(item.expr, req->getParam("expr")->value().c_str(), sizeof(item.expr) - 1);
+        if (req->hasParam("duration")) item.duration = req->getParam("duration")->value().toInt();
+        if (req->hasParam("zones")) item.zones = req->getParam("zones")->value().toInt();
+        if (req->hasParam("catchup"))
+            item.catchup = ScheduleEngine::catchupFromText(req->getParam("catchup")->value().c_str());
+
+        if (item.duration == 0 || !(item.zones & ((1 << (sizeof(RELAY_PINS) / sizeof(RELAY_PINS[0]))) - 1))) {
+            message = "Invalid schedule settings";
+            statusCode = 400;
+        }
+        else if (engine.add(item) < 0) {
+            message = engine.count >= SCHEDULE_MAX ? "Schedule list is full" : "Invalid expression";
+            statusCode = 400;
+        }
+        else {
+            changed = true;
+        }
+    }
+    else if (req->hasParam("id")) {
+        int index = req->getParam("id")->value().toInt();
+        if (index < 0 || index >= engine.count) {
+            message = "Invalid id";
+            statusCode = 400;
+        }
+        else if (req->hasParam("remove")) {
+            engine.remove(index);
+            changed = true;
+        }
+        else if (req->hasParam("enabled")) {
+            engine.items[index].enabled = req->getParam("enabled")->value().toInt();
+            changed = true;
+        }
+    }
+
+    if (statusCode == 200 && changed) {
+        lfsprog.changeSchedules(engine);
+        wateringsys.schedulesChanged = true;
+    }
+
+    lfsprog.schedulesToJson(engine, doc.to<JsonObject>());
+    uint32_t now = rtcprog.now().unixtime();
+    doc["time"] = now;
+
+    // Live state is only meaningful while the list matches the running one
+    JsonArray list = doc["schedules"];
+    bool live = !changed && engine.count == wateringsys.schedules.count;
+    for (uint8_t i = 0; i < engine.count; i++) {
+        uint32_t next = live ? wateringsys.schedules.next(i) : 0;
+        list[i]["next"]      = next;
+        list[i]["next_in_s"] = (next && next > now) ? next - now : 0;
+        list[i]["running"]   = live && wateringsys.schedules.running(i);
+    }
+
+    doc["status"] = statusCode;
+    doc["message"] = message;
+    serializeJson(doc, resBuffer);
+
+    req->send_P(statusCode, APPJSON, resBuffer.c_str());
+}